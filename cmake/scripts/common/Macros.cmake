@@ -111,6 +111,21 @@ function(core_add_test_library name)
   endforeach()
 endfunction()
 
+# Add a benchmark library, and add sources to list for the benchmark runner
+function(core_add_bench_library name)
+  if(ENABLE_STATIC_LIBS)
+    add_library(${name} STATIC ${SOURCES} ${HEADERS} ${OTHERS})
+    set_target_properties(${name} PROPERTIES PREFIX ""
+                                             EXCLUDE_FROM_ALL 1
+                                             FOLDER "Build Utilities/benchmarks")
+    add_dependencies(${name} ${GLOBAL_TARGET_DEPS})
+  endif()
+  foreach(src IN LISTS SOURCES HEADERS OTHERS)
+    get_filename_component(src_path "${src}" ABSOLUTE)
+    set(bench_sources "${src_path}" ${bench_sources} CACHE STRING "" FORCE)
+  endforeach()
+endfunction()
+
 # Add an dl-loaded shared library
 # Arguments:
 #   name name of the library to add
@@ -73,6 +73,8 @@ void CAppParamParser::DisplayHelp()
   printf("  --test\t\tEnable test mode. [FILE] required.\n");
   printf("  --settings=<filename>\t\tLoads specified file after advancedsettings.xml replacing any settings specified\n");
   printf("  \t\t\t\tspecified file must exist in special://xbmc/system/\n");
+  printf("  --guibench=<filename>\tRuns the windows listed in the script, writes how long they take\n");
+  printf("  \t\t\t\tto process and render per frame and quits\n");
 #if defined(TARGET_LINUX)
   printf("  --windowing=<system>\tSelect which windowing method to use.\n");
   printf("  \t\t\t\tAvailable window systems are:");
@@ -101,6 +103,8 @@ void CAppParamParser::ParseArg(const std::string &arg)
     m_testmode = true;
   else if (arg.substr(0, 11) == "--settings=")
     m_settingsFile = arg.substr(11);
+  else if (arg.substr(0, 11) == "--guibench=")
+    m_guiBenchmark = arg.substr(11);
 #if defined(TARGET_LINUX)
   else if (arg.substr(0, 12) == "--windowing=")
   {
@@ -26,6 +26,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "events/EventLog.h"
 #include "events/NotificationEvent.h"
+#include "guilib/GUIBenchmark.h"
 #include "guilib/GUIColorManager.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIControlProfiler.h"
@@ -42,7 +43,9 @@
 #include "threads/SystemClock.h"
 #include "utils/JobManager.h"
 #include "utils/LangCodeExpander.h"
+#include "utils/Metrics.h"
 #include "utils/Screenshot.h"
+#include "utils/TraceProfiler.h"
 #include "utils/Variant.h"
 #include "video/Bookmark.h"
 #include "video/VideoLibraryQueue.h"
@@ -970,6 +973,11 @@ void CApplication::StartServices()
   CLog::Log(LOGINFO, "start dvd mediatype detection");
   m_DetectDVDType.Create(false);
 #endif
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  CMetrics::GetInstance().StartDump(advancedSettings->m_metricsDumpFile, advancedSettings->m_metricsDumpInterval);
+  if (advancedSettings->m_traceEnabled)
+    CTraceProfiler::GetInstance().SetEnabled(true);
 }
 
 void CApplication::StopServices()
@@ -980,6 +988,8 @@ void CApplication::StopServices()
   CLog::Log(LOGINFO, "stop dvd detect media");
   m_DetectDVDType.StopThread();
 #endif
+
+  CMetrics::GetInstance().StopDump();
 }
 
 void CApplication::OnSettingChanged(const std::shared_ptr<const CSetting>& setting)
@@ -1541,6 +1551,8 @@ bool CApplication::LoadCustomWindows()
 
 void CApplication::Render()
 {
+  CTraceZone zone("Application::Render");
+
   // do not render if we are stopped or in background
   if (m_bStop)
     return;
@@ -2433,6 +2445,8 @@ void CApplication::UnlockFrameMoveGuard()
 
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
+  CTraceZone zone("Application::FrameMove");
+
   if (processEvents)
   {
     // currently we calculate the repeat time (ie time from last similar keypress) just global as fps
@@ -2510,6 +2524,9 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
       m_guiRefreshTimer.Set(500);
     }
 
+    if (CGUIBenchmark::IsRunning())
+      CGUIBenchmark::GetInstance().FrameMove();
+
     if (!m_bStop)
     {
       if (!m_skipGuiRender)
@@ -4256,6 +4273,8 @@ void CApplication::ConfigureAndEnableAddons()
 
 void CApplication::Process()
 {
+  CTraceZone zone("Application::Process");
+
   // dispatch the messages generated by python or other threads to the current window
   CServiceBroker::GetGUI()->GetWindowManager().DispatchThreadMessages();
 
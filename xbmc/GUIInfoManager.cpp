@@ -20,9 +20,13 @@
 #include "guilib/guiinfo/GUIInfoLabels.h"
 #include "input/WindowTranslator.h"
 #include "interfaces/AnnouncementManager.h"
+#include "addons/AddonManager.h"
 #include "interfaces/info/InfoExpression.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
 #include "settings/SkinSettings.h"
+#include "settings/lib/SettingsManager.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -10355,9 +10359,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_epochs));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_epochs));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -10669,6 +10673,9 @@ void CGUIInfoManager::Clear()
   CSingleLock lock(m_critInfo);
   m_skinVariableStrings.clear();
 
+  // the skin is about to change, the bools that stay have to be evaluated again
+  ++m_epochs.reset;
+
   /*
     Erase any info bools that are unused. We do this repeatedly as each run
     will remove those bools that are no longer dependencies of other bools
@@ -10933,7 +10940,52 @@ void CGUIInfoManager::ResetCache()
 {
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  ++m_epochs.frame;
+
+  // infobools which don't change every frame are only dirty if one of their sources changed
+  m_epochs.skin = CSkinSettings::GetInstance().GetChangeCounter();
+
+  CSettingsComponent* settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (settingsComponent && settingsComponent->GetSettings())
+    m_epochs.settings = settingsComponent->GetSettings()->GetSettingsManager()->GetChangeCounter();
+
+  if (CServiceBroker::IsServiceManagerUp())
+    m_epochs.addons = CServiceBroker::GetAddonMgr().GetChangeCounter();
+}
+
+unsigned int CGUIInfoManager::GetConditionDependencies(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+    info = std::abs(m_multiInfo[info - MULTI_INFO_START].m_info);
+
+  switch (info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_UWP:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_DARWIN_TVOS:
+    case SYSTEM_PLATFORM_ANDROID:
+      return INFO_DEPENDS_NONE;
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_STRING_IS_EQUAL:
+      return INFO_DEPENDS_SKIN;
+    case SKIN_HAS_THEME:
+    case SYSTEM_GET_BOOL:
+      return INFO_DEPENDS_SETTINGS;
+    case SYSTEM_HAS_ADDON:
+    case SYSTEM_ADDON_IS_ENABLED:
+      return INFO_DEPENDS_ADDONS;
+    default:
+      // player, system, PVR and list item infos change with time or focus
+      return INFO_DEPENDS_VOLATILE;
+  }
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
@@ -22,15 +22,31 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
+// queued database writes that trigger a flush, and the time between periodic flushes
+#define MAX_PENDING_WRITES 200
+#define FLUSH_INTERVAL_MS 2000
+
+// images kept in the in-memory index, and how long before they're looked up in the database again
+#define MAX_INDEXED_TEXTURES 20000
+#define INDEX_LIFETIME_MS (10 * 60 * 1000)
+// part of the index dropped at once when it's full, the least recently used textures
+#define INDEX_EVICT_FRACTION 8
+
+// sizes of the reduced variants of images, smallest first
+static const unsigned int ImageVariantSizes[] = {256, 512};
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CTextureCache::CTextureCache()
+  : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE), m_flushTimer([this]() { Flush(); })
 {
 }
 
@@ -41,13 +57,20 @@ void CTextureCache::Initialize()
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+  m_flushTimer.Start(FLUSH_INTERVAL_MS, true);
 }
 
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+  // the timer flushes under the database section, so stop it before taking that
+  m_flushTimer.Stop(true);
   CSingleLock lock(m_databaseSection);
+  FlushLocked();
   m_database.Close();
+
+  CExclusiveLock indexLock(m_indexSection);
+  m_index.clear();
 }
 
 bool CTextureCache::IsCachedImage(const std::string &url) const
@@ -126,6 +149,29 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
   AddJob(new CTextureCacheJob(path, details.hash));
 }
 
+std::string CTextureCache::GetImageVariant(const std::string &image, unsigned int width, unsigned int height) const
+{
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (!advancedSettings->m_imageVariants || width == 0 || height == 0)
+    return image;
+
+  // transformed images (and those with a type) already have their own size
+  const std::string url = CTextureUtils::UnwrapImageURL(image);
+  if (url.empty() || StringUtils::StartsWith(url, "image://") || IsCachedImage(url))
+    return image;
+
+  const unsigned int size = std::max(width, height);
+  for (unsigned int variant : ImageVariantSizes)
+  {
+    // no point in a variant that isn't smaller than the full cached image
+    if (variant >= advancedSettings->m_imageRes)
+      break;
+    if (size <= variant)
+      return CTextureUtils::GetWrappedImageURL(url, "", StringUtils::Format("width=%u&height=%u", variant, variant));
+  }
+  return image;
+}
+
 std::string CTextureCache::CacheImage(const std::string& image,
                                       CTexture** texture /* = NULL */,
                                       CTextureDetails* details /* = NULL */)
@@ -190,15 +236,24 @@ bool CTextureCache::CacheImage(const std::string &image, CTextureDetails &detail
 void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /*= false */)
 {
   //! @todo This can be removed when the texture cache covers everything.
-  std::string path = deleteSource ? url : "";
-  std::string cachedFile;
-  if (ClearCachedTexture(url, cachedFile))
-    path = GetCachedPath(cachedFile);
-  if (CFile::Exists(path))
-    CFile::Delete(path);
-  path = URIUtils::ReplaceExtension(path, ".dds");
-  if (CFile::Exists(path))
-    CFile::Delete(path);
+  std::vector<std::string> paths;
+  std::vector<std::string> cachedFiles;
+  if (ClearCachedTexture(url, cachedFiles))
+  {
+    for (const auto& cachedFile : cachedFiles)
+      paths.push_back(GetCachedPath(cachedFile));
+  }
+  else if (deleteSource)
+    paths.push_back(url);
+
+  for (std::string path : paths)
+  {
+    if (CFile::Exists(path))
+      CFile::Delete(path);
+    path = URIUtils::ReplaceExtension(path, ".dds");
+    if (CFile::Exists(path))
+      CFile::Delete(path);
+  }
 }
 
 bool CTextureCache::ClearCachedImage(int id)
@@ -219,47 +274,236 @@ bool CTextureCache::ClearCachedImage(int id)
 
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
+  // fast path for the GUI, no waiting for the database
+  if (GetIndexedTexture(url, details))
+    return true;
+
   CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  auto pending = m_pendingWrites.find(url);
+  if (pending != m_pendingWrites.end() && pending->second.add)
+  { // just cached, so no need to check it for updates (and no id to count its use by yet)
+    details = pending->second.details;
+    details.hash.clear();
+    return true;
+  }
+
+  if (!m_database.GetCachedTexture(url, details))
+    return false;
+
+  // just checked
+  if (pending != m_pendingWrites.end())
+    details.hash.clear();
+  IndexTexture(url, details);
+  return true;
+}
+
+bool CTextureCache::GetIndexedTexture(const std::string &url, CTextureDetails &details)
+{
+  CSharedLock lock(m_indexSection);
+  auto entry = m_index.find(url);
+  if (entry == m_index.end() || entry->second.expires.IsTimePast())
+    return false;
+
+  entry->second.lastUse.store(++m_indexUses, std::memory_order_relaxed);
+  details = entry->second.details;
+  return true;
+}
+
+void CTextureCache::IndexTexture(const std::string &url, const CTextureDetails &details)
+{
+  CExclusiveLock lock(m_indexSection);
+  if (m_index.size() >= MAX_INDEXED_TEXTURES && m_index.find(url) == m_index.end())
+  {
+    // drop a part at once, not to go through the whole index for every texture added
+    std::vector<uint64_t> uses;
+    uses.reserve(m_index.size());
+    for (const auto& entry : m_index)
+      uses.push_back(entry.second.lastUse.load(std::memory_order_relaxed));
+    const auto last = uses.begin() + uses.size() / INDEX_EVICT_FRACTION;
+    std::nth_element(uses.begin(), last, uses.end());
+
+    for (auto entry = m_index.begin(); entry != m_index.end();)
+    {
+      if (entry->second.lastUse.load(std::memory_order_relaxed) <= *last)
+        entry = m_index.erase(entry);
+      else
+        ++entry;
+    }
+  }
+
+  CIndexEntry& entry = m_index[url];
+  entry.details = details;
+  entry.expires.Set(INDEX_LIFETIME_MS);
+  entry.lastUse.store(++m_indexUses, std::memory_order_relaxed);
 }
 
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  CPendingWrite& write = m_pendingWrites[url];
+  write.add = true;
+  write.details = details;
+
+  CTextureDetails indexed(details);
+  indexed.hash.clear();
+  IndexTexture(url, indexed);
+
+  if (m_pendingWrites.size() >= MAX_PENDING_WRITES)
+    FlushLocked();
+  return true;
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
+  if (details.id < 0)
+    return; // not in the database yet, it starts with a use count of 1
+
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
-  {
-    AddJob(new CTextureUseCountJob(m_useCounts));
-    m_useCounts.clear();
-  }
+  m_useCounts[std::make_tuple(details.id, details.width, details.height)]++;
 }
 
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.SetCachedTextureValid(url, updateable);
+  {
+    CExclusiveLock indexLock(m_indexSection);
+    auto entry = m_index.find(url);
+    if (entry != m_index.end())
+    {
+      entry->second.details.hash.clear();
+      entry->second.details.updateable = updateable;
+    }
+  }
+
+  auto pending = m_pendingWrites.find(url);
+  if (pending != m_pendingWrites.end())
+  { // still to be added or validated, so just update that
+    pending->second.details.updateable = updateable;
+    return true;
+  }
+
+  CPendingWrite& write = m_pendingWrites[url];
+  write.add = false;
+  write.details.updateable = updateable;
+  if (m_pendingWrites.size() >= MAX_PENDING_WRITES)
+    FlushLocked();
+  return true;
 }
 
-bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
+bool CTextureCache::ClearCachedTexture(const std::string &url, std::vector<std::string> &cachedURLs)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  {
+    CExclusiveLock indexLock(m_indexSection);
+    m_index.erase(url);
+  }
+
+  auto pending = m_pendingWrites.find(url);
+  if (pending != m_pendingWrites.end())
+  {
+    if (pending->second.add)
+      cachedURLs.push_back(pending->second.details.file);
+    m_pendingWrites.erase(pending);
+  }
+
+  // an older version may still be in the database, possibly in another file
+  std::string cachedURL;
+  if (m_database.ClearCachedTexture(url, cachedURL) &&
+      std::find(cachedURLs.begin(), cachedURLs.end(), cachedURL) == cachedURLs.end())
+    cachedURLs.push_back(cachedURL);
+  return !cachedURLs.empty();
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  {
+    CExclusiveLock indexLock(m_indexSection);
+    for (auto entry = m_index.begin(); entry != m_index.end();)
+    {
+      if (entry->second.details.id == id)
+        entry = m_index.erase(entry);
+      else
+        ++entry;
+    }
+  }
   return m_database.ClearCachedTexture(id, cachedURL);
 }
 
+void CTextureCache::InvalidateCachedImages(const std::vector<std::string> &images)
+{
+  CSingleLock lock(m_databaseSection);
+  // queued adds and validations would undo the invalidation
+  FlushLocked();
+
+  // not initialized (yet), go to the database directly
+  CTextureDatabase localDatabase;
+  CTextureDatabase& database = m_database.IsOpen() ? m_database : localDatabase;
+  if (!database.IsOpen() && !database.Open())
+    return;
+
+  database.BeginMultipleExecute();
+  for (const auto& image : images)
+    database.InvalidateCachedTexture(image);
+  database.CommitMultipleExecute();
+
+  CExclusiveLock indexLock(m_indexSection);
+  for (const auto& image : images)
+    m_index.erase(image);
+}
+
+void CTextureCache::Flush()
+{
+  CSingleLock lock(m_databaseSection);
+  FlushLocked();
+}
+
+void CTextureCache::FlushLocked()
+{
+  std::map<std::tuple<int, unsigned int, unsigned int>, unsigned int> useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.swap(m_useCounts);
+  }
+  if (m_pendingWrites.empty() && useCounts.empty())
+    return;
+
+  if (!m_database.IsOpen())
+  {
+    CLog::Log(LOGERROR, "CTextureCache::%s - database closed, dropping %u updates", __FUNCTION__,
+              static_cast<unsigned int>(m_pendingWrites.size() + useCounts.size()));
+    m_pendingWrites.clear();
+    return;
+  }
+
+  m_database.BeginTransaction();
+  for (const auto& write : m_pendingWrites)
+  {
+    if (write.second.add)
+      m_database.AddCachedTexture(write.first, write.second.details);
+    else
+      m_database.SetCachedTextureValid(write.first, write.second.details.updateable);
+  }
+  for (const auto& useCount : useCounts)
+  {
+    CTextureDetails details;
+    std::tie(details.id, details.width, details.height) = useCount.first;
+    m_database.IncrementUseCount(details, useCount.second);
+  }
+  m_database.CommitTransaction();
+
+  // the index has no ids for new images, have those looked up again
+  {
+    CExclusiveLock lock(m_indexSection);
+    for (const auto& write : m_pendingWrites)
+    {
+      if (write.second.add)
+        m_index.erase(write.first);
+    }
+  }
+  m_pendingWrites.clear();
+}
+
 std::string CTextureCache::GetCacheFile(const std::string &url)
 {
   auto crc = Crc32::ComputeFromLowerCase(url);
@@ -10,14 +10,22 @@
 
 #include "TextureDatabase.h"
 #include "threads/Event.h"
+#include "threads/SharedSection.h"
+#include "threads/SystemClock.h"
+#include "threads/Timer.h"
 #include "utils/JobManager.h"
 
+#include <atomic>
+#include <map>
 #include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 class CURL;
 class CTexture;
+class TestTextureCache;
 
 /*!
  \ingroup textures
@@ -31,6 +39,8 @@ class CTexture;
  */
 class CTextureCache : public CJobQueue
 {
+  friend class TestTextureCache;
+
 public:
   /*!
    \brief The only way through which the global instance of the CTextureCache should be accessed.
@@ -69,6 +79,19 @@ public:
    */
   void BackgroundCacheImage(const std::string &image);
 
+  /*! \brief Get the URL of a reduced size variant of an image
+
+   Images shown in small controls don't need the full cached resolution. The variant is
+   the smallest size bucket that still covers the requested size, and is cached on demand
+   as an image:// URL with width and height options like any other transformed image.
+
+   \param image url of the image
+   \param width the width (in pixels) the image is displayed at
+   \param height the height (in pixels) the image is displayed at
+   \return the url of the variant, or image if the full size image should be used
+   */
+  std::string GetImageVariant(const std::string &image, unsigned int width, unsigned int height) const;
+
   /*! \brief Cache an image to image cache, optionally return the texture
 
    Caches the given image, returning the texture if the caller wants it.
@@ -111,6 +134,12 @@ public:
    */
   bool ClearCachedImage(int textureID);
 
+  /*! \brief Have the cached versions of the given images checked for updates on their next use
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param images urls of the images
+   */
+  void InvalidateCachedImages(const std::vector<std::string> &images);
+
   /*! \brief retrieve a cache file (relative to the cache path) to associate with the given image, excluding extension
    Use GetCachedPath(GetCacheFile(url)+extension) for the full path to the file.
    \param url location of the image
@@ -131,7 +160,8 @@ public:
   static bool CanCacheImageURL(const CURL &url);
 
   /*! \brief Add this image to the database
-   Thread-safe wrapper of CTextureDatabase::AddCachedTexture
+   Thread-safe wrapper of CTextureDatabase::AddCachedTexture. The write is queued and done in a
+   batch with others, lookups through the texture cache see it right away.
    \param image url of the original image
    \param details the texture details to add
    \return true if we successfully added to the database, false otherwise.
@@ -177,28 +207,49 @@ private:
   bool GetCachedTexture(const std::string &url, CTextureDetails &details);
 
   /*! \brief Clear an image from the database
-   Thread-safe wrapper of CTextureDatabase::ClearCachedTexture
+   Thread-safe wrapper of CTextureDatabase::ClearCachedTexture, also drops a queued add
    \param image url of the original image
-   \param cacheFile [out] url of the cached original (if available)
+   \param cacheFiles [out] urls of the cached originals, that of a queued add and that of the
+   version in the database may differ
    \return true if we had a cached version of this image, false otherwise.
    */
-  bool ClearCachedTexture(const std::string &url, std::string &cacheFile);
+  bool ClearCachedTexture(const std::string &url, std::vector<std::string> &cacheFiles);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
 
+  /*! \brief Look up an image in the in-memory index of the database
+   \param url url of the original image
+   \param details [out] texture details (if available)
+   \return true if the image is in the index, false otherwise.
+   */
+  bool GetIndexedTexture(const std::string &url, CTextureDetails &details);
+
+  /*! \brief Add or replace an image in the in-memory index, the database section must be held.
+   */
+  void IndexTexture(const std::string &url, const CTextureDetails &details);
+
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
-   \sa CUseCountJob, CTextureDatabase::IncrementUseCount
+   Counted locally and written to the database with the next flush.
+   \sa Flush, CTextureDatabase::IncrementUseCount
    */
   void IncrementUseCount(const CTextureDetails &details);
 
   /*! \brief Set a previously cached texture as valid in the database
-   Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid
+   Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid, queued like AddCachedTexture
    \param image url of the original image
    \param updateable whether this image should be checked for updates
    \return true if successful, false otherwise.
    */
   bool SetCachedTextureValid(const std::string &url, bool updateable);
 
+  /*! \brief Write the queued database updates in a single transaction.
+   Called periodically, whenever the queue is full and on deinitialization.
+   */
+  void Flush();
+
+  /*! \brief Write the queued database updates, the database section must be held.
+   */
+  void FlushLocked();
+
   void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
   void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job) override;
 
@@ -212,10 +263,33 @@ private:
 
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+
+  /*! \brief A texture database update that hasn't been written yet
+   */
+  struct CPendingWrite
+  {
+    bool add; ///< AddCachedTexture if true, else SetCachedTextureValid
+    CTextureDetails details;
+  };
+  std::map<std::string, CPendingWrite> m_pendingWrites; ///< by url, guarded by m_databaseSection
+  CTimer m_flushTimer;
+
+  /*! \brief An image known to be in the database
+   Entries expire so that images still get checked for updates once their time has come.
+   */
+  struct CIndexEntry
+  {
+    CTextureDetails details;
+    XbmcThreads::EndTime expires;
+    std::atomic<uint64_t> lastUse{0}; ///< m_indexUses when last used, set under the shared lock too
+  };
+  std::unordered_map<std::string, CIndexEntry> m_index; ///< by url, changed only while holding m_databaseSection too
+  CSharedSection m_indexSection;
+  std::atomic<uint64_t> m_indexUses{0};
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  std::map<std::tuple<int, unsigned int, unsigned int>, unsigned int> m_useCounts; ///< Use count tracking by texture id, width and height
   CCriticalSection             m_useCountSection;
 };
 
@@ -77,7 +77,19 @@ bool CTextureCacheJob::CacheTexture(CTexture** out_texture)
   else if (m_details.hash == m_oldHash)
     return true;
 
-  CTexture* texture = LoadImage(image, width, height, additional_info, true);
+  // reduced size variants are generated from the full size cached image when it's current,
+  // rather than fetching and decoding the original again
+  std::string source = image;
+  const unsigned int imageRes = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes;
+  if (width && height && width <= imageRes && height <= imageRes && additional_info.empty())
+  {
+    bool needsRecaching = false;
+    std::string cached = CTextureCache::GetInstance().CheckCachedImage(image, needsRecaching);
+    if (!cached.empty() && !needsRecaching)
+      source = cached;
+  }
+
+  CTexture* texture = LoadImage(source, width, height, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -239,31 +251,3 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
   CLog::Log(LOGDEBUG, "%s - unable to stat url %s", __FUNCTION__, CURL::GetRedacted(url).c_str());
   return "";
 }
-
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
-{
-}
-
-bool CTextureUseCountJob::operator==(const CJob* job) const
-{
-  if (strcmp(job->GetType(),GetType()) == 0)
-  {
-    const CTextureUseCountJob* useJob = dynamic_cast<const CTextureUseCountJob*>(job);
-    if (useJob && useJob->m_textures == m_textures)
-      return true;
-  }
-  return false;
-}
-
-bool CTextureUseCountJob::DoWork()
-{
-  CTextureDatabase db;
-  if (db.Open())
-  {
-    db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
-    db.CommitTransaction();
-  }
-  return true;
-}
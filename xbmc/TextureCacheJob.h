@@ -118,18 +118,3 @@ private:
 
   std::string    m_cachePath;
 };
-
-/* \brief Job class for storing the use count of textures
- */
-class CTextureUseCountJob : public CJob
-{
-public:
-  explicit CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
-
-  const char* GetType() const override { return "usecount"; };
-  bool operator==(const CJob *job) const override;
-  bool DoWork() override;
-
-private:
-  std::vector<CTextureDetails> m_textures;
-};
@@ -12,6 +12,7 @@
 #include "FileItem.h"
 #include "PlayListPlayer.h"
 #include "commons/Exception.h"
+#include "guilib/GUIBenchmark.h"
 #include "messaging/ApplicationMessenger.h"
 #include "threads/SystemClock.h"
 #include "utils/XTimeUtils.h"
@@ -52,6 +53,16 @@ int CXBApplicationEx::Run(const CAppParamParser &params)
     KODI::MESSAGING::CApplicationMessenger::GetInstance().PostMsg(TMSG_PLAYLISTPLAYER_PLAY, -1);
   }
 
+  if (!params.m_guiBenchmark.empty())
+  {
+    if (!m_renderGUI || !CGUIBenchmark::GetInstance().Start(params.m_guiBenchmark, true))
+    {
+      CLog::Log(LOGERROR, "XBApplicationEx: unable to run the gui benchmark %s",
+                params.m_guiBenchmark.c_str());
+      KODI::MESSAGING::CApplicationMessenger::GetInstance().PostMsg(TMSG_QUIT);
+    }
+  }
+
   // Run xbmc
   while (!m_bStop)
   {
@@ -619,6 +619,7 @@ bool CAddonMgr::FindAddon(const std::string& addonId,
             addonVersion.asString());
 
   m_installedAddons[addonId] = it->second; // insert/replace entry
+  m_changeCounter++;
   m_database.AddInstalledAddon(it->second, origin);
 
   // Reload caches
@@ -654,6 +655,7 @@ bool CAddonMgr::FindAddons()
   }
 
   m_installedAddons = std::move(installedAddons);
+  m_changeCounter++;
 
   // Reload caches
   std::map<std::string, AddonDisabledReason> tmpDisabled;
@@ -683,6 +685,7 @@ bool CAddonMgr::UnloadAddon(const std::string& addonId)
   }
 
   m_installedAddons.erase(addonId);
+  m_changeCounter++;
   CLog::Log(LOGDEBUG, "CAddonMgr::{}: {} unloaded", __func__, addonId);
 
   lock.Leave();
@@ -736,6 +739,7 @@ void CAddonMgr::OnPostUnInstall(const std::string& id)
 {
   CSingleLock lock(m_critSection);
   m_disabled.erase(id);
+  m_changeCounter++;
   RemoveAllUpdateRulesFromList(id);
   m_events.Publish(AddonEvents::UnInstalled(id));
 }
@@ -783,6 +787,7 @@ bool CAddonMgr::DisableAddon(const std::string& id, AddonDisabledReason disabled
     return false;
   if (!m_disabled.emplace(id, disabledReason).second)
     return false;
+  m_changeCounter++;
 
   //success
   CLog::Log(LOGDEBUG, "CAddonMgr: %s disabled", id.c_str());
@@ -834,6 +839,7 @@ bool CAddonMgr::EnableSingle(const std::string& id)
   if (!m_database.EnableAddon(id))
     return false;
   m_disabled.erase(id);
+  m_changeCounter++;
 
   // If enabling a repo add-on without an origin, set its origin to its own id
   if (addon->HasType(ADDON_REPOSITORY) && addon->Origin().empty())
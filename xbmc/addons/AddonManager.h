@@ -15,6 +15,7 @@
 #include "threads/CriticalSection.h"
 #include "utils/EventStream.h"
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -81,6 +82,10 @@ namespace ADDON
     CEventStream<AddonEvent>& Events() { return m_events; }
     CEventStream<AddonEvent>& UnloadEvents() { return m_unloadEvents; }
 
+    /*! \brief Get a counter which changes whenever add-ons are installed, removed, enabled or disabled.
+     */
+    unsigned int GetChangeCounter() const { return m_changeCounter; }
+
     IAddonMgrCallback* GetCallbackForType(TYPE type);
     bool RegisterAddonMgrCallback(TYPE type, IAddonMgrCallback* cb);
     void UnregisterAddonMgrCallback(TYPE type);
@@ -600,6 +605,7 @@ namespace ADDON
     std::set<std::string> m_systemAddons;
     std::set<std::string> m_optionalSystemAddons;
     ADDON_INFO_LIST m_installedAddons;
+    std::atomic<unsigned int> m_changeCounter{0};
 
     // Temporary path given to add-ons, whose content is deleted when Kodi is stopped
     const std::string m_tempAddonBasePath = "special://temp/addons";
@@ -10,7 +10,7 @@
 
 #include "FileItem.h"
 #include "ServiceBroker.h"
-#include "TextureDatabase.h"
+#include "TextureCache.h"
 #include "URL.h"
 #include "addons/AddonDatabase.h"
 #include "addons/AddonInstaller.h"
@@ -349,10 +349,7 @@ bool CRepositoryUpdateJob::DoWork()
 
   //Invalidate art.
   {
-    CTextureDatabase textureDB;
-    textureDB.Open();
-    textureDB.BeginMultipleExecute();
-
+    std::vector<std::string> images;
     for (const auto& addon : addons)
     {
       AddonPtr oldAddon;
@@ -362,16 +359,17 @@ bool CRepositoryUpdateJob::DoWork()
           CLog::Log(LOGDEBUG, "CRepository: invalidating cached art for '%s'", addon->ID().c_str());
 
         if (!oldAddon->Icon().empty())
-          textureDB.InvalidateCachedTexture(oldAddon->Icon());
+          images.push_back(oldAddon->Icon());
 
         for (const auto& path : oldAddon->Screenshots())
-          textureDB.InvalidateCachedTexture(path);
+          images.push_back(path);
 
         for (const auto& art : oldAddon->Art())
-          textureDB.InvalidateCachedTexture(art.second);
+          images.push_back(art.second);
       }
     }
-    textureDB.CommitMultipleExecute();
+    if (!images.empty())
+      CTextureCache::GetInstance().InvalidateCachedImages(images);
   }
 
   database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons);
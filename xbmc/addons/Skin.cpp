@@ -274,6 +274,9 @@ void CSkinInfo::LoadIncludes()
   CLog::Log(LOGINFO, "Loading skin includes from %s", includesPath.c_str());
   m_includes.Clear();
   m_includes.Load(includesPath);
+
+  // changes to the skin files are caught by the cache itself
+  m_windowCache.Configure(StringUtils::Format("%s %s %s", ID().c_str(), Version().asString().c_str(), Path().c_str()));
 }
 
 void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions /* = NULL */)
@@ -284,6 +287,29 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.Resolve(node, xmlIncludeConditions);
 }
 
+std::unique_ptr<TiXmlElement> CSkinInfo::GetCachedWindow(const std::string &path, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions)
+{
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::vector<std::string> files;
+  std::unique_ptr<TiXmlElement> node = m_windowCache.Load(path, conditions, files);
+  if (!node)
+    return nullptr;
+
+  // skin variables used by the window may be defined in include files not loaded yet
+  m_includes.Load(files);
+
+  if (xmlIncludeConditions)
+    *xmlIncludeConditions = std::move(conditions);
+  return node;
+}
+
+void CSkinInfo::CacheWindow(const std::string &path, const TiXmlElement *node, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions)
+{
+  if (node)
+    m_windowCache.Store(path, *node, xmlIncludeConditions, m_includes.GetFiles(),
+                        m_includes.GetFileConditions());
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CServiceBroker::GetSettingsComponent()->GetSettings()->GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
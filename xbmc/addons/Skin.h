@@ -10,6 +10,7 @@
 
 #include "addons/Addon.h"
 #include "guilib/GUIIncludes.h" // needed for the GUIInclude member
+#include "guilib/GUISkinCache.h"
 #include "windowing/GraphicContext.h" // needed for the RESOLUTION members
 
 #include <map>
@@ -152,6 +153,21 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Get a window with its includes resolved from the skin cache
+   \param path the xml file of the window
+   \param xmlIncludeConditions [out] the conditions of the includes in the window
+   \return the resolved <window> element, nullptr if the window has to be resolved
+   \sa CacheWindow
+   */
+  std::unique_ptr<TiXmlElement> GetCachedWindow(const std::string &path, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions);
+
+  /*! \brief Keep a window resolved by ResolveIncludes in the skin cache
+   \param path the xml file of the window
+   \param node the resolved <window> element
+   \param xmlIncludeConditions the conditions of the includes in the window
+   */
+  void CacheWindow(const std::string &path, const TiXmlElement *node, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions);
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -221,6 +237,7 @@ protected:
 
   float m_effectsSlowDown;
   CGUIIncludes m_includes;
+  CGUISkinCache m_windowCache;
   std::string m_currentAspect;
 
   std::vector<CStartupWindow> m_startupWindows;
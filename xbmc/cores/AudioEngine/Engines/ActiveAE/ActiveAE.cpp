@@ -24,6 +24,7 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
+#include "utils/TraceProfiler.h"
 #include "utils/log.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
@@ -1879,6 +1880,8 @@ void CActiveAE::UnconfigureSink()
 
 bool CActiveAE::RunStages()
 {
+  CTraceZone zone("ActiveAE::RunStages");
+
   bool busy = false;
 
   // serve input streams
@@ -2537,6 +2540,8 @@ CSampleBuffer* CActiveAE::SyncStream(CActiveAEStream *stream)
 
 void CActiveAE::MixSounds(CSoundPacket &dstSample)
 {
+  CTraceZone zone("ActiveAE::MixSounds");
+
   if (m_sounds_playing.empty())
     return;
 
@@ -9,6 +9,7 @@
 #include "DVDAudioCodecFFmpeg.h"
 #include "ServiceBroker.h"
 #include "../../DVDStreamInfo.h"
+#include "utils/TraceProfiler.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -135,6 +136,8 @@ void CDVDAudioCodecFFmpeg::Dispose()
 
 bool CDVDAudioCodecFFmpeg::AddData(const DemuxPacket &packet)
 {
+  CTraceZone zone("AudioCodecFFmpeg::AddData");
+
   if (!m_pCodecContext)
     return false;
 
@@ -20,6 +20,7 @@
 #include "settings/SettingsComponent.h"
 #include "utils/CPUInfo.h"
 #include "utils/StringUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
@@ -544,6 +545,8 @@ static int64_t pts_dtoi(double pts)
 
 bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
 {
+  CTraceZone zone("VideoCodecFFmpeg::AddData");
+
   if (!m_pCodecContext)
     return true;
 
@@ -603,6 +606,8 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
 
 CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPicture)
 {
+  CTraceZone zone("VideoCodecFFmpeg::GetPicture");
+
   if (!m_startedInput)
   {
     return VC_BUFFER;
@@ -103,7 +103,7 @@ DemuxPacket* CDVDDemuxCDDA::Read()
 
   if(pPacket->iSize < 1)
   {
-    delete pPacket;
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
     pPacket = NULL;
   }
   else
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxPacketPool.h"
+
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+#include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
+#include "utils/log.h"
+
+#include <inttypes.h>
+#include <new>
+
+// bytes in front of a payload holding its size class, keeps the payload aligned
+#define PAYLOAD_HEADER_SIZE 16
+// memory the free list of one size class may hold
+#define POOL_CLASS_BYTES (8 * 1024 * 1024)
+// memory all free lists may hold together
+#define POOL_TOTAL_BYTES (32 * 1024 * 1024)
+// packets kept for reuse
+#define POOL_PACKETS 1024
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Release();
+}
+
+int CDemuxPacketPool::GetClass(size_t size)
+{
+  int index = 0;
+  while ((static_cast<size_t>(1) << (index + MIN_CLASS)) < size)
+  {
+    if (++index == CLASSES)
+      return -1;
+  }
+  return index;
+}
+
+DemuxPacket* CDemuxPacketPool::AllocatePacket()
+{
+  m_packetAllocations++;
+  {
+    CSingleLock lock(m_packetLock);
+    if (!m_packets.empty())
+    {
+      DemuxPacket* packet = m_packets.back();
+      m_packets.pop_back();
+      lock.Leave();
+
+      m_packetHits++;
+      *packet = DemuxPacket();
+      return packet;
+    }
+  }
+  return new (std::nothrow) DemuxPacket();
+}
+
+void CDemuxPacketPool::FreePacket(DemuxPacket* packet)
+{
+  if (!packet)
+    return;
+
+  {
+    CSingleLock lock(m_packetLock);
+    if (m_packets.size() < POOL_PACKETS)
+    {
+      m_packets.push_back(packet);
+      return;
+    }
+  }
+  delete packet;
+}
+
+uint8_t* CDemuxPacketPool::AllocatePayload(size_t size)
+{
+  m_payloadAllocations++;
+
+  const int index = GetClass(size);
+  uint8_t* block = nullptr;
+  if (index >= 0)
+  {
+    CFreeList& list = m_payloads[index];
+    CSingleLock lock(list.lock);
+    if (!list.blocks.empty())
+    {
+      block = list.blocks.back();
+      list.blocks.pop_back();
+      m_cachedBytes -= static_cast<size_t>(1) << (index + MIN_CLASS);
+      m_payloadHits++;
+    }
+  }
+
+  if (!block)
+  {
+    // aligned_alloc wants a multiple of the alignment
+    const size_t blockSize = index >= 0 ? static_cast<size_t>(1) << (index + MIN_CLASS)
+                                         : (size + 15) & ~static_cast<size_t>(15);
+    block = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(blockSize + PAYLOAD_HEADER_SIZE, 16));
+    if (!block)
+      return nullptr;
+
+    *reinterpret_cast<int*>(block) = index;
+  }
+
+  return block + PAYLOAD_HEADER_SIZE;
+}
+
+void CDemuxPacketPool::FreePayload(uint8_t* data)
+{
+  if (!data)
+    return;
+
+  uint8_t* block = data - PAYLOAD_HEADER_SIZE;
+  const int index = *reinterpret_cast<int*>(block);
+  if (index >= 0)
+  {
+    const size_t blockSize = static_cast<size_t>(1) << (index + MIN_CLASS);
+    // reserve the bytes before taking the list, the lists of other classes are changed meanwhile
+    if (m_cachedBytes.fetch_add(blockSize) + blockSize <= POOL_TOTAL_BYTES)
+    {
+      CFreeList& list = m_payloads[index];
+      CSingleLock lock(list.lock);
+      if ((list.blocks.size() + 1) * blockSize <= POOL_CLASS_BYTES)
+      {
+        list.blocks.push_back(block);
+        return;
+      }
+    }
+    m_cachedBytes -= blockSize;
+  }
+
+  KODI::MEMORY::AlignedFree(block);
+}
+
+CDemuxPacketPool::Stats CDemuxPacketPool::GetStats() const
+{
+  Stats stats;
+  stats.packetAllocations = m_packetAllocations;
+  stats.packetHits = m_packetHits;
+  stats.payloadAllocations = m_payloadAllocations;
+  stats.payloadHits = m_payloadHits;
+  stats.cachedBytes = m_cachedBytes;
+  return stats;
+}
+
+void CDemuxPacketPool::Clear()
+{
+  const Stats stats = GetStats();
+  if (stats.packetAllocations)
+    CLog::Log(LOGDEBUG,
+              "CDemuxPacketPool::Clear - %" PRIu64 " of %" PRIu64 " packets and %" PRIu64
+              " of %" PRIu64 " payloads were recycled, releasing %zu bytes",
+              stats.packetHits, stats.packetAllocations, stats.payloadHits,
+              stats.payloadAllocations, stats.cachedBytes);
+
+  m_packetAllocations = 0;
+  m_packetHits = 0;
+  m_payloadAllocations = 0;
+  m_payloadHits = 0;
+
+  Release();
+}
+
+void CDemuxPacketPool::Release()
+{
+  {
+    CSingleLock lock(m_packetLock);
+    for (DemuxPacket* packet : m_packets)
+      delete packet;
+    m_packets.clear();
+  }
+
+  for (int index = 0; index < CLASSES; index++)
+  {
+    CFreeList& list = m_payloads[index];
+    CSingleLock lock(list.lock);
+    for (uint8_t* block : list.blocks)
+      KODI::MEMORY::AlignedFree(block);
+    m_cachedBytes -= list.blocks.size() * (static_cast<size_t>(1) << (index + MIN_CLASS));
+    list.blocks.clear();
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct DemuxPacket;
+
+/*!
+ \brief Recycles demux packets and their payloads.
+
+ Payloads are rounded up to size classes of powers of two. Freed packets and payloads are
+ kept in a free list per class and handed out again by the next allocation instead of
+ going back to the heap. The memory held by the free lists is bounded, both per class and
+ in total, also while threads free payloads of different classes at once; payloads larger
+ than the biggest class are allocated and freed directly.
+ */
+class CDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    uint64_t packetAllocations; ///< packets handed out
+    uint64_t packetHits;        ///< of which were recycled
+    uint64_t payloadAllocations;
+    uint64_t payloadHits;
+    size_t cachedBytes;         ///< memory held by the free lists, and reserved by frees under way
+  };
+
+  static CDemuxPacketPool& GetInstance();
+
+  /*!
+   \brief Get a packet in its default state.
+   \return the packet, nullptr if out of memory.
+   */
+  DemuxPacket* AllocatePacket();
+  void FreePacket(DemuxPacket* packet);
+
+  /*!
+   \brief Get a payload aligned to 16 bytes.
+   \param size size needed, including any padding.
+   \return the payload, nullptr if out of memory.
+   */
+  uint8_t* AllocatePayload(size_t size);
+  void FreePayload(uint8_t* data);
+
+  Stats GetStats() const;
+
+  /*!
+   \brief Release all packets and payloads held by the free lists, and start new stats.
+   */
+  void Clear();
+
+private:
+  CDemuxPacketPool() = default;
+  ~CDemuxPacketPool();
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  static const int MIN_CLASS = 10; ///< 1 KiB
+  static const int MAX_CLASS = 22; ///< 4 MiB
+  static const int CLASSES = MAX_CLASS - MIN_CLASS + 1;
+
+  struct CFreeList
+  {
+    CCriticalSection lock;
+    std::vector<uint8_t*> blocks;
+  };
+
+  static int GetClass(size_t size);
+  void Release();
+
+  CFreeList m_payloads[CLASSES];
+  CCriticalSection m_packetLock;
+  std::vector<DemuxPacket*> m_packets;
+  std::atomic<size_t> m_cachedBytes{0}; ///< reserved before a payload is added to a free list
+
+  std::atomic<uint64_t> m_packetAllocations{0};
+  std::atomic<uint64_t> m_packetHits{0};
+  std::atomic<uint64_t> m_payloadAllocations{0};
+  std::atomic<uint64_t> m_payloadHits{0};
+};
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const size_t KiB = 1024;
+const size_t MiB = 1024 * KiB;
+// the bounds of the free lists, per size class and in total
+const size_t CLASS_BYTES = 8 * MiB;
+const size_t TOTAL_BYTES = 32 * MiB;
+}
+
+class TestDemuxPacketPool : public testing::Test
+{
+protected:
+  TestDemuxPacketPool() { pool.Clear(); }
+  ~TestDemuxPacketPool() override { pool.Clear(); }
+
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+};
+
+TEST_F(TestDemuxPacketPool, PacketReuse)
+{
+  DemuxPacket* packet = pool.AllocatePacket();
+  ASSERT_NE(nullptr, packet);
+  packet->iSize = 100;
+  packet->iStreamId = 3;
+  packet->pts = 1000.0;
+  pool.FreePacket(packet);
+
+  // handed out again, as a new packet
+  DemuxPacket* reused = pool.AllocatePacket();
+  EXPECT_EQ(packet, reused);
+  EXPECT_EQ(0, reused->iSize);
+  EXPECT_EQ(-1, reused->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, reused->pts);
+  EXPECT_EQ(nullptr, reused->pData);
+
+  DemuxPacket* other = pool.AllocatePacket();
+  EXPECT_NE(reused, other);
+  pool.FreePacket(reused);
+  pool.FreePacket(other);
+  pool.FreePacket(nullptr);
+
+  const CDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(3u, stats.packetAllocations);
+  EXPECT_EQ(1u, stats.packetHits);
+}
+
+TEST_F(TestDemuxPacketPool, PayloadSizeClasses)
+{
+  uint8_t* payload = pool.AllocatePayload(1000);
+  ASSERT_NE(nullptr, payload);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(payload) % 16);
+  // all of the size class can be used
+  memset(payload, 0, 1 * KiB);
+  pool.FreePayload(payload);
+  EXPECT_EQ(1 * KiB, pool.GetStats().cachedBytes);
+
+  // a larger class doesn't take it
+  uint8_t* larger = pool.AllocatePayload(1 * KiB + 1);
+  EXPECT_NE(payload, larger);
+  EXPECT_EQ(0u, pool.GetStats().payloadHits);
+
+  // the same class does, for any size in it
+  uint8_t* same = pool.AllocatePayload(1 * KiB);
+  EXPECT_EQ(payload, same);
+  EXPECT_EQ(1u, pool.GetStats().payloadHits);
+  EXPECT_EQ(0u, pool.GetStats().cachedBytes);
+
+  pool.FreePayload(same);
+  pool.FreePayload(larger);
+  pool.FreePayload(nullptr);
+  EXPECT_EQ(3 * KiB, pool.GetStats().cachedBytes);
+
+  // larger than the biggest class, never kept
+  uint8_t* huge = pool.AllocatePayload(4 * MiB + 1);
+  ASSERT_NE(nullptr, huge);
+  memset(huge, 0, 4 * MiB + 1);
+  pool.FreePayload(huge);
+  EXPECT_EQ(3 * KiB, pool.GetStats().cachedBytes);
+  pool.FreePayload(pool.AllocatePayload(4 * MiB + 1));
+  EXPECT_EQ(1u, pool.GetStats().payloadHits);
+
+  pool.Clear();
+  const CDemuxPacketPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(0u, stats.cachedBytes);
+  EXPECT_EQ(0u, stats.payloadAllocations);
+  EXPECT_EQ(0u, stats.payloadHits);
+}
+
+TEST_F(TestDemuxPacketPool, Bounds)
+{
+  // a class holds two of the biggest payloads
+  std::vector<uint8_t*> payloads;
+  for (int i = 0; i < 3; i++)
+    payloads.push_back(pool.AllocatePayload(4 * MiB));
+  for (uint8_t* payload : payloads)
+    pool.FreePayload(payload);
+  EXPECT_EQ(CLASS_BYTES, pool.GetStats().cachedBytes);
+
+  // fill the other classes up to the total
+  payloads.clear();
+  for (size_t size = 2 * MiB; size >= 512 * KiB; size /= 2)
+  {
+    for (size_t bytes = 0; bytes < CLASS_BYTES; bytes += size)
+      payloads.push_back(pool.AllocatePayload(size));
+  }
+  payloads.push_back(pool.AllocatePayload(1 * KiB));
+  for (uint8_t* payload : payloads)
+    pool.FreePayload(payload);
+  EXPECT_EQ(TOTAL_BYTES, pool.GetStats().cachedBytes);
+
+  // taking one out makes room again
+  uint8_t* payload = pool.AllocatePayload(1 * MiB);
+  EXPECT_EQ(TOTAL_BYTES - 1 * MiB, pool.GetStats().cachedBytes);
+  pool.FreePayload(payload);
+  EXPECT_EQ(TOTAL_BYTES, pool.GetStats().cachedBytes);
+}
+
+TEST_F(TestDemuxPacketPool, BoundsConcurrent)
+{
+  // more than the total is freed at once, into different classes
+  const int THREADS = 8;
+  std::vector<std::vector<uint8_t*>> payloads(THREADS);
+  for (int i = 0; i < THREADS; i++)
+  {
+    for (size_t size = 256 * KiB; size <= 4 * MiB; size *= 2)
+      payloads[i].push_back(pool.AllocatePayload(size));
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < THREADS; i++)
+  {
+    threads.emplace_back([this, &payloads, i]() {
+      for (uint8_t* payload : payloads[i])
+        pool.FreePayload(payload);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  EXPECT_LE(pool.GetStats().cachedBytes, TOTAL_BYTES);
+
+  // what is counted is what the lists hold
+  std::vector<uint8_t*> taken;
+  size_t held = 0;
+  for (size_t size = 256 * KiB; size <= 4 * MiB; size *= 2)
+  {
+    while (pool.GetStats().cachedBytes > 0)
+    {
+      const uint64_t hits = pool.GetStats().payloadHits;
+      taken.push_back(pool.AllocatePayload(size));
+      if (pool.GetStats().payloadHits == hits)
+        break;
+      held += size;
+    }
+  }
+  EXPECT_EQ(0u, pool.GetStats().cachedBytes);
+  EXPECT_LE(held, TOTAL_BYTES);
+  for (uint8_t* payload : taken)
+    pool.FreePayload(payload);
+}
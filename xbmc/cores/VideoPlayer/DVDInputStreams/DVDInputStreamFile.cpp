@@ -68,6 +68,12 @@ bool CDVDInputStreamFile::Open()
     {
       flags |= READ_CACHED;
     }
+    // local files are read ahead of the demuxer, so a busy disk doesn't stall it
+    else if (!URIUtils::IsRemote(m_item.GetDynPath()) && !m_item.IsSubtitle() &&
+             CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLocalReadAhead > 0)
+    {
+      flags |= READ_CACHED | READ_PREFETCH;
+    }
   }
 
   if (!(flags & READ_CACHED))
@@ -11,10 +11,26 @@
 #include "cores/VideoPlayer/Interface/DemuxPacket.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "threads/SingleLock.h"
+#include "utils/Metrics.h"
 #include "utils/log.h"
 
 #include <math.h>
 
+#ifdef HAS_LOCKFREE_MSGQUEUE
+// number of messages without priority the queue holds, a power of two
+#define MSGQ_RING_SIZE 8192
+
+namespace
+{
+DemuxPacket* GetDemuxPacket(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return nullptr;
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+}
+}
+#endif
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -25,10 +41,26 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+#ifdef HAS_LOCKFREE_MSGQUEUE
+  m_ring.reset(new CSlot[MSGQ_RING_SIZE]);
+  for (size_t i = 0; i < MSGQ_RING_SIZE; i++)
+  {
+    m_ring[i].sequence = i;
+    m_ring[i].message = nullptr;
+  }
+#endif
+
+  const std::string name = "videoplayer.queue." + m_owner;
+  m_levelGauge = CMetrics::GetInstance().RegisterGauge(name + ".level", [this]() { return GetLevel(); });
+  m_sizeGauge = CMetrics::GetInstance().RegisterGauge(name + ".datasize", [this]() { return GetDataSize(); });
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
 {
+  CMetrics::GetInstance().UnregisterGauge(m_levelGauge);
+  CMetrics::GetInstance().UnregisterGauge(m_sizeGauge);
+
   // remove all remaining messages
   Flush(CDVDMsg::NONE);
 }
@@ -43,6 +75,7 @@ void CDVDMessageQueue::Init()
   m_drain = false;
 }
 
+#ifndef HAS_LOCKFREE_MSGQUEUE
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
@@ -62,6 +95,7 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
     m_TimeFront = DVD_NOPTS_VALUE;
   }
 }
+#endif
 
 void CDVDMessageQueue::Abort()
 {
@@ -94,6 +128,7 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
   return Put(pMsg, priority, false);
 }
 
+#ifndef HAS_LOCKFREE_MSGQUEUE
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
   CSingleLock lock(m_section);
@@ -236,7 +271,7 @@ void CDVDMessageQueue::UpdateTimeFront()
           m_TimeFront = packet->pts;
 
         if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
+          m_TimeBack = m_TimeFront.load();
       }
     }
   }
@@ -258,7 +293,7 @@ void CDVDMessageQueue::UpdateTimeBack()
           m_TimeBack = packet->pts;
 
         if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
+          m_TimeFront = m_TimeBack.load();
       }
     }
   }
@@ -285,6 +320,327 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 
   return count;
 }
+#else
+
+bool CDVDMessageQueue::PushRing(CDVDMsg* msg)
+{
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    CSlot& slot = m_ring[pos & (MSGQ_RING_SIZE - 1)];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0)
+    {
+      // the slot is free, claim it
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        slot.message = msg;
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (diff < 0)
+      return false; // full
+    else
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+  }
+}
+
+CDVDMsg* CDVDMessageQueue::PopRing()
+{
+  CSlot& slot = m_ring[m_dequeuePos & (MSGQ_RING_SIZE - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+    return nullptr;
+
+  CDVDMsg* msg = slot.message;
+  slot.message = nullptr;
+  slot.sequence.store(m_dequeuePos + MSGQ_RING_SIZE, std::memory_order_release);
+  m_dequeuePos++;
+  return msg;
+}
+
+CDVDMsg* CDVDMessageQueue::PeekRing(size_t index) const
+{
+  if (index >= MSGQ_RING_SIZE)
+    return nullptr;
+
+  const size_t pos = m_dequeuePos + index;
+  const CSlot& slot = m_ring[pos & (MSGQ_RING_SIZE - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+    return nullptr;
+
+  return slot.message;
+}
+
+void CDVDMessageQueue::Flush(CDVDMsg::Message type)
+{
+  CSingleLock lock(m_section);
+
+  auto matches = [type](CDVDMsg* msg){
+    return type == CDVDMsg::NONE || msg->IsType(type);
+  };
+
+  int removedSize = 0;
+  m_messages.remove_if([&](const DVDMessageListItem &item){
+    if (!matches(item.message))
+      return false;
+    DemuxPacket* packet = GetDemuxPacket(item.message);
+    if (packet)
+      removedSize += packet->iSize;
+    return true;
+  });
+
+  m_prioMessages.remove_if([&](const DVDMessageListItem &item){
+    return matches(item.message);
+  });
+
+  // messages that stay are older than anything put meanwhile, so they move to the list
+  while (CDVDMsg* msg = PopRing())
+  {
+    if (matches(msg))
+    {
+      DemuxPacket* packet = GetDemuxPacket(msg);
+      if (packet)
+        removedSize += packet->iSize;
+    }
+    else
+      m_messages.emplace_front(msg, 0);
+    msg->Release();
+  }
+  m_iDataSize -= removedSize;
+
+  if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
+  {
+    m_TimeBack = DVD_NOPTS_VALUE;
+    m_TimeFront = DVD_NOPTS_VALUE;
+    UpdateTimeBack();
+  }
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
+{
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    pMsg->Release();
+    return MSGQ_NOT_INITIALIZED;
+  }
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
+
+  // priority messages and messages handed back are rare, they go to the lists
+  if (priority > 0 || !front)
+  {
+    CSingleLock lock(m_section);
+
+    if (priority > 0)
+    {
+      int prio = priority;
+      if (!front)
+        prio++;
+
+      auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
+                             [prio](const DVDMessageListItem &item){
+                               return prio <= item.priority;
+                             });
+      m_prioMessages.emplace(it, pMsg, priority);
+    }
+    else
+    {
+      m_messages.emplace_back(pMsg, priority);
+
+      DemuxPacket* packet = GetDemuxPacket(pMsg);
+      if (packet)
+      {
+        m_iDataSize += packet->iSize;
+        UpdateTimeBack();
+      }
+    }
+
+    pMsg->Release();
+
+    // inform waiter for new packet
+    m_hEvent.Set();
+
+    return MSGQ_OK;
+  }
+
+  // the reader may release the message as soon as it's in the ring
+  int size = 0;
+  double time = DVD_NOPTS_VALUE;
+  DemuxPacket* packet = GetDemuxPacket(pMsg);
+  if (packet)
+  {
+    size = packet->iSize;
+    time = packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+  }
+
+  m_iDataSize += size;
+  if (!PushRing(pMsg))
+  {
+    m_iDataSize -= size;
+    CLog::Log(LOGERROR, "CDVDMessageQueue(%s)::Put MSGQ_OUT_OF_MEMORY, queue is full", m_owner.c_str());
+    pMsg->Release();
+    return MSGQ_OUT_OF_MEMORY;
+  }
+
+  if (time != DVD_NOPTS_VALUE)
+    SetTimeFront(time);
+
+  // inform waiter for new packet, the event is only touched if the reader waits
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_waiting)
+    m_hEvent.Set();
+
+  return MSGQ_OK;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  CSingleLock lock(m_section);
+
+  *pMsg = NULL;
+
+  int ret = 0;
+
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  while (!m_bAbortRequest)
+  {
+    if (priority > 0 || !m_prioMessages.empty())
+    {
+      if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
+      {
+        DVDMessageListItem& item(m_prioMessages.back());
+        priority = item.priority;
+        *pMsg = item.message->Acquire();
+        m_prioMessages.pop_back();
+        ret = MSGQ_OK;
+        break;
+      }
+    }
+    else
+    {
+      // messages handed back come before the ones in the ring
+      CDVDMsg* msg;
+      if (!m_messages.empty())
+      {
+        msg = m_messages.back().message->Acquire();
+        m_messages.pop_back();
+      }
+      else
+        msg = PopRing();
+
+      if (msg)
+      {
+        priority = 0;
+        DemuxPacket* packet = GetDemuxPacket(msg);
+        if (packet)
+          m_iDataSize -= packet->iSize;
+
+        *pMsg = msg;
+        UpdateTimeBack();
+        ret = MSGQ_OK;
+        break;
+      }
+    }
+
+    if (!iTimeoutInMilliSeconds)
+    {
+      ret = MSGQ_TIMEOUT;
+      break;
+    }
+
+    // announce the wait before looking at the ring again, a writer either sees that
+    // or its message is found here
+    m_hEvent.Reset();
+    m_waiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (priority == 0 && m_prioMessages.empty() && PeekRing(0))
+    {
+      m_waiting = false;
+      continue;
+    }
+    lock.Leave();
+
+    // wait for a new message
+    const bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+    m_waiting = false;
+    if (!signaled)
+      return MSGQ_TIMEOUT;
+
+    lock.Enter();
+  }
+
+  if (m_bAbortRequest)
+    return MSGQ_ABORT;
+
+  return (MsgQueueReturnCode)ret;
+}
+
+void CDVDMessageQueue::SetTimeFront(double time)
+{
+  m_TimeFront = time;
+
+  double none = DVD_NOPTS_VALUE;
+  m_TimeBack.compare_exchange_strong(none, time);
+}
+
+void CDVDMessageQueue::UpdateTimeBack()
+{
+  CDVDMsg* msg = !m_messages.empty() ? m_messages.back().message : PeekRing(0);
+  if (!msg)
+    return;
+
+  DemuxPacket* packet = GetDemuxPacket(msg);
+  if (packet)
+  {
+    if (packet->dts != DVD_NOPTS_VALUE)
+      m_TimeBack = packet->dts;
+    else if (packet->pts != DVD_NOPTS_VALUE)
+      m_TimeBack = packet->pts;
+
+    if (m_TimeFront == DVD_NOPTS_VALUE)
+      m_TimeFront = m_TimeBack.load();
+  }
+}
+
+unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
+{
+  CSingleLock lock(m_section);
+
+  if (!m_bInitialized)
+    return 0;
+
+  unsigned count = 0;
+  for (const auto &item : m_messages)
+  {
+    if(item.message->IsType(type))
+      count++;
+  }
+  for (const auto &item : m_prioMessages)
+  {
+    if(item.message->IsType(type))
+      count++;
+  }
+  CDVDMsg* msg;
+  for (size_t i = 0; (msg = PeekRing(i)); i++)
+  {
+    if(msg->IsType(type))
+      count++;
+  }
+
+  return count;
+}
+#endif
 
 void CDVDMessageQueue::WaitUntilEmpty()
 {
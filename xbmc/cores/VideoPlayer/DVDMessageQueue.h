@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <atomic>
 #include <list>
+#include <memory>
 #include <string>
 
 struct DVDMessageListItem
@@ -54,6 +55,14 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/*!
+ \brief Queue of messages from the demuxer to a player thread.
+
+ When built with HAS_LOCKFREE_MSGQUEUE, messages without priority put at the front are
+ stored in a bounded ring that producers fill without taking a lock or allocating memory.
+ Priority messages and messages handed back with PutBack() still go to the locked lists,
+ and are delivered ahead of the ring, so the order seen by Get() is the same either way.
+ */
 class CDVDMessageQueue
 {
 public:
@@ -100,23 +109,44 @@ public:
 private:
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
-  void UpdateTimeFront();
   void UpdateTimeBack();
 
+#ifdef HAS_LOCKFREE_MSGQUEUE
+  struct CSlot
+  {
+    std::atomic<size_t> sequence;
+    CDVDMsg* message;
+  };
+
+  bool PushRing(CDVDMsg* msg);
+  CDVDMsg* PopRing();
+  CDVDMsg* PeekRing(size_t index) const;
+  void SetTimeFront(double time);
+
+  std::unique_ptr<CSlot[]> m_ring;
+  alignas(64) std::atomic<size_t> m_enqueuePos{0};
+  alignas(64) size_t m_dequeuePos = 0; // only changed with m_section held
+  std::atomic<bool> m_waiting{false};
+#else
+  void UpdateTimeFront();
+#endif
+
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
+  int m_levelGauge; ///< ids of the gauges in CMetrics
+  int m_sizeGauge;
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
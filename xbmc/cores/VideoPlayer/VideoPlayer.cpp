@@ -22,6 +22,7 @@
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDDemuxers/DemuxPacketPool.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
 
 #include "DVDFileInfo.h"
@@ -54,6 +55,7 @@
 #include "utils/log.h"
 #include "utils/StreamDetails.h"
 #include "utils/StreamUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/Variant.h"
 #include "storage/MediaManager.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -996,6 +998,8 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
 bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  CTraceZone zone("VideoPlayer::ReadPacket");
+
 
   // check if we should read from subtitle demuxer
   if (m_pSubtitleDemuxer && m_VideoPlayerSubtitle->AcceptsData())
@@ -1577,6 +1581,8 @@ bool CVideoPlayer::CheckIsCurrent(CCurrentStream& current, CDemuxStream* stream,
 
 void CVideoPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  CTraceZone zone("VideoPlayer::ProcessPacket");
+
   // process packet if it belongs to selected stream.
   // for dvd's don't allow automatic opening of streams*/
 
@@ -2450,6 +2456,9 @@ void CVideoPlayer::OnExit()
   // clean up all selection streams
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
 
+  // give back the memory kept for the packets of this playback
+  CDemuxPacketPool::GetInstance().Clear();
+
   m_messenger.End();
 
   CFFmpegLog::ClearLogLevel();
@@ -2469,6 +2478,8 @@ void CVideoPlayer::OnExit()
 
 void CVideoPlayer::HandleMessages()
 {
+  CTraceZone zone("VideoPlayer::HandleMessages");
+
   CDVDMsg* pMsg;
 
   while (m_messenger.Get(&pMsg, 0) == MSGQ_OK)
@@ -18,6 +18,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/log.h"
 
 #include "system.h"
@@ -422,6 +423,8 @@ void CVideoPlayerAudio::Process()
 
 bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
 {
+  CTraceZone zone("VideoPlayerAudio::ProcessDecoderOutput");
+
   if (audioframe.nb_frames <= audioframe.framesOut)
   {
     audioframe.hasDownmix = false;
@@ -682,6 +682,7 @@ void CDatabase::Close()
   }
 
   m_openCount = 0;
+  m_inBatch = false;
   m_multipleExecute = false;
 
   if (nullptr == m_pDB)
@@ -739,6 +740,17 @@ void CDatabase::Interrupt()
 
 void CDatabase::BeginTransaction()
 {
+  if (m_inBatch)
+  {
+    // a savepoint, so that a rollback only rolls back this transaction. Without one a rollback
+    // discards the batch
+    const std::string savepoint = StringUtils::Format("batch%u", ++m_batchDepth);
+    if (nullptr == m_pDB || !m_pDB->start_savepoint(savepoint))
+      CLog::Log(LOGWARNING, "database:begintransaction unable to set savepoint %s",
+                savepoint.c_str());
+    return;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -752,6 +764,13 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_inBatch)
+  {
+    if (m_batchDepth > 0 && nullptr != m_pDB)
+      m_pDB->release_savepoint(StringUtils::Format("batch%u", m_batchDepth--));
+    return true;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -767,6 +786,19 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_inBatch)
+  {
+    // only roll back what was done since the matching BeginTransaction()
+    if (m_batchDepth > 0 && nullptr != m_pDB &&
+        m_pDB->rollback_savepoint(StringUtils::Format("batch%u", m_batchDepth--)))
+      return;
+
+    CLog::Log(LOGWARNING, "database:rollbacktransaction discards the current batch");
+    m_inBatch = false;
+    m_batchDepth = 0;
+    m_batchDiscarded = true;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -778,6 +810,34 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBatch()
+{
+  if (m_inBatch)
+    return;
+
+  BeginTransaction();
+  m_inBatch = true;
+  m_batchDepth = 0;
+  m_batchDiscarded = false;
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (!m_inBatch)
+  {
+    const bool discarded = m_batchDiscarded;
+    m_batchDiscarded = false;
+    return !discarded;
+  }
+
+  if (m_batchDepth > 0)
+    CLog::Log(LOGWARNING, "database:commitbatch %u transactions of the batch were not committed",
+              m_batchDepth);
+  m_inBatch = false;
+  m_batchDepth = 0;
+  return CommitTransaction();
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
@@ -105,6 +105,17 @@ public:
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
+
+  /*!
+   * @brief Group the following transactions into a single one.
+   * @remarks Speeds up bulk updates such as library scans. Transactions begun and committed
+   * while the batch is open join it as savepoints, so a rollback only rolls back its own
+   * transaction. Only when that fails the whole batch is rolled back and ended.
+   * @return CommitBatch() returns false if the batch, or part of it, was lost.
+   */
+  void BeginBatch();
+  bool CommitBatch();
+  bool InBatch() const { return m_inBatch; }
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -301,6 +312,9 @@ private:
   bool m_bMultiDelete =
       false; /*!< True if there are any queries in the delete queue, false otherwise */
   unsigned int m_openCount;
+  bool m_inBatch = false;
+  unsigned int m_batchDepth = 0; /*!< transactions open within the batch, one savepoint each */
+  bool m_batchDiscarded = false; /*!< a rollback discarded the batch before it was committed */
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
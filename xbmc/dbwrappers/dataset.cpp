@@ -15,7 +15,10 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -68,6 +71,194 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+std::string Database::bind(const std::string &sql, const BindParams &params)
+{
+  std::string result;
+  result.reserve(sql.size() + params.size() * 8);
+  size_t param = 0;
+  char quote = 0;
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    const char c = sql[i];
+    if (quote)
+    {
+      result += c;
+      // a backslash escapes the next character, as in the strings escaped by MySQL
+      if (c == '\\' && backslash_escapes() && i + 1 < sql.size())
+        result += sql[++i];
+      else if (c == quote)
+        quote = 0;
+      continue;
+    }
+    if (c == '\'' || c == '"')
+      quote = c;
+    if (c != '?' || quote)
+    {
+      result += c;
+      continue;
+    }
+    if (param >= params.size())
+      throw DbErrors("Missing value for parameter %u of query: %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+    const field_value &value = params[param++];
+    if (value.get_isNull())
+      result += "NULL";
+    else if (value.get_fType() == ft_String || value.get_fType() == ft_Char)
+      result += prepare("'%s'", value.get_asString().c_str());
+    else if (value.get_fType() == ft_Boolean)
+      result += value.get_asBool() ? "1" : "0";
+    else
+      result += value.get_asString();
+  }
+  if (param != params.size())
+    throw DbErrors("Expected %u parameters but got %u for query: %s", static_cast<unsigned int>(param),
+                   static_cast<unsigned int>(params.size()), sql.c_str());
+  return result;
+}
+
+namespace
+{
+bool IsWordChar(char c)
+{
+  return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// return the position following the quoted string or identifier starting at sql[pos],
+// std::string::npos if it isn't terminated
+size_t SkipQuoted(const std::string &sql, size_t pos, bool backslashEscapes)
+{
+  const char quote = sql[pos];
+  for (size_t i = pos + 1; i < sql.size(); i++)
+  {
+    if (sql[i] == '\\' && backslashEscapes && quote != '`')
+      i++;
+    else if (sql[i] == quote)
+    {
+      if (i + 1 < sql.size() && sql[i + 1] == quote)
+        i++;
+      else
+        return i + 1;
+    }
+  }
+  return std::string::npos;
+}
+}
+
+std::string Database::parameterize(const std::string &sql, BindParams &params) const
+{
+  params.clear();
+  std::string result;
+  result.reserve(sql.size());
+
+  bool value = false;      // the last token is followed by a value, e.g. '=' or LIKE
+  bool in = false;         // the last token is IN
+  bool limit = false;      // in a LIMIT clause
+  std::vector<bool> lists; // for each open parenthesis, whether it holds the values of an IN
+  size_t i = 0;
+  while (i < sql.size())
+  {
+    const char c = sql[i];
+    const char next = i + 1 < sql.size() ? sql[i + 1] : 0;
+    if (isspace(static_cast<unsigned char>(c)))
+    {
+      result += c;
+      i++;
+      continue;
+    }
+
+    size_t end = i + 1;
+    bool nextValue = false;
+    if (c == '\'')
+    {
+      end = SkipQuoted(sql, i, backslash_escapes());
+      std::string text = end != std::string::npos ? sql.substr(i + 1, end - i - 2) : "";
+      // strings of backends escaping with backslashes are left alone when they hold any
+      if (value && end != std::string::npos &&
+          (!backslash_escapes() || text.find('\\') == std::string::npos))
+      {
+        for (size_t quote = text.find("''"); quote != std::string::npos; quote = text.find("''", quote + 1))
+          text.erase(quote, 1);
+        params.emplace_back(text);
+        result += '?';
+        value = false;
+        i = end;
+        continue;
+      }
+    }
+    else if (c == '"' || c == '`')
+      end = SkipQuoted(sql, i, backslash_escapes());
+    else if (c == '-' && next == '-')
+      end = std::min(sql.find('\n', i), sql.size());
+    else if (c == '/' && next == '*')
+      end = std::min(sql.find("*/", i + 2), sql.size() - 2) + 2;
+    else if (isdigit(static_cast<unsigned char>(c)) ||
+             (value && (c == '-' || c == '+') && isdigit(static_cast<unsigned char>(next))))
+    {
+      while (end < sql.size() && (IsWordChar(sql[end]) || sql[end] == '.'))
+        end++;
+      // decimals, exponents, hex numbers and the like are left alone, as are integers that may not fit
+      const std::string number = sql.substr(i, end - i);
+      if (value && number.find_first_not_of("0123456789", 1) == std::string::npos && number.size() <= 18)
+      {
+        params.emplace_back(static_cast<int64_t>(strtoll(number.c_str(), nullptr, 10)));
+        result += '?';
+        value = false;
+        i = end;
+        continue;
+      }
+    }
+    else if (IsWordChar(c))
+    {
+      while (end < sql.size() && IsWordChar(sql[end]))
+        end++;
+      std::string word = sql.substr(i, end - i);
+      std::transform(word.begin(), word.end(), word.begin(), ::toupper);
+      limit = word == "LIMIT" || (limit && word == "OFFSET");
+      if (word == "SELECT" && !lists.empty())
+        lists.back() = false;
+      nextValue = word == "LIKE" || limit;
+      in = word == "IN";
+      result.append(sql, i, end - i);
+      value = nextValue;
+      i = end;
+      continue;
+    }
+    else if (c == '?')
+    {
+      // the statement has placeholders of its own, it's bound by the caller
+      params.clear();
+      return sql;
+    }
+    else if (c == '=' || c == '<' || c == '>' || c == '!')
+    {
+      while (end < sql.size() && strchr("=<>!", sql[end]))
+        end++;
+      nextValue = true;
+    }
+    else if (c == '(')
+    {
+      lists.push_back(in);
+      nextValue = in;
+    }
+    else if (c == ')')
+    {
+      if (!lists.empty())
+        lists.pop_back();
+      limit = false;
+    }
+    else if (c == ',')
+      nextValue = limit || (!lists.empty() && lists.back());
+
+    if (end == std::string::npos)
+      end = sql.size();
+    result.append(sql, i, end - i);
+    value = nextValue;
+    in = false;
+    i = end;
+  }
+  return result;
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -188,6 +379,28 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+bool Dataset::query(const std::string &sql, const BindParams &params, rsLayout layout)
+{
+  if (!query(sql, params))
+    return false;
+
+  if (layout == rsColumns && !result.records.empty())
+  { // no native support in the backend, convert the fetched rows
+    column_data &columns = result.columns;
+    columns.set_num_columns(result.record_header.size());
+    columns.reserve(result.records.size());
+    for (unsigned int i = 0; i < result.records.size(); i++)
+    {
+      const sql_record *row = result.records[i];
+      for (unsigned int j = 0; j < columns.num_columns(); j++)
+        columns.add_value(j, row->at(j));
+      delete row;
+    }
+    result.records.clear();
+  }
+  return true;
+}
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
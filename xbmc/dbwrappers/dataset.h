@@ -132,6 +132,13 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* virtual methods for savepoints, transactions nested in a transaction.
+   They return false if the backend has no savepoints or the statement failed */
+  virtual bool start_savepoint(const std::string &name) { return false; }
+  virtual bool release_savepoint(const std::string &name) { return false; }
+/* rolls back to and releases the savepoint */
+  virtual bool rollback_savepoint(const std::string &name) { return false; }
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -150,6 +157,38 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* methods for prepared statements */
+
+  /*! \brief Substitute the '?' placeholders of a statement with the escaped values of params.
+   Used as fallback by backends that have no native support for bound parameters.
+   \param sql - SQL statement with '?' placeholders (those inside quoted strings are left alone,
+   as are backslash escapes in the strings of backends using them)
+   \param params - values to substitute, in order of the placeholders.
+   \return the statement with all values substituted.
+   Throws DbErrors if the number of params doesn't match that of the placeholders.
+   */
+  std::string bind(const std::string &sql, const BindParams &params);
+
+  /*! \brief Turn the literal values compared against in a statement into '?' placeholders.
+   Strings and integers following a comparison, LIKE or IN ( and the numbers of a LIMIT clause
+   are moved to params, so statements built with different values share the same sql.
+   Statements holding placeholders of their own are returned as they are.
+   \param sql - SQL statement with literal values, as built by prepare()
+   \param params - receives the values of the placeholders, in order.
+   \return the statement with the values replaced by placeholders.
+   */
+  std::string parameterize(const std::string &sql, BindParams &params) const;
+
+  /*! \brief Whether a backslash escapes the next character in the quoted strings of the backend.
+   */
+  virtual bool backslash_escapes() const { return false; }
+
+  /*! \brief Set the maximum number of compiled statements kept per connection.
+   Backends without a statement cache ignore this.
+   \param size - number of statements to keep, 0 disables caching.
+   */
+  virtual void setStatementCacheSize(size_t size) {}
+
 };
 
 
@@ -164,6 +203,8 @@ public:
 // define Dataset States type
 enum dsStates { dsSelect, dsInsert, dsEdit, dsUpdate, dsDelete, dsInactive };
 enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
+// layout of a query result: a sql_record per row, or the columns of a column_data
+enum rsLayout { rsRows, rsColumns };
 
 
 typedef std::list<std::string> StringList;
@@ -293,6 +334,18 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but with params bound to the '?' placeholders of sql. Backends supporting it
+   keep the compiled statement and reuse it for subsequent calls with the same sql, a
+   statement without params is run as is */
+  virtual bool query(const std::string &sql, const BindParams &params) { return query(params.empty() ? sql : db->bind(sql, params)); }
+/* as exec, but with params bound to the '?' placeholders of sql */
+  virtual int  exec(const std::string &sql, const BindParams &params) { return exec(params.empty() ? sql : db->bind(sql, params)); }
+/* as query(sql, params), but store the result in the given layout. With rsColumns rows are
+   read from get_result_set().columns, which is much cheaper for large results */
+  virtual bool query(const std::string &sql, const BindParams &params, rsLayout layout);
+/* as query(sql), but backends keeping compiled statements bind the literal values of sql
+   (see Database::parameterize()), so queries differing in their values only share a statement */
+  virtual bool query_bound(const std::string &sql, rsLayout layout = rsRows) { return query(sql, BindParams(), layout); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -566,6 +566,27 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+bool MysqlDatabase::start_savepoint(const std::string &name)
+{
+  // no reconnect, the transaction would be gone with the connection
+  const std::string sql = "SAVEPOINT " + name;
+  return active && mysql_real_query(conn, sql.c_str(), sql.size()) == MYSQL_OK;
+}
+
+bool MysqlDatabase::release_savepoint(const std::string &name)
+{
+  const std::string sql = "RELEASE SAVEPOINT " + name;
+  return active && mysql_real_query(conn, sql.c_str(), sql.size()) == MYSQL_OK;
+}
+
+bool MysqlDatabase::rollback_savepoint(const std::string &name)
+{
+  const std::string rollback = "ROLLBACK TO SAVEPOINT " + name;
+  const std::string release = "RELEASE SAVEPOINT " + name;
+  return active && mysql_real_query(conn, rollback.c_str(), rollback.size()) == MYSQL_OK &&
+         mysql_real_query(conn, release.c_str(), release.size()) == MYSQL_OK;
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -1486,7 +1507,7 @@ void MysqlDataset::make_deletion() {
 }
 
 void MysqlDataset::fill_fields() {
-  if ((db == NULL) || (result.record_header.empty()) || (result.records.size() < (unsigned int)frecno)) return;
+  if ((db == NULL) || (result.record_header.empty()) || (result.size() < (unsigned int)frecno)) return;
 
   if (fields_object->size() == 0) // Filling columns name
   {
@@ -1509,6 +1530,14 @@ void MysqlDataset::fill_fields() {
       return;
     }
   }
+  else if ((unsigned int)frecno < result.columns.num_rows())
+  {
+    const unsigned int ncols = result.columns.num_columns();
+    fields_object->resize(ncols);
+    for (unsigned int i = 0; i < ncols; i++)
+      (*fields_object)[i].val = result.columns.row(frecno).at(i).get_asFieldValue();
+    return;
+  }
   const unsigned int ncols = result.record_header.size();
   fields_object->resize(ncols);
   for (unsigned int i = 0; i < ncols; i++)
@@ -1738,7 +1767,7 @@ void MysqlDataset::cancel() {
 }
 
 int MysqlDataset::num_rows() {
-  return result.records.size();
+  return result.size();
 }
 
 bool MysqlDataset::eof() {
@@ -71,8 +71,13 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  bool start_savepoint(const std::string &name) override;
+  bool release_savepoint(const std::string &name) override;
+  bool rollback_savepoint(const std::string &name) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
+  bool backslash_escapes() const override { return true; }
 
   bool in_transaction() override {return _in_transaction;};
   int query_with_reconnect(const char* query);
@@ -138,9 +143,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  using Dataset::exec;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  using Dataset::query;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -20,6 +20,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -42,6 +43,13 @@ field_value::field_value(const char *s):
   is_null = false;
 }
 
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  is_null = false;
+}
+
 field_value::field_value(const bool b) {
   bool_value = b;
   field_type = ft_Boolean;
@@ -725,4 +733,213 @@ std::string field_value::gft() {
   return tmp;
   }
 
+//column_value: same conversions as field_value, applied to the storage classes of column_data
+column_value::column_value(const column_data &data, unsigned int column, unsigned int row)
+{
+  const column_data::column &col = data.columns.at(column);
+  kind = col.kinds.at(row);
+  is_null = (kind == column_data::ckNull);
+  switch (kind)
+  {
+  case column_data::ckInt64:
+    int64_value = col.values[row];
+    break;
+  case column_data::ckDouble:
+    memcpy(&double_value, &col.values[row], sizeof(double_value));
+    break;
+  case column_data::ckString:
+    str_value = data.arena.c_str() + col.values[row];
+    break;
+  default:
+    str_value = "";
+    break;
+  }
+}
+
+fType column_value::get_fType() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return ft_Int64;
+  case column_data::ckDouble:
+    return ft_Double;
+  default:
+    return ft_String;
+  }
+}
+
+std::string column_value::get_asString() const {
+  switch (kind) {
+  case column_data::ckInt64: {
+    char t[23];
+    sprintf(t,"%" PRId64,int64_value);
+    return t;
+  }
+  case column_data::ckDouble: {
+    char t[32];
+    sprintf(t,"%f",double_value);
+    return t;
+  }
+  default:
+    return str_value;
+  }
+}
+
+bool column_value::get_asBool() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return (bool)int64_value;
+  case column_data::ckDouble:
+    return (bool)double_value;
+  default:
+    return strcmp(str_value, "True") == 0 || strcmp(str_value, "true") == 0 || strcmp(str_value, "1") == 0;
+  }
+}
+
+int column_value::get_asInt() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return (int)int64_value;
+  case column_data::ckDouble:
+    return (int)double_value;
+  default:
+    return atoi(str_value);
+  }
+}
+
+unsigned int column_value::get_asUInt() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return (unsigned int)int64_value;
+  case column_data::ckDouble:
+    return (unsigned int)double_value;
+  default:
+    return (unsigned int)atoi(str_value);
+  }
+}
+
+float column_value::get_asFloat() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return (float)int64_value;
+  case column_data::ckDouble:
+    return (float)double_value;
+  default:
+    return (float)atof(str_value);
+  }
+}
+
+double column_value::get_asDouble() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return (double)int64_value;
+  case column_data::ckDouble:
+    return double_value;
+  default:
+    return atof(str_value);
+  }
+}
+
+int64_t column_value::get_asInt64() const {
+  switch (kind) {
+  case column_data::ckInt64:
+    return int64_value;
+  case column_data::ckDouble:
+    return (int64_t)double_value;
+  default:
+    return std::atoll(str_value);
+  }
+}
+
+field_value column_value::get_asFieldValue() const {
+  field_value fv;
+  switch (kind) {
+  case column_data::ckInt64:
+    fv.set_asInt64(int64_value);
+    break;
+  case column_data::ckDouble:
+    fv.set_asDouble(double_value);
+    break;
+  default:
+    fv.set_asString(str_value);
+    break;
+  }
+  if (is_null)
+    fv.set_isNull();
+  return fv;
+}
+
+
+//column_data
+void column_data::clear() {
+  columns.clear();
+  arena.clear();
+}
+
+void column_data::set_num_columns(unsigned int count) {
+  clear();
+  columns.resize(count);
+}
+
+void column_data::reserve(unsigned int rows) {
+  for (auto &col : columns)
+  {
+    col.values.reserve(rows);
+    col.kinds.reserve(rows);
+  }
+}
+
+void column_data::add_null(unsigned int column) {
+  column_data::column &col = columns.at(column);
+  col.values.push_back(0);
+  col.kinds.push_back(ckNull);
+}
+
+void column_data::add_int64(unsigned int column, int64_t value) {
+  column_data::column &col = columns.at(column);
+  col.values.push_back(value);
+  col.kinds.push_back(ckInt64);
+}
+
+void column_data::add_double(unsigned int column, double value) {
+  column_data::column &col = columns.at(column);
+  int64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  col.values.push_back(bits);
+  col.kinds.push_back(ckDouble);
+}
+
+void column_data::add_string(unsigned int column, const char *value) {
+  column_data::column &col = columns.at(column);
+  col.values.push_back(arena.size());
+  col.kinds.push_back(ckString);
+  arena.append(value ? value : "");
+  arena.push_back('\0');
+}
+
+void column_data::add_value(unsigned int column, const field_value &value) {
+  if (value.get_isNull())
+  {
+    add_null(column);
+    return;
+  }
+  switch (value.get_fType()) {
+  case ft_Boolean:
+  case ft_Short:
+  case ft_UShort:
+  case ft_Int:
+  case ft_UInt:
+  case ft_Int64:
+    add_int64(column, value.get_asInt64());
+    break;
+  case ft_Float:
+  case ft_Double:
+  case ft_LongDouble:
+    add_double(column, value.get_asDouble());
+    break;
+  default:
+    add_string(column, value.get_asString().c_str());
+    break;
+  }
+}
+
 } //namespace
@@ -65,6 +65,7 @@ private:
 public:
   field_value();
   explicit field_value(const char *s);
+  explicit field_value(const std::string &s);
   explicit field_value(const bool b);
   explicit field_value(const char c);
   explicit field_value(const short s);
@@ -200,12 +201,96 @@ typedef std::vector<field_value> sql_record;
 typedef std::vector<field_prop> record_prop;
 typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
+typedef std::vector<field_value> BindParams; // values for the '?' placeholders of a statement
 
 //typedef Fields::iterator fld_itor;
 typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
 typedef query_data::iterator qry_itor;
 
+class column_data;
+
+/* Read only view of a cell of a column_data result.
+   Offers the conversions of field_value without copying the cell */
+class column_value {
+public:
+  column_value(const column_data &data, unsigned int column, unsigned int row);
+
+  fType get_fType() const;
+  bool get_isNull() const { return is_null; }
+  std::string get_asString() const;
+  bool get_asBool() const;
+  int get_asInt() const;
+  unsigned int get_asUInt() const;
+  float get_asFloat() const;
+  double get_asDouble() const;
+  int64_t get_asInt64() const;
+/* copy of the cell as field_value */
+  field_value get_asFieldValue() const;
+
+private:
+  int kind;
+  bool is_null;
+  union {
+    int64_t int64_value;
+    double double_value;
+    const char *str_value;
+  };
+};
+
+/* Read only view of a row of a column_data result, usable in place of a sql_record */
+class column_record {
+public:
+  column_record(const column_data &data, unsigned int row) : data(&data), row(row) {}
+
+  column_value at(unsigned int column) const { return column_value(*data, column, row); }
+  unsigned int size() const;
+
+private:
+  const column_data *data;
+  unsigned int row;
+};
+
+/* Columnar storage of a query result. Every column keeps its cells in contiguous
+   vectors (integers and the bits of doubles in one, the storage class in another)
+   and all text lives in a single arena, so a large result needs a handful of
+   allocations instead of one per row and one per text cell. */
+class column_data {
+public:
+  enum cellKind { ckNull, ckInt64, ckDouble, ckString };
+
+  void clear();
+  void set_num_columns(unsigned int count);
+  void reserve(unsigned int rows);
+
+  void add_null(unsigned int column);
+  void add_int64(unsigned int column, int64_t value);
+  void add_double(unsigned int column, double value);
+  void add_string(unsigned int column, const char *value);
+/* append a cell converted from a field_value */
+  void add_value(unsigned int column, const field_value &value);
+
+  unsigned int num_columns() const { return columns.size(); }
+  unsigned int num_rows() const { return columns.empty() ? 0 : columns[0].kinds.size(); }
+  bool empty() const { return num_rows() == 0; }
+  column_record row(unsigned int row) const { return column_record(*this, row); }
+
+private:
+  friend class column_value;
+
+  struct column {
+    std::vector<int64_t> values; // integer, bits of a double or offset into the arena
+    std::vector<uint8_t> kinds;  // cellKind of each cell
+  };
+  std::vector<column> columns;
+  std::string arena; // nul terminated text cells
+};
+
+inline unsigned int column_record::size() const
+{
+  return data->num_columns();
+}
+
 class result_set
 {
 public:
@@ -221,10 +306,14 @@ public:
         delete records[i];
     records.clear();
     record_header.clear();
+    columns.clear();
   };
+/* number of rows, whichever layout holds them */
+  unsigned int size() const { return records.empty() ? columns.num_rows() : records.size(); }
 
   record_prop record_header;
   query_data records;
+  column_data columns; // used instead of records for results fetched with rsColumns
 };
 
 #ifdef TARGET_WINDOWS_STORE
@@ -195,6 +195,9 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
   return 0;
 }
 
+// number of compiled statements kept per connection by default
+constexpr size_t DEFAULT_STATEMENT_CACHE_SIZE = 64;
+
 static int busy_callback(void*, int busyCount)
 {
   KODI::TIME::Sleep(100);
@@ -205,7 +208,9 @@ static int busy_callback(void*, int busyCount)
 
 SqliteDatabase::SqliteDatabase() {
 
+  conn = NULL;
   active = false;
+  m_statementCacheSize = DEFAULT_STATEMENT_CACHE_SIZE;
   _in_transaction = false;    // for transaction
 
   error = "Unknown database error";//S_NO_CONNECTION;
@@ -362,6 +367,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatementCache();
   sqlite3_close(conn);
   active = false;
 }
@@ -519,6 +525,96 @@ void SqliteDatabase::rollback_transaction() {
   }
 }
 
+bool SqliteDatabase::start_savepoint(const std::string &name)
+{
+  return active && sqlite3_exec(conn, ("SAVEPOINT " + name).c_str(), NULL, NULL, NULL) == SQLITE_OK;
+}
+
+bool SqliteDatabase::release_savepoint(const std::string &name)
+{
+  return active && sqlite3_exec(conn, ("RELEASE SAVEPOINT " + name).c_str(), NULL, NULL, NULL) == SQLITE_OK;
+}
+
+bool SqliteDatabase::rollback_savepoint(const std::string &name)
+{
+  return active &&
+         sqlite3_exec(conn, ("ROLLBACK TO SAVEPOINT " + name).c_str(), NULL, NULL, NULL) == SQLITE_OK &&
+         sqlite3_exec(conn, ("RELEASE SAVEPOINT " + name).c_str(), NULL, NULL, NULL) == SQLITE_OK;
+}
+
+
+// methods for prepared statements
+// ---------------------------------------------
+
+void SqliteDatabase::setStatementCacheSize(size_t size)
+{
+  m_statementCacheSize = size;
+  while (m_statements.size() > m_statementCacheSize)
+  {
+    sqlite3_finalize(m_statements.back().second);
+    m_statementIndex.erase(m_statements.back().first);
+    m_statements.pop_back();
+  }
+}
+
+sqlite3_stmt *SqliteDatabase::getStatement(const std::string &sql)
+{
+  // statements are taken out of the cache while in use, so the same statement
+  // can't be handed out twice (e.g. for nested queries on two datasets)
+  auto it = m_statementIndex.find(sql);
+  if (it != m_statementIndex.end())
+  {
+    sqlite3_stmt *stmt = it->second->second;
+    m_statements.erase(it->second);
+    m_statementIndex.erase(it);
+    return stmt;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  int rc = sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL);
+  if (rc != SQLITE_OK)
+  {
+    setErr(rc, sql.c_str());
+    sqlite3_finalize(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+
+void SqliteDatabase::releaseStatement(sqlite3_stmt *stmt, bool keep /* = true */)
+{
+  if (!stmt)
+    return;
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  const char *sql = sqlite3_sql(stmt);
+  if (!keep || !active || m_statementCacheSize == 0 || !sql || m_statementIndex.find(sql) != m_statementIndex.end())
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  m_statements.emplace_front(sql, stmt);
+  m_statementIndex.emplace(m_statements.front().first, m_statements.begin());
+
+  // evict the least recently used statements
+  while (m_statements.size() > m_statementCacheSize)
+  {
+    sqlite3_finalize(m_statements.back().second);
+    m_statementIndex.erase(m_statements.back().first);
+    m_statements.pop_back();
+  }
+}
+
+void SqliteDatabase::clearStatementCache()
+{
+  for (auto &statement : m_statements)
+    sqlite3_finalize(statement.second);
+  m_statements.clear();
+  m_statementIndex.clear();
+}
 
 // methods for formatting
 // ---------------------------------------------
@@ -701,7 +797,7 @@ void SqliteDataset::make_deletion() {
 
 void SqliteDataset::fill_fields() {
   //cout <<"rr "<<result.records.size()<<"|" << frecno <<"\n";
-  if ((db == NULL) || (result.record_header.empty()) || (result.records.size() < (unsigned int)frecno)) return;
+  if ((db == NULL) || (result.record_header.empty()) || (result.size() < (unsigned int)frecno)) return;
 
   if (fields_object->size() == 0) // Filling columns name
   {
@@ -724,6 +820,14 @@ void SqliteDataset::fill_fields() {
       return;
     }
   }
+  else if ((unsigned int)frecno < result.columns.num_rows())
+  {
+    const unsigned int ncols = result.columns.num_columns();
+    fields_object->resize(ncols);
+    for (unsigned int i = 0; i < ncols; i++)
+      (*fields_object)[i].val = result.columns.row(frecno).at(i).get_asFieldValue();
+    return;
+  }
   const unsigned int ncols = result.record_header.size();
   fields_object->resize(ncols);
   for (unsigned int i = 0; i < ncols; i++)
@@ -797,29 +901,8 @@ int SqliteDataset::exec(const std::string &sql) {
     }
 }
 
-int SqliteDataset::exec() {
-  return exec(sql);
-}
-
-const void* SqliteDataset::getExecRes() {
-  return &exec_res;
-}
-
-
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    const std::string& qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))
-         throw DbErrors("MUST be select SQL!");
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors("%s", db->getErrorMsg());
-
+int SqliteDataset::fetch_rows(sqlite3_stmt *stmt, rsLayout layout)
+{
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -827,7 +910,38 @@ bool SqliteDataset::query(const std::string &query) {
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  if (layout == rsColumns)
+  {
+    column_data &columns = result.columns;
+    columns.set_num_columns(numColumns);
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+      for (unsigned int i = 0; i < numColumns; i++)
+      {
+        switch (sqlite3_column_type(stmt, i))
+        {
+        case SQLITE_INTEGER:
+          columns.add_int64(i, sqlite3_column_int64(stmt, i));
+          break;
+        case SQLITE_FLOAT:
+          columns.add_double(i, sqlite3_column_double(stmt, i));
+          break;
+        case SQLITE_TEXT:
+        case SQLITE_BLOB:
+          columns.add_string(i, (const char *)sqlite3_column_text(stmt, i));
+          break;
+        case SQLITE_NULL:
+        default:
+          columns.add_null(i);
+          break;
+        }
+      }
+    }
+    return rc;
+  }
+
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
@@ -857,6 +971,115 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
+  return rc;
+}
+
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql)
+{
+  if (static_cast<int>(params.size()) != sqlite3_bind_parameter_count(stmt))
+    throw DbErrors("Expected %d parameters but got %u for query: %s", sqlite3_bind_parameter_count(stmt),
+                   static_cast<unsigned int>(params.size()), sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &value = params[i];
+    const int index = i + 1;
+    int rc;
+    if (value.get_isNull())
+      rc = sqlite3_bind_null(stmt, index);
+    else
+    {
+      switch (value.get_fType())
+      {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        rc = sqlite3_bind_int64(stmt, index, value.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        rc = sqlite3_bind_double(stmt, index, value.get_asDouble());
+        break;
+      default:
+      {
+        const std::string str = value.get_asString();
+        rc = sqlite3_bind_text(stmt, index, str.c_str(), static_cast<int>(str.size()), SQLITE_TRANSIENT);
+        break;
+      }
+      }
+    }
+    if (rc != SQLITE_OK)
+    {
+      db->setErr(rc, sql.c_str());
+      throw DbErrors("%s", db->getErrorMsg());
+    }
+  }
+}
+
+int SqliteDataset::exec(const std::string &sql, const BindParams &params)
+{
+  if (params.empty())
+    return exec(sql);
+
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  SqliteDatabase *database = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = database->getStatement(sql);
+  if (!stmt)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  int rc;
+  try
+  {
+    bind_params(stmt, params, sql);
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      ;
+  }
+  catch (...)
+  {
+    database->releaseStatement(stmt);
+    throw;
+  }
+  database->releaseStatement(stmt);
+
+  if (rc != SQLITE_DONE)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
+int SqliteDataset::exec() {
+  return exec(sql);
+}
+
+const void* SqliteDataset::getExecRes() {
+  return &exec_res;
+}
+
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    const std::string& qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    if (!( fs >= 0 || fS >=0))
+         throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  fetch_rows(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -870,6 +1093,55 @@ bool SqliteDataset::query(const std::string &query) {
   }
 }
 
+bool SqliteDataset::query(const std::string &sql, const BindParams &params)
+{
+  return query(sql, params, rsRows);
+}
+
+bool SqliteDataset::query(const std::string &sql, const BindParams &params, rsLayout layout)
+{
+  if (!handle()) throw DbErrors("No Database Connection");
+  close();
+
+  // a statement without params has its values in the sql, it's compiled for this query only
+  const bool keep = !params.empty();
+  SqliteDatabase *database = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = database->getStatement(sql);
+  if (!stmt)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  int rc;
+  try
+  {
+    bind_params(stmt, params, sql);
+    rc = fetch_rows(stmt, layout);
+  }
+  catch (...)
+  {
+    database->releaseStatement(stmt, keep);
+    throw;
+  }
+  database->releaseStatement(stmt, keep);
+
+  if (rc != SQLITE_DONE)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_bound(const std::string &sql, rsLayout layout /* = rsRows */)
+{
+  BindParams params;
+  const std::string statement = db->parameterize(sql, params);
+  return query(statement, params, layout);
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -906,7 +1178,7 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
-  return result.records.size();
+  return result.size();
 }
 
 
@@ -14,7 +14,11 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <sqlite3.h>
 
@@ -77,11 +81,40 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  bool start_savepoint(const std::string &name) override;
+  bool release_savepoint(const std::string &name) override;
+  bool rollback_savepoint(const std::string &name) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
   bool in_transaction() override {return _in_transaction;};
 
+/* methods for prepared statements */
+
+  void setStatementCacheSize(size_t size) override;
+
+  /*! \brief Get a compiled statement for sql, either from the statement cache or freshly prepared.
+   The statement has to be handed back with releaseStatement() once done with it.
+   \param sql - the SQL statement to compile
+   \return the compiled statement, NULL on error (see getErrorMsg())
+   */
+  sqlite3_stmt *getStatement(const std::string &sql);
+
+  /*! \brief Hand a statement obtained by getStatement() back to the statement cache.
+   The statement is reset and its bindings cleared, statements that didn't make it
+   into the cache are finalized.
+   \param keep - false to finalize the statement instead of caching it
+   */
+  void releaseStatement(sqlite3_stmt *stmt, bool keep = true);
+
+private:
+  void clearStatementCache();
+
+  typedef std::list<std::pair<std::string, sqlite3_stmt*>> StatementList;
+  StatementList m_statements; // most recently used first
+  std::unordered_map<std::string, StatementList::iterator> m_statementIndex;
+  size_t m_statementCacheSize;
 };
 
 
@@ -112,6 +145,10 @@ protected:
   void fill_fields() override;
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
+/* Bind params to the placeholders of a compiled statement */
+  void bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql);
+/* Fetch all rows of a compiled statement into the result set in the given layout, returns the result of the last step */
+  int fetch_rows(sqlite3_stmt *stmt, rsLayout layout = rsRows);
 
 public:
 /* constructor */
@@ -131,9 +168,13 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const BindParams &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query(const std::string &sql, const BindParams &params) override;
+  bool query(const std::string &sql, const BindParams &params, rsLayout layout) override;
+  bool query_bound(const std::string &sql, rsLayout layout = rsRows) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/qry_dat.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+// a column_data with a single cell
+class CCell
+{
+public:
+  explicit CCell(const field_value& value)
+  {
+    m_data.set_num_columns(1);
+    m_data.add_value(0, value);
+  }
+
+  column_value Get() const { return m_data.row(0).at(0); }
+
+private:
+  column_data m_data;
+};
+
+field_value MakeNull()
+{
+  field_value value;
+  value.set_isNull();
+  return value;
+}
+} // namespace
+
+TEST(TestColumnData, Layout)
+{
+  column_data data;
+  data.set_num_columns(3);
+  EXPECT_TRUE(data.empty());
+
+  std::vector<std::string> names;
+  for (int i = 0; i < 1000; ++i)
+  {
+    // enough text for the arena to be reallocated a few times
+    names.push_back("name " + std::to_string(i));
+    data.add_int64(0, i);
+    data.add_string(1, names.back().c_str());
+    if (i % 2)
+      data.add_null(2);
+    else
+      data.add_double(2, i / 4.0);
+  }
+
+  EXPECT_EQ(3u, data.num_columns());
+  ASSERT_EQ(1000u, data.num_rows());
+  EXPECT_EQ(3u, data.row(0).size());
+  for (unsigned int i = 0; i < data.num_rows(); ++i)
+  {
+    const column_record row = data.row(i);
+    EXPECT_EQ(static_cast<int64_t>(i), row.at(0).get_asInt64());
+    EXPECT_EQ(names[i], row.at(1).get_asString());
+    EXPECT_EQ(i % 2 == 1, row.at(2).get_isNull());
+    if (i % 2 == 0)
+      EXPECT_EQ(i / 4.0, row.at(2).get_asDouble());
+  }
+
+  // a nullptr is stored as an empty string, not as null
+  data.add_string(1, nullptr);
+  EXPECT_FALSE(data.row(1000).at(1).get_isNull());
+  EXPECT_EQ("", data.row(1000).at(1).get_asString());
+
+  data.set_num_columns(2);
+  EXPECT_EQ(2u, data.num_columns());
+  EXPECT_TRUE(data.empty());
+  EXPECT_THROW(data.add_int64(2, 1), std::out_of_range);
+}
+
+TEST(TestColumnData, TypeMapping)
+{
+  // integer types are stored as 64 bit integers
+  field_value value;
+  value.set_asBool(true);
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  value.set_asShort(-3);
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  value.set_asUShort(3);
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  value.set_asInt(-70000);
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  EXPECT_EQ(-70000, CCell(value).Get().get_asInt());
+  value.set_asUInt(4000000000u);
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  EXPECT_EQ(4000000000u, CCell(value).Get().get_asUInt());
+  value.set_asInt64(INT64_C(-9000000000));
+  EXPECT_EQ(ft_Int64, CCell(value).Get().get_fType());
+  EXPECT_EQ(INT64_C(-9000000000), CCell(value).Get().get_asInt64());
+
+  // floating point types as doubles
+  value.set_asFloat(0.5f);
+  EXPECT_EQ(ft_Double, CCell(value).Get().get_fType());
+  EXPECT_EQ(0.5f, CCell(value).Get().get_asFloat());
+  value.set_asDouble(-2.25);
+  EXPECT_EQ(ft_Double, CCell(value).Get().get_fType());
+  EXPECT_EQ(-2.25, CCell(value).Get().get_asDouble());
+
+  // everything else as text
+  value.set_asString("text");
+  EXPECT_EQ(ft_String, CCell(value).Get().get_fType());
+  value.set_asChar('c');
+  EXPECT_EQ(ft_String, CCell(value).Get().get_fType());
+  EXPECT_EQ("c", CCell(value).Get().get_asString());
+
+  // null keeps no value
+  const column_value null = CCell(MakeNull()).Get();
+  EXPECT_TRUE(null.get_isNull());
+  EXPECT_EQ(ft_String, null.get_fType());
+  EXPECT_EQ("", null.get_asString());
+  EXPECT_EQ(0, null.get_asInt());
+  EXPECT_FALSE(null.get_asBool());
+  EXPECT_TRUE(null.get_asFieldValue().get_isNull());
+}
+
+TEST(TestColumnData, AsString)
+{
+  field_value value;
+  value.set_asInt64(-42);
+  EXPECT_EQ("-42", CCell(value).Get().get_asString());
+  value.set_asInt64(INT64_MAX);
+  EXPECT_EQ("9223372036854775807", CCell(value).Get().get_asString());
+  value.set_asDouble(1.5);
+  EXPECT_EQ("1.500000", CCell(value).Get().get_asString());
+  EXPECT_EQ(value.get_asString(), CCell(value).Get().get_asString());
+  value.set_asString("");
+  EXPECT_EQ("", CCell(value).Get().get_asString());
+  value.set_asString("it's ü");
+  EXPECT_EQ("it's ü", CCell(value).Get().get_asString());
+
+  // booleans become integers, like they are in SQLite
+  value.set_asBool(true);
+  EXPECT_EQ("1", CCell(value).Get().get_asString());
+}
+
+TEST(TestColumnData, AsBool)
+{
+  field_value value;
+  value.set_asInt64(0);
+  EXPECT_FALSE(CCell(value).Get().get_asBool());
+  value.set_asInt64(-1);
+  EXPECT_TRUE(CCell(value).Get().get_asBool());
+  value.set_asDouble(0.0);
+  EXPECT_FALSE(CCell(value).Get().get_asBool());
+  value.set_asDouble(0.5);
+  EXPECT_TRUE(CCell(value).Get().get_asBool());
+  value.set_asBool(true);
+  EXPECT_TRUE(CCell(value).Get().get_asBool());
+  value.set_asBool(false);
+  EXPECT_FALSE(CCell(value).Get().get_asBool());
+
+  // the same text is true as for field_value
+  for (const char* text : {"True", "true", "1", "False", "0", "yes", "TRUE", ""})
+  {
+    value.set_asString(text);
+    EXPECT_EQ(value.get_asBool(), CCell(value).Get().get_asBool()) << text;
+  }
+}
+
+TEST(TestColumnData, SqliteColumns)
+{
+  SqliteDatabase db;
+  db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+  db.setDatabase("TestColumnData");
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+  std::unique_ptr<Dataset> ds(db.CreateDataset());
+  ds->exec("CREATE TABLE t (i integer, r real, s text, n integer)");
+  ds->exec("INSERT INTO t VALUES (1, 0.25, 'one', NULL)");
+  ds->exec("INSERT INTO t VALUES (-2, 3, '', 7)");
+  ds->exec("INSERT INTO t VALUES (NULL, NULL, 'true', 'text')");
+
+  const std::string sql = "SELECT i, r, s, n FROM t ORDER BY rowid";
+  ASSERT_TRUE(ds->query(sql, BindParams(), rsRows));
+  std::vector<sql_record> rows;
+  for (const auto& record : ds->get_result_set().records)
+    rows.push_back(*record);
+  ds->close();
+
+  ASSERT_TRUE(ds->query(sql, BindParams(), rsColumns));
+  const column_data& columns = ds->get_result_set().columns;
+  EXPECT_TRUE(ds->get_result_set().records.empty());
+  ASSERT_EQ(rows.size(), columns.num_rows());
+  ASSERT_EQ(4u, columns.num_columns());
+
+  // the columns hold what the rows hold
+  for (unsigned int row = 0; row < columns.num_rows(); ++row)
+  {
+    for (unsigned int column = 0; column < columns.num_columns(); ++column)
+    {
+      const field_value& expected = rows[row][column];
+      const column_value value = columns.row(row).at(column);
+      EXPECT_EQ(expected.get_isNull(), value.get_isNull()) << row << ", " << column;
+      if (expected.get_isNull())
+        continue;
+      EXPECT_EQ(expected.get_asString(), value.get_asString()) << row << ", " << column;
+      EXPECT_EQ(expected.get_asInt64(), value.get_asInt64()) << row << ", " << column;
+      EXPECT_EQ(expected.get_asDouble(), value.get_asDouble()) << row << ", " << column;
+      EXPECT_EQ(expected.get_asBool(), value.get_asBool()) << row << ", " << column;
+    }
+  }
+
+  EXPECT_EQ(ft_Int64, columns.row(0).at(0).get_fType());
+  EXPECT_EQ(ft_Double, columns.row(1).at(1).get_fType());
+  EXPECT_EQ(ft_String, columns.row(2).at(3).get_fType());
+
+  ds->close();
+  ds.reset();
+  db.disconnect();
+  XFILE::CFile::Delete("special://temp/TestColumnData.db");
+}
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+// quotes strings the SQLite way, but takes backslashes for escapes as MySQL does
+class CBackslashDatabase : public SqliteDatabase
+{
+public:
+  bool backslash_escapes() const override { return true; }
+};
+
+class CBatchDatabase : public CDatabase
+{
+public:
+  bool Open() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return Connect(GetBaseDBName(), settings, true);
+  }
+
+  bool AddRow(int value)
+  {
+    BeginTransaction();
+    if (!ExecuteQuery(PrepareSQL("INSERT INTO batch (value) VALUES (%i)", value)))
+    {
+      RollbackTransaction();
+      return false;
+    }
+    return CommitTransaction();
+  }
+
+  int CountRows() { return GetSingleValueInt("SELECT COUNT(1) FROM batch"); }
+
+protected:
+  void CreateTables() override { m_pDS->exec("CREATE TABLE batch (value integer)"); }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char* GetBaseDBName() const override { return "TestBatch"; }
+};
+}
+
+class TestDatabaseBatch : public testing::Test
+{
+protected:
+  TestDatabaseBatch() { EXPECT_TRUE(db.Open()); }
+  ~TestDatabaseBatch() override
+  {
+    db.Close();
+    XFILE::CFile::Delete("special://temp/TestBatch.db");
+  }
+
+  CBatchDatabase db;
+};
+
+TEST(TestDatabase, BindPlaceholders)
+{
+  SqliteDatabase db;
+  BindParams params;
+  params.emplace_back(static_cast<int64_t>(42));
+  params.emplace_back(std::string("it's"));
+  params.emplace_back(true);
+  EXPECT_EQ("SELECT * FROM song WHERE idSong = 42 AND strTitle = 'it''s' AND b = 1",
+            db.bind("SELECT * FROM song WHERE idSong = ? AND strTitle = ? AND b = ?", params));
+  EXPECT_EQ("SELECT 1", db.bind("SELECT 1", BindParams()));
+}
+
+TEST(TestDatabase, BindQuotedPlaceholder)
+{
+  SqliteDatabase db;
+  BindParams params;
+  params.emplace_back(static_cast<int64_t>(1));
+  EXPECT_EQ("SELECT '?', \"?\" FROM t WHERE a = 1 AND b = 'what''s ?'",
+            db.bind("SELECT '?', \"?\" FROM t WHERE a = ? AND b = 'what''s ?'", params));
+}
+
+TEST(TestDatabase, BindBackslashes)
+{
+  BindParams params;
+  params.emplace_back(static_cast<int64_t>(7));
+
+  // a backslash is an ordinary character in SQLite strings, 'C:\' ends the string
+  SqliteDatabase sqlite;
+  EXPECT_EQ("SELECT 1 FROM path WHERE strPath = 'C:\\' AND idPath = 7",
+            sqlite.bind("SELECT 1 FROM path WHERE strPath = 'C:\\' AND idPath = ?", params));
+
+  // with backslash escapes \' doesn't end the string, the '?' following it is quoted
+  CBackslashDatabase mysql;
+  EXPECT_EQ("SELECT 1 FROM song WHERE strTitle = 'don\\'t ?' AND idSong = 7",
+            mysql.bind("SELECT 1 FROM song WHERE strTitle = 'don\\'t ?' AND idSong = ?", params));
+}
+
+TEST(TestDatabase, BindMismatch)
+{
+  SqliteDatabase db;
+  BindParams params;
+  params.emplace_back(static_cast<int64_t>(1));
+  EXPECT_THROW(db.bind("SELECT 1 FROM t WHERE a = ? AND b = ?", params), DbErrors);
+
+  // values without a placeholder aren't dropped silently either
+  params.emplace_back(static_cast<int64_t>(2));
+  EXPECT_THROW(db.bind("SELECT 1 FROM t WHERE a = ?", params), DbErrors);
+  EXPECT_THROW(db.bind("SELECT 1 FROM t WHERE a = '?'", params), DbErrors);
+}
+
+TEST(TestDatabase, Parameterize)
+{
+  SqliteDatabase db;
+  BindParams params;
+  EXPECT_EQ("SELECT songview.* FROM songview WHERE idAlbum = ? AND strTitle LIKE ? AND "
+            "iYear >= ? AND rating > 7.5 AND idArtist IN (?, ?, ?) LIMIT ? OFFSET ?",
+            db.parameterize("SELECT songview.* FROM songview WHERE idAlbum = 12 AND strTitle "
+                            "LIKE '%it''s%' AND iYear >= -1 AND rating > 7.5 AND idArtist IN "
+                            "(1, 2, 3) LIMIT 10 OFFSET 20", params));
+  ASSERT_EQ(8u, params.size());
+  EXPECT_EQ(12, params[0].get_asInt64());
+  EXPECT_EQ("%it's%", params[1].get_asString());
+  EXPECT_EQ(-1, params[2].get_asInt64());
+  EXPECT_EQ(3, params[5].get_asInt64());
+  EXPECT_EQ(20, params[7].get_asInt64());
+
+  // values elsewhere, identifiers and statements with placeholders are left alone
+  const std::string select = "SELECT 'a' AS \"x = 1\", COUNT(1) FROM t GROUP BY 1 ORDER BY 2";
+  EXPECT_EQ(select, db.parameterize(select, params));
+  EXPECT_TRUE(params.empty());
+  const std::string bound = "SELECT * FROM t WHERE a = 1 AND b = ?";
+  EXPECT_EQ(bound, db.parameterize(bound, params));
+  EXPECT_TRUE(params.empty());
+
+  // no subquery values are taken for those of an IN list
+  EXPECT_EQ("SELECT * FROM t WHERE a IN (SELECT b, 1 FROM u WHERE c = ?)",
+            db.parameterize("SELECT * FROM t WHERE a IN (SELECT b, 1 FROM u WHERE c = 'x')", params));
+  ASSERT_EQ(1u, params.size());
+
+  // strings with backslashes are left to backends escaping with them
+  CBackslashDatabase mysql;
+  EXPECT_EQ("SELECT * FROM t WHERE a = 'x\\'y' AND b = ?",
+            mysql.parameterize("SELECT * FROM t WHERE a = 'x\\'y' AND b = 'z'", params));
+  ASSERT_EQ(1u, params.size());
+  EXPECT_EQ("z", params[0].get_asString());
+}
+
+TEST_F(TestDatabaseBatch, Commit)
+{
+  db.BeginBatch();
+  EXPECT_TRUE(db.InBatch());
+  EXPECT_TRUE(db.AddRow(1));
+  EXPECT_TRUE(db.AddRow(2));
+  EXPECT_TRUE(db.CommitBatch());
+  EXPECT_FALSE(db.InBatch());
+  EXPECT_EQ(2, db.CountRows());
+}
+
+TEST_F(TestDatabaseBatch, RollbackToSavepoint)
+{
+  db.BeginBatch();
+  EXPECT_TRUE(db.AddRow(1));
+
+  // only the transaction rolled back is lost, the batch goes on
+  db.BeginTransaction();
+  EXPECT_TRUE(db.ExecuteQuery("INSERT INTO batch (value) VALUES (2)"));
+  db.RollbackTransaction();
+  EXPECT_TRUE(db.InBatch());
+
+  EXPECT_TRUE(db.AddRow(3));
+  EXPECT_TRUE(db.CommitBatch());
+  EXPECT_EQ(2, db.CountRows());
+  EXPECT_EQ(0, db.GetSingleValueInt("SELECT COUNT(1) FROM batch WHERE value = 2"));
+}
+
+TEST_F(TestDatabaseBatch, NestedSavepoints)
+{
+  db.BeginBatch();
+  db.BeginTransaction();
+  EXPECT_TRUE(db.AddRow(1));
+  EXPECT_TRUE(db.ExecuteQuery("INSERT INTO batch (value) VALUES (2)"));
+  // rolls back the inner transaction, committed into this one, as well
+  db.RollbackTransaction();
+  EXPECT_TRUE(db.InBatch());
+
+  EXPECT_TRUE(db.AddRow(3));
+  EXPECT_TRUE(db.CommitBatch());
+  EXPECT_EQ(1, db.CountRows());
+}
+
+TEST_F(TestDatabaseBatch, Lost)
+{
+  db.BeginBatch();
+  EXPECT_TRUE(db.AddRow(1));
+
+  // a rollback without a savepoint to roll back to discards and ends the batch
+  db.RollbackTransaction();
+  EXPECT_FALSE(db.InBatch());
+
+  // later transactions are committed on their own again
+  EXPECT_TRUE(db.AddRow(2));
+  EXPECT_FALSE(db.CommitBatch());
+  EXPECT_EQ(1, db.CountRows());
+
+  // the loss is reported once
+  db.BeginBatch();
+  EXPECT_TRUE(db.CommitBatch());
+}
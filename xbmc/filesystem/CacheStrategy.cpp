@@ -46,6 +46,11 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+void CCacheStrategy::GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges)
+{
+  ranges.clear();
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -258,6 +263,13 @@ bool CSimpleFileCache::IsCachedPosition(int64_t iFilePosition)
   return iFilePosition >= m_nStartPosition && iFilePosition <= m_nStartPosition + m_nWritePosition;
 }
 
+void CSimpleFileCache::GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges)
+{
+  ranges.clear();
+  if (m_nWritePosition > 0)
+    ranges.emplace_back(m_nStartPosition, m_nStartPosition + m_nWritePosition);
+}
+
 CCacheStrategy *CSimpleFileCache::CreateNew()
 {
   return new CSimpleFileCache();
@@ -388,6 +400,18 @@ bool CDoubleCache::IsCachedPosition(int64_t iFilePosition)
   return m_pCache->IsCachedPosition(iFilePosition) || (m_pCacheOld && m_pCacheOld->IsCachedPosition(iFilePosition));
 }
 
+void CDoubleCache::GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges)
+{
+  m_pCache->GetCachedRanges(ranges);
+  if (m_pCacheOld)
+  {
+    std::vector<std::pair<int64_t, int64_t>> old;
+    m_pCacheOld->GetCachedRanges(old);
+    ranges.insert(ranges.end(), old.begin(), old.end());
+    std::sort(ranges.begin(), ranges.end());
+  }
+}
+
 CCacheStrategy *CDoubleCache::CreateNew()
 {
   return new CDoubleCache(m_pCache->CreateNew());
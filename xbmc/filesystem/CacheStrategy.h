@@ -12,6 +12,8 @@
 
 #include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace XFILE {
 
@@ -53,6 +55,12 @@ public:
   virtual int64_t CachedDataEndPos() = 0;
   virtual bool IsCachedPosition(int64_t iFilePosition) = 0;
 
+  /*!
+   \brief Get the byte ranges of the file held in the cache
+   \param ranges [out] start and end (exclusive) of each cached range
+   */
+  virtual void GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges);
+
   virtual CCacheStrategy *CreateNew() = 0;
 
   CEvent m_space;
@@ -82,6 +90,7 @@ public:
   int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
   int64_t CachedDataEndPos() override;
   bool IsCachedPosition(int64_t iFilePosition) override;
+  void GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges) override;
 
   CCacheStrategy *CreateNew() override;
 
@@ -119,6 +128,7 @@ public:
   int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
   int64_t CachedDataEndPos() override;
   bool IsCachedPosition(int64_t iFilePosition) override;
+  void GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges) override;
 
   CCacheStrategy *CreateNew() override;
 
@@ -261,6 +261,14 @@ bool CCircularCache::IsCachedPosition(int64_t iFilePosition)
   return iFilePosition >= m_beg && iFilePosition <= m_end;
 }
 
+void CCircularCache::GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges)
+{
+  CSingleLock lock(m_sync);
+  ranges.clear();
+  if (m_end > m_beg)
+    ranges.emplace_back(m_beg, m_end);
+}
+
 CCacheStrategy *CCircularCache::CreateNew()
 {
   return new CCircularCache(m_size - m_size_back, m_size_back);
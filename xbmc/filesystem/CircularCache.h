@@ -34,6 +34,7 @@ public:
     int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
     int64_t CachedDataEndPos() override;
     bool IsCachedPosition(int64_t iFilePosition) override;
+    void GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges) override;
 
     CCacheStrategy *CreateNew() override;
 protected:
@@ -9,6 +9,7 @@
 #include "CurlFile.h"
 
 #include "File.h"
+#include "HttpCache.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
@@ -19,11 +20,14 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SystemClock.h"
 #include "utils/Base64.h"
+#include "utils/Metrics.h"
+#include "utils/TimeUtils.h"
 #include "utils/XTimeUtils.h"
 
 #include <algorithm>
 #include <cassert>
 #include <climits>
+#include <cstring>
 #include <vector>
 
 #ifdef TARGET_POSIX
@@ -55,6 +59,9 @@ curl_proxytype proxyType2CUrlProxyType[] = {
 #define FILLBUFFER_NO_DATA    1
 #define FILLBUFFER_FAIL       2
 
+// size of the ranges a file is split into when it's read over several connections
+#define PARALLEL_RANGE_SIZE   (1024 * 1024)
+
 // curl calls this routine to debug
 extern "C" int debug_callback(CURL_HANDLE *handle, curl_infotype info, char *output, size_t size, void *data)
 {
@@ -102,6 +109,39 @@ extern "C" size_t write_callback(char *buffer,
   return state->WriteCallback(buffer, size, nitems);
 }
 
+struct CCurlFile::CParallelRead::CRange
+{
+  CReadState state;       // connection, and header lists its options refer to
+  int64_t start = 0;      // file position of the first byte
+  int64_t end = 0;        // file position after the last byte
+  std::vector<char> data; // received so far
+  size_t consumed = 0;    // handed out to the reader
+  bool running = false;
+  int retries = 0;
+
+  size_t Write(char *buffer, size_t size)
+  {
+    // a server ignoring the requested range would send more than fits
+    if (start + static_cast<int64_t>(data.size() + size) > end)
+      return 0;
+
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+/* curl calls this routine to hand out data of a range */
+extern "C" size_t range_write_callback(char *buffer,
+               size_t size,
+               size_t nitems,
+               void *userp)
+{
+  if(userp == NULL) return 0;
+
+  CCurlFile::CParallelRead::CRange *range = (CCurlFile::CParallelRead::CRange *)userp;
+  return range->Write(buffer, size * nitems);
+}
+
 extern "C" size_t read_callback(char *buffer,
                size_t size,
                size_t nitems,
@@ -342,9 +382,19 @@ long CCurlFile::CReadState::Connect(unsigned int size)
   // maybe there's a better way to get this info??
   m_stillRunning = 1;
 
+  static std::atomic<uint64_t>& connects = CMetrics::GetInstance().GetCounter("curl.connects");
+  static std::atomic<uint64_t>& failures = CMetrics::GetInstance().GetCounter("curl.connects.failed");
+  static CLatencyHistogram& latency = CMetrics::GetInstance().GetHistogram("curl.connect");
+  connects++;
+
   // (Try to) fill buffer
-  if (FillBuffer(1) != FILLBUFFER_OK)
+  const int64_t start = CurrentHostCounter();
+  const int8_t state = FillBuffer(1);
+  latency.Add((CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency());
+  if (state != FILLBUFFER_OK)
   {
+    failures++;
+
     // Check response code
     long response;
     if (CURLE_OK == g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response))
@@ -441,6 +491,7 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  m_parallel.reset();
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -939,16 +990,83 @@ bool CCurlFile::Get(const std::string& strURL, std::string& strHTML)
 bool CCurlFile::Service(const std::string& strURL, std::string& strHTML)
 {
   const CURL pathToUrl(strURL);
-  if (Open(pathToUrl))
+
+  // plain requests for a whole http resource may be answered from the cache
+  CHttpCache& cache = CHttpCache::GetInstance();
+  std::string cacheKey;
+  CHttpCache::CEntry cached;
+  bool revalidate = false;
+  if (IsCacheableRequest(pathToUrl) && cache.IsEnabled())
   {
-    if (ReadData(strHTML))
+    cacheKey = CHttpCache::GetKey(strURL, m_requestheaders);
+    const CHttpCache::LookupResult result = cache.Lookup(cacheKey, cached);
+    if (result == CHttpCache::LookupResult::FRESH)
     {
-      Close();
+      m_state->m_httpheader.Clear();
+      m_state->m_httpheader.Parse(cached.header);
+      m_httpresponse = 200;
+      strHTML = cached.body;
       return true;
     }
+
+    revalidate = result == CHttpCache::LookupResult::STALE;
+    if (revalidate && !cached.etag.empty())
+      m_requestheaders["If-None-Match"] = cached.etag;
+    if (revalidate && !cached.lastModified.empty())
+      m_requestheaders["If-Modified-Since"] = cached.lastModified;
   }
+
+  bool success = false;
+  if (Open(pathToUrl))
+    success = ReadData(strHTML);
   Close();
-  return false;
+
+  if (revalidate)
+  {
+    m_requestheaders.erase("If-None-Match");
+    m_requestheaders.erase("If-Modified-Since");
+  }
+
+  if (success && !cacheKey.empty())
+  {
+    if (revalidate && m_httpresponse == 304)
+    {
+      cache.Revalidated(cacheKey, m_state->m_httpheader, cached);
+      m_state->m_httpheader.Clear();
+      m_state->m_httpheader.Parse(cached.header);
+      m_httpresponse = 200;
+      strHTML = cached.body;
+    }
+    else if (m_httpresponse == 200)
+      cache.Store(cacheKey, m_state->m_httpheader, strHTML);
+  }
+
+  return success;
+}
+
+bool CCurlFile::IsCacheableRequest(const CURL& url) const
+{
+  if (m_postdataset || m_opened)
+    return false;
+
+  if (!url.IsProtocol("http") && !url.IsProtocol("https"))
+    return false;
+
+  // leave responses depending on credentials or on conditions of the caller alone
+  if (!url.GetUserName().empty() || !m_username.empty())
+    return false;
+
+  for (const auto& header : m_requestheaders)
+  {
+    if (StringUtils::StartsWithNoCase(header.first, "if-") ||
+        StringUtils::EqualsNoCase(header.first, "range") ||
+        StringUtils::EqualsNoCase(header.first, "authorization") ||
+        StringUtils::EqualsNoCase(header.first, "proxy-authorization") ||
+        StringUtils::EqualsNoCase(header.first, "cookie"))
+      return false;
+  }
+
+  return true;
 }
 
 bool CCurlFile::ReadData(std::string& strHTML)
@@ -1141,6 +1259,26 @@ bool CCurlFile::Open(const CURL& url)
     m_url = efurl;
   }
 
+  // big files of servers that handle ranges can be read over several connections, which gets
+  // around a limited bandwidth per connection
+  unsigned int connections = m_connections;
+  if (connections == 0)
+    connections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlConnections;
+  if (connections > 1 && m_seekable && m_multisession && m_httpresponse == 206 &&
+      m_state->m_fileSize >= 4 * static_cast<int64_t>(connections) * PARALLEL_RANGE_SIZE)
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::Open - Reading over %u connections", connections);
+
+    const int64_t pos = m_state->m_filePos;
+    const int64_t size = m_state->m_fileSize;
+    m_state->Disconnect();
+    m_state->m_filePos = pos;
+    m_state->m_fileSize = size;
+
+    m_parallel.reset(new CParallelRead(*this, connections));
+    m_parallel->Start(pos);
+  }
+
   return true;
 }
 
@@ -1241,14 +1379,28 @@ bool CCurlFile::CReadState::ReadString(char *szLine, int iLineLength)
     return false;
   }
 
+  // copy up to and including the newline straight out of the buffer
   char* pLine = szLine;
-  do
+  unsigned int left = want;
+  while (left > 0)
   {
-    if (!m_buffer.ReadData(pLine, 1))
+    unsigned int size;
+    const char* data = m_buffer.PeekRead(size);
+    if (!data)
       break;
 
-    pLine++;
-  } while (((pLine - 1)[0] != '\n') && ((unsigned int)(pLine - szLine) < want));
+    size = std::min(size, left);
+    const char* newline = static_cast<const char*>(memchr(data, '\n', size));
+    if (newline)
+      size = newline - data + 1;
+
+    memcpy(pLine, data, size);
+    m_buffer.CommitRead(size);
+    pLine += size;
+    left -= size;
+    if (newline)
+      break;
+  }
   pLine[0] = 0;
   m_filePos += (pLine - szLine);
   return (pLine - szLine) > 0;
@@ -1376,6 +1528,14 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_parallel)
+  {
+    if (!m_parallel->Seek(nextPos))
+      m_parallel->Start(nextPos);
+    m_state->m_filePos = nextPos;
+    return nextPos;
+  }
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1458,6 +1618,282 @@ int64_t CCurlFile::GetPosition()
   return m_state->m_filePos;
 }
 
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  // the data of a parallel read is in its ranges, not in the buffer of the read state
+  if (m_parallel)
+    return m_parallel->ReadString(szLine, iLineLength);
+  return m_state->ReadString(szLine, iLineLength);
+}
+
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  static std::atomic<uint64_t>& bytes = CMetrics::GetInstance().GetCounter("curl.bytes");
+
+  const ssize_t read =
+      m_parallel ? m_parallel->Read(lpBuf, uiBufSize) : m_state->Read(lpBuf, uiBufSize);
+  if (read > 0)
+    bytes += read;
+  return read;
+}
+
+CCurlFile::CParallelRead::CParallelRead(CCurlFile& file, unsigned int connections)
+  : m_file(file), m_connections(connections)
+{
+  m_multiHandle = g_curlInterface.multi_init();
+}
+
+CCurlFile::CParallelRead::~CParallelRead()
+{
+  Stop();
+  g_curlInterface.multi_cleanup(m_multiHandle);
+}
+
+void CCurlFile::CParallelRead::Stop()
+{
+  for (const auto& range : m_ranges)
+  {
+    if (range->running)
+      g_curlInterface.multi_remove_handle(m_multiHandle, range->state.m_easyHandle);
+  }
+  m_ranges.clear();
+}
+
+void CCurlFile::CParallelRead::Start(int64_t pos)
+{
+  Stop();
+
+  const int64_t fileSize = m_file.m_state->m_fileSize;
+  m_nextStart = pos;
+  for (unsigned int i = 0; i < m_connections && m_nextStart < fileSize; i++)
+  {
+    std::unique_ptr<CRange> range(new CRange);
+    range->start = m_nextStart;
+    range->end = std::min(m_nextStart + PARALLEL_RANGE_SIZE, fileSize);
+    m_nextStart = range->end;
+
+    // a range that can't be started now is retried by Read()
+    Fetch(*range);
+    m_ranges.push_back(std::move(range));
+  }
+}
+
+bool CCurlFile::CParallelRead::Seek(int64_t pos)
+{
+  if (m_ranges.empty())
+    return false;
+
+  CRange& range = *m_ranges.front();
+  if (pos < range.start || pos >= range.end ||
+      pos > range.start + static_cast<int64_t>(range.data.size()))
+    return false;
+
+  range.consumed = static_cast<size_t>(pos - range.start);
+  return true;
+}
+
+bool CCurlFile::CParallelRead::Fetch(CRange& range)
+{
+  CReadState& state = range.state;
+  if (!state.m_easyHandle)
+  {
+    CURL url(m_file.m_url);
+    g_curlInterface.easy_acquire(url.GetProtocol().c_str(),
+                                 url.GetHostName().c_str(),
+                                 &state.m_easyHandle,
+                                 NULL);
+  }
+
+  m_file.SetCommonOptions(&state);
+  m_file.SetRequestHeaders(&state);
+
+  // the data goes to the range rather than the buffer of the read state
+  CURL_HANDLE* h = state.m_easyHandle;
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEDATA, &range);
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEFUNCTION, range_write_callback);
+
+  // continue after the data received in an earlier attempt
+  const std::string bytes = StringUtils::Format("%" PRId64 "-%" PRId64,
+                                                range.start + static_cast<int64_t>(range.data.size()),
+                                                range.end - 1);
+  g_curlInterface.easy_setopt(h, CURLOPT_RANGE, bytes.c_str());
+  range.data.reserve(static_cast<size_t>(range.end - range.start));
+
+  if (g_curlInterface.multi_add_handle(m_multiHandle, h) != CURLM_OK)
+    return false;
+
+  range.running = true;
+  return true;
+}
+
+bool CCurlFile::CParallelRead::Perform()
+{
+  int running;
+  CURLMcode result;
+  do
+  {
+    result = g_curlInterface.multi_perform(m_multiHandle, &running);
+  } while (result == CURLM_CALL_MULTI_PERFORM);
+
+  if (result != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CParallelRead::Perform - Multi perform failed with code %d", result);
+    return false;
+  }
+
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    // the message doesn't survive removing the handle
+    CURL_HANDLE* easy = msg->easy_handle;
+    const CURLcode code = msg->data.result;
+    for (const auto& range : m_ranges)
+    {
+      if (range->state.m_easyHandle != easy)
+        continue;
+
+      g_curlInterface.multi_remove_handle(m_multiHandle, easy);
+      range->running = false;
+      if (code != CURLE_OK)
+        CLog::Log(LOGWARNING, "CCurlFile::CParallelRead::Perform - Range %" PRId64 "-%" PRId64 " failed: %s(%d)",
+                  range->start, range->end - 1, g_curlInterface.easy_strerror(code), code);
+      break;
+    }
+  }
+  return true;
+}
+
+bool CCurlFile::CParallelRead::Wait()
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  int maxfd = -1;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+
+  // get file descriptors from the transfers
+  g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+  long timeout = 0;
+  if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout < 0 || timeout > 200)
+    timeout = 200;
+
+  if (maxfd == -1)
+  {
+    // no sockets yet, sleep for the minimum suggested in the curl_multi_fdset() doc
+    KODI::TIME::Sleep(100);
+    return true;
+  }
+
+  struct timeval wait = { (int)timeout / 1000, ((int)timeout % 1000) * 1000 };
+  int rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &wait);
+#ifdef TARGET_WINDOWS
+  if (rc == SOCKET_ERROR && WSAGetLastError() != WSAEINTR)
+#else
+  if (rc == SOCKET_ERROR && errno != EINTR)
+#endif
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CParallelRead::Wait - Failed with socket error");
+    return false;
+  }
+  return true;
+}
+
+ssize_t CCurlFile::CParallelRead::Read(void* lpBuf, size_t uiBufSize, bool toNewline /* = false */)
+{
+  CReadState* state = m_file.m_state;
+  if (state->m_filePos >= state->m_fileSize || m_ranges.empty())
+    return 0;
+
+  // keep all transfers going, not only the one being read
+  if (!Perform())
+    return -1;
+
+  CRange& range = *m_ranges.front();
+  while (range.data.size() <= range.consumed)
+  {
+    if (state->m_cancelled)
+      return 0;
+
+    if (!range.running)
+    {
+      // the transfer ended before the range was complete
+      const int maxRetries = m_file.m_allowRetry ?
+          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlretries : 0;
+      if (range.retries >= maxRetries)
+      {
+        CLog::Log(LOGERROR, "CCurlFile::CParallelRead::Read - Failed to fetch range %" PRId64 "-%" PRId64,
+                  range.start, range.end - 1);
+        return -1;
+      }
+
+      range.retries++;
+      CLog::Log(LOGWARNING, "CCurlFile::CParallelRead::Read - Reconnect, (re)try %i", range.retries);
+      Fetch(range);
+    }
+
+    if (!Wait() || !Perform())
+      return -1;
+  }
+
+  size_t amount = std::min(uiBufSize, range.data.size() - range.consumed);
+  if (toNewline)
+  {
+    const char* data = range.data.data() + range.consumed;
+    const char* newline = static_cast<const char*>(memchr(data, '\n', amount));
+    if (newline)
+      amount = newline - data + 1;
+  }
+  memcpy(lpBuf, range.data.data() + range.consumed, amount);
+  range.consumed += amount;
+  state->m_filePos += amount;
+
+  if (range.start + static_cast<int64_t>(range.consumed) == range.end)
+  {
+    // fetch the next part of the file with the connection of the range
+    std::unique_ptr<CRange> next = std::move(m_ranges.front());
+    m_ranges.pop_front();
+    if (m_nextStart < state->m_fileSize)
+    {
+      next->start = m_nextStart;
+      next->end = std::min(m_nextStart + PARALLEL_RANGE_SIZE, state->m_fileSize);
+      next->data.clear();
+      next->consumed = 0;
+      next->retries = 0;
+      m_nextStart = next->end;
+
+      Fetch(*next);
+      m_ranges.push_back(std::move(next));
+    }
+  }
+
+  return amount;
+}
+
+bool CCurlFile::CParallelRead::ReadString(char *szLine, int iLineLength)
+{
+  // a line may continue in the next range
+  size_t length = 0;
+  while (length < static_cast<size_t>(iLineLength))
+  {
+    const ssize_t read = Read(szLine + length, iLineLength - length, true);
+    if (read <= 0)
+      break;
+
+    length += read;
+    if (szLine[length - 1] == '\n')
+      break;
+  }
+  szLine[length] = 0;
+  return length > 0;
+}
+
 int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
 {
   // if file is already running, get info from it
@@ -11,8 +11,11 @@
 #include "IFile.h"
 #include "utils/HttpHeader.h"
 #include "utils/RingBuffer.h"
+#include "utils/SPSCRingBuffer.h"
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
 
 typedef void CURL_HANDLE;
@@ -45,8 +48,8 @@ namespace XFILE
       int64_t GetLength() override;
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
-      bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      bool ReadString(char *szLine, int iLineLength) override;
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       const std::string GetProperty(XFILE::FileProperty type, const std::string &name = "") const override;
       const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string &name = "") const override;
@@ -78,6 +81,13 @@ namespace XFILE
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
+      /*!
+       \brief Set the number of connections a seekable http(s) file is read over.
+       \param connections number of connections, 1 for a single one, 0 to use the advanced setting.
+       Has to be called before Open().
+       */
+      void SetConnections(unsigned int connections) { m_connections = connections; }
+
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
       std::string GetURL(void);
       std::string GetRedirectURL();
@@ -98,7 +108,7 @@ namespace XFILE
           CURL_HANDLE* m_easyHandle;
           CURLM* m_multiHandle;
 
-          CRingBuffer m_buffer; // our ringhold buffer
+          CSPSCRingBuffer m_buffer; // our ringhold buffer, filled by the curl callback
           unsigned int m_bufferSize;
 
           char* m_overflowBuffer; // in the rare case we would overflow the above buffer
@@ -137,18 +147,68 @@ namespace XFILE
           void Disconnect();
       };
 
+      /*!
+       \brief Reads a file over several connections at once.
+
+       The file is split into consecutive ranges that are requested with their own Range
+       request over separate connections, all driven by one multi handle. Reading hands out
+       the data in file order, and a range that has been read completely is reused to fetch
+       the range following the last one requested.
+       */
+      class CParallelRead
+      {
+      public:
+        CParallelRead(CCurlFile& file, unsigned int connections);
+        ~CParallelRead();
+
+        /*!
+         \brief Drop all ranges and start fetching from a position.
+         */
+        void Start(int64_t pos);
+
+        /*!
+         \brief Move the read position within the data already fetched.
+         \return false if the position isn't available, Start() has to be called instead.
+         */
+        bool Seek(int64_t pos);
+
+        /*!
+         \brief Read from the ranges in file order.
+         \param toNewline stop after the first newline, if any.
+         */
+        ssize_t Read(void* lpBuf, size_t uiBufSize, bool toNewline = false);
+        bool ReadString(char *szLine, int iLineLength);
+
+        struct CRange;
+
+      private:
+        bool Fetch(CRange& range);
+        bool Perform();
+        bool Wait();
+        void Stop();
+
+        CCurlFile& m_file;
+        unsigned int m_connections;
+        CURLM* m_multiHandle;
+        std::deque<std::unique_ptr<CRange>> m_ranges; ///< ranges being fetched, in file order
+        int64_t m_nextStart = 0;                      ///< file position after the last range
+      };
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state, bool failOnError = true);
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const std::string& strURL, std::string& strHTML);
+      bool IsCacheableRequest(const CURL& url) const;
       std::string GetInfoString(int infoType);
 
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
+      std::unique_ptr<CParallelRead> m_parallel;
       unsigned int m_bufferSize;
+      unsigned int m_connections = 0;
       int64_t m_writeOffset = 0;
 
       std::string m_url;
@@ -170,7 +170,22 @@ bool CDirectory::GetDirectory(const CURL& url,
       return false;
 
     // check our cache for this path
-    if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    const bool readCache = (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE;
+    bool cached = g_directoryCache.GetDirectory(realURL.Get(), items, readCache);
+
+    // fall back to a listing persisted by an earlier session, which may save a slow network
+    // round trip. It's used on the same terms as a listing cached in memory
+    const DIR_CACHE_TYPE cacheType = pDirectory->GetCacheType(url);
+    const bool persist = !(hints.flags & DIR_FLAG_BYPASS_CACHE) && cacheType != DIR_CACHE_NEVER;
+    if (!cached && persist &&
+        (cacheType == DIR_CACHE_ALWAYS || (cacheType == DIR_CACHE_ONCE && readCache)) &&
+        g_directoryCache.GetPersistentDirectory(realURL, items))
+    {
+      g_directoryCache.SetDirectory(realURL.Get(), items, cacheType);
+      cached = true;
+    }
+
+    if (cached)
       items.SetURL(url);
     else
     {
@@ -179,6 +194,12 @@ bool CDirectory::GetDirectory(const CURL& url,
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.ClearDirectory(realURL.Get());
 
+      // validate the directory before listing it, a change while it's listed then isn't taken for
+      // part of the stored listing
+      std::string validator;
+      if (persist)
+        validator = g_directoryCache.GetPersistentValidator(realURL);
+
       pDirectory->SetFlags(hints.flags);
 
       bool result = false, cancel = false;
@@ -253,7 +274,11 @@ bool CDirectory::GetDirectory(const CURL& url,
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
-        g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+      {
+        g_directoryCache.SetDirectory(realURL.Get(), items, cacheType);
+        if (!validator.empty())
+          g_directoryCache.SetPersistentDirectory(realURL, validator, items);
+      }
     }
 
     // now filter for allowed files
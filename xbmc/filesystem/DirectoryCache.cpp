@@ -10,8 +10,13 @@
 
 #include "Directory.h"
 #include "FileItem.h"
+#include "PersistentDirectoryCache.h"
+#include "ServiceBroker.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/Metrics.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -56,6 +61,9 @@ CDirectoryCache::~CDirectoryCache(void) = default;
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
+  static std::atomic<uint64_t>& hits = CMetrics::GetInstance().GetCounter("dircache.hits");
+  static std::atomic<uint64_t>& misses = CMetrics::GetInstance().GetCounter("dircache.misses");
+
   CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
@@ -74,9 +82,11 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
 #ifdef _DEBUG
       m_cacheHits+=items.Size();
 #endif
+      hits++;
       return true;
     }
   }
+  misses++;
   return false;
 }
 
@@ -119,6 +129,13 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
   URIUtils::RemoveSlashAtEnd(strFile2);
 
   ClearDirectory(URIUtils::GetDirectory(strFile2));
+
+  // we changed the directory ourselves, don't rely on the validation to notice
+  const CURL url(URIUtils::GetDirectory(strFile2));
+  unsigned int trustPeriod;
+  CPersistentDirectoryCache* persistentCache = GetPersistentCache(url, trustPeriod);
+  if (persistentCache)
+    persistentCache->ClearDirectory(url);
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
@@ -171,6 +188,9 @@ void CDirectoryCache::AddFile(const std::string& strFile)
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
+  static std::atomic<uint64_t>& hits = CMetrics::GetInstance().GetCounter("dircache.exists.hits");
+  static std::atomic<uint64_t>& misses = CMetrics::GetInstance().GetCounter("dircache.exists.misses");
+
   CSingleLock lock (m_cs);
   bInCache = false;
 
@@ -189,11 +209,13 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 #ifdef _DEBUG
     m_cacheHits++;
 #endif
+    hits++;
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
 #ifdef _DEBUG
   m_cacheMisses++;
 #endif
+  misses++;
   return false;
 }
 
@@ -207,6 +229,80 @@ void CDirectoryCache::Clear()
     Delete(i++);
 }
 
+bool CDirectoryCache::GetPersistentDirectory(const CURL& url, CFileItemList &items)
+{
+  unsigned int trustPeriod;
+  CPersistentDirectoryCache* persistentCache = GetPersistentCache(url, trustPeriod);
+  if (!persistentCache)
+    return false;
+
+  static std::atomic<uint64_t>& hits = CMetrics::GetInstance().GetCounter("dircache.persistent.hits");
+  static std::atomic<uint64_t>& misses = CMetrics::GetInstance().GetCounter("dircache.persistent.misses");
+  if (!persistentCache->GetDirectory(url, trustPeriod, items))
+  {
+    misses++;
+    return false;
+  }
+  hits++;
+
+  CLog::Log(LOGDEBUG, "%s - using persisted listing of %s", __FUNCTION__, url.GetRedacted().c_str());
+  return true;
+}
+
+std::string CDirectoryCache::GetPersistentValidator(const CURL& url)
+{
+  // explicit credentials may end up in the item paths
+  if (!url.GetUserName().empty() || !url.GetPassWord().empty())
+    return "";
+
+  unsigned int trustPeriod;
+  if (!GetPersistentCache(url, trustPeriod))
+    return "";
+  return CPersistentDirectoryCache::GetValidator(url);
+}
+
+void CDirectoryCache::SetPersistentDirectory(const CURL& url,
+                                             const std::string& validator,
+                                             CFileItemList &items)
+{
+  // explicit credentials may have ended up in the item paths
+  if (!url.GetUserName().empty() || !url.GetPassWord().empty())
+    return;
+
+  unsigned int trustPeriod;
+  CPersistentDirectoryCache* persistentCache = GetPersistentCache(url, trustPeriod);
+  if (persistentCache)
+    persistentCache->SetDirectory(url, validator, items);
+}
+
+CPersistentDirectoryCache* CDirectoryCache::GetPersistentCache(const CURL& url, unsigned int& trustPeriod)
+{
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (!settingsComponent)
+    return nullptr;
+  const auto advancedSettings = settingsComponent->GetAdvancedSettings();
+  if (!advancedSettings || !advancedSettings->m_dirCachePersistent)
+    return nullptr;
+
+  const auto policy = advancedSettings->m_dirCacheProtocols.find(url.GetTranslatedProtocol());
+  if (policy == advancedSettings->m_dirCacheProtocols.end())
+    return nullptr;
+  trustPeriod = policy->second;
+
+  CPersistentDirectoryCache* persistentCache;
+  {
+    CSingleLock lock(m_cs);
+    if (!m_persistentCache)
+      m_persistentCache.reset(new CPersistentDirectoryCache("special://temp/dircache/"));
+    persistentCache = m_persistentCache.get();
+  }
+
+  // the persistent cache deletes files while holding its own lock, which ends up in
+  // ClearFile(), so never call into it while holding ours
+  persistentCache->SetMaxSize(static_cast<uint64_t>(advancedSettings->m_dirCacheMaxSize) * 1024 * 1024);
+  return persistentCache;
+}
+
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 {
   for (const std::string& strDir : dirs)
@@ -12,12 +12,16 @@
 #include "threads/CriticalSection.h"
 
 #include <map>
+#include <memory>
 #include <set>
 
 class CFileItem;
+class CURL;
 
 namespace XFILE
 {
+  class CPersistentDirectoryCache;
+
   class CDirectoryCache
   {
     class CDir
@@ -47,6 +51,21 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*!
+     \brief Get a listing persisted by this or an earlier session.
+     Only used for protocols enabled in the <dircache> advanced settings, and only while the
+     directory is unchanged since the listing was stored.
+     \return true if a valid listing was found.
+     */
+    bool GetPersistentDirectory(const CURL& url, CFileItemList &items);
+
+    /*!
+     \brief Get the validator to persist a listing with, taken before the directory is listed.
+     \return the validator, empty if listings of the directory aren't persisted.
+     */
+    std::string GetPersistentValidator(const CURL& url);
+    void SetPersistentDirectory(const CURL& url, const std::string& validator, CFileItemList &items);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -54,6 +73,7 @@ namespace XFILE
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
+    CPersistentDirectoryCache* GetPersistentCache(const CURL& url, unsigned int& trustPeriod);
 
     std::map<std::string, CDir*> m_cache;
     typedef std::map<std::string, CDir*>::iterator iCache;
@@ -64,6 +84,8 @@ namespace XFILE
 
     unsigned int m_accessCounter;
 
+    std::unique_ptr<CPersistentDirectoryCache> m_persistentCache;
+
 #ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
@@ -14,10 +14,13 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "SparseCache.h"
 #include "threads/SingleLock.h"
+#include "utils/Metrics.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/TimeUtils.h"
 
 #if !defined(TARGET_WINDOWS)
 #include "platform/posix/ConvUtils.h"
@@ -34,6 +37,14 @@
 
 using namespace XFILE;
 
+namespace
+{
+uint64_t MicrosecondsSince(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
+}
+
 class CWriteRate
 {
 public:
@@ -116,6 +127,11 @@ bool CFileCache::Open(const CURL& url)
 
   m_sourcePath = url.GetRedacted();
 
+  // throughput and latency of the sources are kept per protocol
+  const std::string protocol = url.GetProtocol().empty() ? "file" : url.GetProtocol();
+  m_sourceBytes = &CMetrics::GetInstance().GetCounter("filecache.bytes." + protocol);
+  m_sourceLatency = &CMetrics::GetInstance().GetHistogram("filecache.read." + protocol);
+
   CLog::Log(LOGDEBUG,"{} - <{}> opening", __FUNCTION__, m_sourcePath);
 
   // opening the source file.
@@ -134,6 +150,10 @@ bool CFileCache::Open(const CURL& url)
   // check if source can seek
   m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
 
+  const bool prefetch = (m_flags & READ_PREFETCH) != 0;
+  if (prefetch)
+    m_source.IoControl(IOCTRL_HINT_SEQUENTIAL, nullptr);
+
   // Determine the best chunk size we can use
   m_chunkSize = CFile::DetermineChunkSize(
       m_source.GetChunkSize(),
@@ -145,7 +165,17 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
+    // a prefetching cache holds a window of its own in memory
+    const unsigned int memorySize =
+        prefetch ? CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLocalReadAhead
+                 : CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize;
+
+    // the sparse cache relies on seeking the source to the end of the range it continues
+    const bool sparse = !prefetch && memorySize != 0 &&
+                        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheSparse &&
+                        m_seekPossible != 0;
+
+    if (memorySize == 0)
     {
       // Use cache on disk
       m_pCache = std::unique_ptr<CSimpleFileCache>(new CSimpleFileCache()); // C++14 - Replace with std::make_unique
@@ -154,7 +184,7 @@ bool CFileCache::Open(const CURL& url)
     else
     {
       size_t cacheSize;
-      if (m_fileSize > 0 && m_fileSize < CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize && !(m_flags & READ_AUDIO_VIDEO))
+      if (m_fileSize > 0 && m_fileSize < memorySize && !(m_flags & READ_AUDIO_VIDEO))
       {
         // Cap cache size by filesize, but not for audio/video files as those may grow.
         // We don't need to take into account READ_MULTI_STREAM here as that's only used for audio/video
@@ -166,10 +196,10 @@ bool CFileCache::Open(const CURL& url)
       }
       else
       {
-        cacheSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize;
+        cacheSize = memorySize;
 
         // NOTE: READ_MULTI_STREAM is only used with READ_AUDIO_VIDEO
-        if (m_flags & READ_MULTI_STREAM)
+        if ((m_flags & READ_MULTI_STREAM) && !sparse)
         {
           // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
           cacheSize /= 2;
@@ -180,21 +210,38 @@ bool CFileCache::Open(const CURL& url)
           cacheSize = m_chunkSize * 2;
       }
 
-      if (m_flags & READ_MULTI_STREAM)
-        CLog::Log(LOGDEBUG, "{} - <{}> using double memory cache each sized {} bytes",
+      if (sparse)
+      {
+        CLog::Log(LOGDEBUG, "{} - <{}> using sparse memory cache sized {} bytes",
                   __FUNCTION__, m_sourcePath, cacheSize);
+
+        // leave part of the memory for the ranges we're not reading from
+        const size_t back = cacheSize / 4;
+        const size_t front = cacheSize / 2;
+        const uint64_t spillSize = static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheSpillSize) * 1024 * 1024;
+
+        m_pCache = std::unique_ptr<CSparseCache>(new CSparseCache(front, back, cacheSize, spillSize)); // C++14 - Replace with std::make_unique
+        m_forwardCacheSize = front;
+      }
       else
-        CLog::Log(LOGDEBUG, "{} - <{}> using single memory cache sized {} bytes",
-                  __FUNCTION__, m_sourcePath, cacheSize);
+      {
+        if (m_flags & READ_MULTI_STREAM)
+          CLog::Log(LOGDEBUG, "{} - <{}> using double memory cache each sized {} bytes",
+                    __FUNCTION__, m_sourcePath, cacheSize);
+        else
+          CLog::Log(LOGDEBUG, "{} - <{}> using single memory cache sized {} bytes",
+                    __FUNCTION__, m_sourcePath, cacheSize);
 
-      const size_t back = cacheSize / 4;
-      const size_t front = cacheSize - back;
+        const size_t back = cacheSize / 4;
+        const size_t front = cacheSize - back;
 
-      m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
-      m_forwardCacheSize = front;
+        m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
+        m_forwardCacheSize = front;
+      }
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    // a sparse cache keeps the ranges of all streams by itself
+    if ((m_flags & READ_MULTI_STREAM) && !sparse)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = std::unique_ptr<CDoubleCache>(new CDoubleCache(m_pCache.release())); // C++14 - Replace with std::make_unique
@@ -218,6 +265,12 @@ bool CFileCache::Open(const CURL& url)
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
+  if (prefetch)
+  {
+    SReadAhead range = {0, m_forwardCacheSize};
+    m_source.IoControl(IOCTRL_READ_AHEAD, &range);
+  }
+
   CThread::Create(false);
 
   return true;
@@ -242,6 +295,9 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
 
+  // the window of a prefetching cache is all that limits how far it reads ahead
+  const bool prefetch = (m_flags & READ_PREFETCH) != 0;
+
   while (!m_bStop)
   {
     // Update filesize
@@ -281,13 +337,19 @@ void CFileCache::Process()
                     __FUNCTION__, m_sourcePath, m_seekPos);
           m_bFilling = true;
           m_bLowSpeedDetected = false;
+
+          if (prefetch)
+          {
+            SReadAhead range = {cacheMaxPos, m_forwardCacheSize};
+            m_source.IoControl(IOCTRL_READ_AHEAD, &range);
+          }
         }
       }
 
       m_seekEnded.Set();
     }
 
-    while (m_writeRate)
+    while (m_writeRate && !prefetch)
     {
       if (m_writePos - m_readPos < m_writeRate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor)
       {
@@ -324,7 +386,15 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (maxSourceRead > 0)
+    {
+      const int64_t start = CurrentHostCounter();
       iRead = m_source.Read(buffer.get(), maxSourceRead);
+      const uint64_t latency = MicrosecondsSince(start);
+      m_readLatency.Add(latency);
+      m_sourceLatency->Add(latency);
+      if (iRead > 0)
+        *m_sourceBytes += iRead;
+    }
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -405,6 +475,10 @@ void CFileCache::Process()
 
       iTotalWrite += iWrite;
 
+      // the cache joined what we wrote with data it already had, which makes the rest of the buffer stale
+      if (m_pCache->CachedDataEndPos() != m_writePos + iTotalWrite)
+        break;
+
       // check if seek was asked. otherwise if cache is full we'll freeze.
       if (m_seekEvent.WaitMSec(0))
       {
@@ -416,6 +490,26 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // continue fetching after the data that is already cached
+    const int64_t cacheEndPos = m_pCache->CachedDataEndPos();
+    if (cacheEndPos != m_writePos && !m_bStop)
+    {
+      if (m_fileSize == 0 || cacheEndPos < m_fileSize)
+      {
+        const int64_t seekResult = m_source.Seek(cacheEndPos, SEEK_SET);
+        if (seekResult != cacheEndPos)
+        {
+          CLog::Log(LOGERROR, "{} - <{}> error {} seeking past cached data. Seek returned {}",
+                    __FUNCTION__, m_sourcePath, GetLastError(), seekResult);
+          m_pCache->EndOfInput();
+          break; // while (!m_bStop)
+        }
+      }
+      m_writePos = cacheEndPos;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
@@ -491,7 +585,7 @@ retry:
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
     // just wait for some data to show up
-    iRc = m_pCache->WaitForData(1, 10000);
+    iRc = WaitForRefill();
     if (iRc > 0)
       goto retry;
   }
@@ -510,6 +604,19 @@ retry:
   return -1;
 }
 
+int64_t CFileCache::WaitForRefill()
+{
+  static std::atomic<uint64_t>& underruns = CMetrics::GetInstance().GetCounter("filecache.underruns");
+  static CLatencyHistogram& refill = CMetrics::GetInstance().GetHistogram("filecache.refill");
+
+  // the reader caught up with the source
+  underruns++;
+  const int64_t start = CurrentHostCounter();
+  const int64_t available = m_pCache->WaitForData(1, 10000);
+  refill.Add(MicrosecondsSince(start));
+  return available;
+}
+
 int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
 {
   CSingleLock lock(m_sync);
@@ -532,8 +639,13 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  static std::atomic<uint64_t>& cachedSeeks = CMetrics::GetInstance().GetCounter("filecache.seeks.cached");
+  static std::atomic<uint64_t>& sourceSeeks = CMetrics::GetInstance().GetCounter("filecache.seeks.source");
+
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
+    sourceSeeks++;
+
     if (m_seekPossible == 0)
       return m_nSeekResult;
 
@@ -563,7 +675,10 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     m_seekEvent.Reset();
   }
   else
+  {
+    cachedSeeks++;
     m_readPos = iTarget;
+  }
 
   return iTarget;
 }
@@ -576,6 +691,13 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  if (m_readLatency.GetCount() > 0)
+  {
+    CLog::Log(LOGDEBUG, "{} - <{}> {}", __FUNCTION__, m_sourcePath,
+              m_readLatency.ToString("source reads"));
+    m_readLatency.Reset();
+  }
+
   m_source.Close();
 }
 
@@ -614,6 +736,7 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
+    m_pCache->GetCachedRanges(status->ranges);
     m_bLowSpeedDetected = false; // Reset flag
     return 0;
   }
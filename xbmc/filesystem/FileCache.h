@@ -13,6 +13,7 @@
 #include "IFile.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
+#include "utils/LatencyHistogram.h"
 
 #include <atomic>
 #include <memory>
@@ -55,6 +56,8 @@ namespace XFILE
     }
 
   private:
+    int64_t WaitForRefill();
+
     std::unique_ptr<CCacheStrategy> m_pCache;
     int m_seekPossible;
     CFile m_source;
@@ -73,6 +76,9 @@ namespace XFILE
     bool m_bLowSpeedDetected;
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
+    CLatencyHistogram m_readLatency; ///< duration of the reads from the source
+    std::atomic<uint64_t>* m_sourceBytes = nullptr; ///< metrics of the protocol of the source
+    CLatencyHistogram* m_sourceLatency = nullptr;
     CCriticalSection m_sync;
   };
 
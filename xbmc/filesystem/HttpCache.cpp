@@ -0,0 +1,422 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HttpCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "XBDateTime.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/HttpHeader.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utility>
+#include <vector>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+#define HTTPCACHE_DIRECTORY "special://temp/httpcache/"
+#define HTTPCACHE_EXTENSION ".http"
+#define HTTPCACHE_MAGIC "KODI-HTTPCACHE 1"
+// a single response may take up this part of the cache
+#define HTTPCACHE_ENTRY_FRACTION 8
+
+namespace
+{
+// fields of a 304 answer that replace the stored ones
+const char* const UPDATED_HEADERS[] = {"cache-control", "date", "etag", "expires", "last-modified"};
+
+int64_t GetNow()
+{
+  return static_cast<int64_t>(time(nullptr));
+}
+} // unnamed namespace
+
+CHttpCache& CHttpCache::GetInstance()
+{
+  static CHttpCache cache;
+  return cache;
+}
+
+void CHttpCache::Configure(const std::string& directory, uint64_t maxSize)
+{
+  CSingleLock lock(m_section);
+  m_configured = true;
+  m_directory = directory;
+  URIUtils::AddSlashAtEnd(m_directory);
+  m_maxSize = maxSize;
+  m_size = 0;
+  m_index.clear();
+
+  if (m_maxSize == 0)
+    return;
+
+  if (!CDirectory::Exists(m_directory) && !CDirectory::Create(m_directory))
+  {
+    CLog::Log(LOGERROR, "CHttpCache::Configure - unable to create %s, cache disabled",
+              m_directory.c_str());
+    m_maxSize = 0;
+    return;
+  }
+
+  // pick up what was stored before, the oldest files are the first to go
+  CFileItemList items;
+  CDirectory::GetDirectory(m_directory, items, HTTPCACHE_EXTENSION,
+                           DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  std::vector<std::pair<CDateTime, CFileItemPtr>> files;
+  for (const auto& item : items)
+  {
+    if (!item->m_bIsFolder)
+      files.emplace_back(item->m_dateTime, item);
+  }
+  std::sort(files.begin(), files.end(),
+            [](const std::pair<CDateTime, CFileItemPtr>& a,
+               const std::pair<CDateTime, CFileItemPtr>& b) { return a.first < b.first; });
+
+  for (const auto& file : files)
+  {
+    const uint64_t size = static_cast<uint64_t>(file.second->m_dwSize);
+    m_index[URIUtils::GetFileName(file.second->GetPath())] = {size, ++m_useCounter};
+    m_size += size;
+  }
+  for (const auto& fileName : Evict())
+    CFile::Delete(m_directory + fileName);
+
+  CLog::Log(LOGDEBUG, "CHttpCache::Configure - %zu responses, %" PRIu64 " of %" PRIu64 " bytes",
+            m_index.size(), m_size, m_maxSize);
+}
+
+bool CHttpCache::IsEnabled()
+{
+  CSingleLock lock(m_section);
+  if (!m_configured)
+  {
+    const int size = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_httpCacheSize;
+    Configure(HTTPCACHE_DIRECTORY, static_cast<uint64_t>(size) * 1024 * 1024);
+  }
+  return m_maxSize > 0;
+}
+
+std::string CHttpCache::GetKey(const std::string& url,
+                               const std::map<std::string, std::string>& requestHeaders)
+{
+  // any of them may be named by Vary or pick the user the response is for (api keys), so
+  // requests only share a response if they agree on all of them
+  std::map<std::string, std::string> headers;
+  for (const auto& header : requestHeaders)
+  {
+    std::string name = header.first;
+    StringUtils::ToLower(name);
+    headers[name] = header.second;
+  }
+
+  std::string key(url);
+  for (const auto& header : headers)
+    key += "\n" + header.first + ": " + header.second;
+  return key;
+}
+
+std::string CHttpCache::GetFileName(const std::string& key)
+{
+  return CDigest::Calculate(CDigest::Type::MD5, key) + HTTPCACHE_EXTENSION;
+}
+
+int64_t CHttpCache::GetLifetime(const CHttpHeader& header)
+{
+  if (header.GetValue("vary") == "*")
+    return -1;
+
+  int64_t lifetime = -1;
+  for (std::string directive : StringUtils::Split(header.GetValue("cache-control"), ","))
+  {
+    StringUtils::Trim(directive);
+    StringUtils::ToLower(directive);
+    if (directive == "no-store")
+      return -1;
+    // no-cache with a list of fields only restricts those fields
+    else if (directive == "no-cache")
+      lifetime = 0;
+    else if (StringUtils::StartsWith(directive, "max-age=") && lifetime != 0)
+      lifetime = std::max(0ll, atoll(directive.c_str() + 8));
+  }
+
+  if (lifetime < 0)
+  {
+    // relative to the date of the server, to not depend on the clocks to match
+    lifetime = 0;
+    const std::string expires = header.GetValue("expires");
+    if (!expires.empty())
+    {
+      const CDateTime expiry = CDateTime::FromRFC1123DateTime(expires);
+      const std::string dateValue = header.GetValue("date");
+      const CDateTime date =
+          dateValue.empty() ? CDateTime::GetUTCDateTime() : CDateTime::FromRFC1123DateTime(dateValue);
+      if (expiry.IsValid() && date.IsValid() && expiry > date)
+        lifetime = (expiry - date).GetSecondsTotal();
+    }
+  }
+
+  return lifetime;
+}
+
+CHttpCache::LookupResult CHttpCache::Lookup(const std::string& key, CEntry& entry)
+{
+  const std::string fileName = GetFileName(key);
+  std::string directory;
+  {
+    CSingleLock lock(m_section);
+    if (m_index.find(fileName) == m_index.end())
+    {
+      m_stats.misses++;
+      return LookupResult::MISS;
+    }
+    directory = m_directory;
+  }
+
+  // the file is read unlocked, a response replaced meanwhile is either read whole or not found
+  const bool found = ReadEntry(directory + fileName, key, entry);
+
+  CSingleLock lock(m_section);
+  const auto it = m_index.find(fileName);
+  if (!found || it == m_index.end())
+  {
+    m_stats.misses++;
+    return LookupResult::MISS;
+  }
+
+  it->second.lastUse = ++m_useCounter;
+  if (entry.expires > GetNow())
+  {
+    m_stats.hits++;
+    return LookupResult::FRESH;
+  }
+
+  if (entry.etag.empty() && entry.lastModified.empty())
+  {
+    m_stats.misses++;
+    return LookupResult::MISS;
+  }
+
+  m_stats.revalidations++;
+  return LookupResult::STALE;
+}
+
+bool CHttpCache::ReadEntry(const std::string& path, const std::string& key, CEntry& entry)
+{
+  auto_buffer buffer;
+  CFile file;
+  if (file.LoadFile(path, buffer) <= 0)
+    return false;
+
+  const char* data = buffer.get();
+  const char* end = data + buffer.size();
+  const char* newline = static_cast<const char*>(memchr(data, '\n', buffer.size()));
+  if (!newline)
+    return false;
+
+  const std::string magic(data, newline - data);
+  size_t keyLength, headerLength;
+  long long expires;
+  if (sscanf(magic.c_str(), HTTPCACHE_MAGIC " %zu %zu %lld", &keyLength, &headerLength,
+             &expires) != 3)
+    return false;
+
+  data = newline + 1;
+  if (static_cast<size_t>(end - data) < keyLength + headerLength ||
+      key.compare(0, std::string::npos, data, keyLength) != 0)
+    return false;
+
+  data += keyLength;
+  entry.header.assign(data, headerLength);
+  data += headerLength;
+  entry.body.assign(data, end - data);
+  entry.expires = expires;
+
+  CHttpHeader header;
+  header.Parse(entry.header);
+  entry.etag = header.GetValue("etag");
+  entry.lastModified = header.GetValue("last-modified");
+  return true;
+}
+
+void CHttpCache::Store(const std::string& key, const CHttpHeader& header, const std::string& body)
+{
+  std::string directory;
+  uint64_t maxSize;
+  unsigned int tempFile;
+  {
+    CSingleLock lock(m_section);
+    directory = m_directory;
+    maxSize = m_maxSize;
+    tempFile = ++m_tempFiles;
+  }
+  if (maxSize == 0)
+    return;
+
+  const std::string fileName = GetFileName(key);
+  const int64_t lifetime = GetLifetime(header);
+  const bool validator = !header.GetValue("etag").empty() || !header.GetValue("last-modified").empty();
+  if (lifetime < 0 || (lifetime == 0 && !validator))
+  {
+    RemoveFile(fileName);
+    return;
+  }
+
+  const std::string headerData = header.GetHeader();
+  std::string data = StringUtils::Format("%s %zu %zu %" PRId64 "\n", HTTPCACHE_MAGIC, key.size(),
+                                         headerData.size(), GetNow() + lifetime);
+  data += key;
+  data += headerData;
+  data += body;
+  if (data.size() > maxSize / HTTPCACHE_ENTRY_FRACTION)
+  {
+    RemoveFile(fileName);
+    return;
+  }
+
+  // write next to the entry first, a half written file must not be found. Responses are written
+  // unlocked, so each write has a file of its own
+  const std::string path = directory + fileName;
+  const std::string tempPath = StringUtils::Format("%s.%u.tmp", path.c_str(), tempFile);
+  CFile file;
+  if (!file.OpenForWrite(tempPath, true) ||
+      file.Write(data.c_str(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    file.Close();
+    CFile::Delete(tempPath);
+    RemoveFile(fileName);
+    return;
+  }
+  file.Close();
+
+  RemoveFile(fileName);
+  if (!CFile::Rename(tempPath, path))
+  {
+    CFile::Delete(tempPath);
+    return;
+  }
+
+  std::vector<std::string> evicted;
+  {
+    CSingleLock lock(m_section);
+    // the same response may have been stored meanwhile, its file was replaced by this one
+    const auto it = m_index.find(fileName);
+    if (it != m_index.end())
+      m_size -= it->second.size;
+    m_index[fileName] = {data.size(), ++m_useCounter};
+    m_size += data.size();
+    m_stats.stores++;
+    evicted = Evict();
+  }
+
+  for (const auto& evictedFile : evicted)
+    CFile::Delete(directory + evictedFile);
+}
+
+void CHttpCache::Revalidated(const std::string& key, const CHttpHeader& header, CEntry& entry)
+{
+  CHttpHeader stored;
+  stored.Parse(entry.header);
+  for (const char* name : UPDATED_HEADERS)
+  {
+    const std::string value = header.GetValue(name);
+    if (!value.empty())
+      stored.AddParam(name, value, true);
+  }
+
+  Store(key, stored, entry.body);
+
+  CSingleLock lock(m_section);
+  m_stats.notModified++;
+  entry.header = stored.GetHeader();
+  entry.etag = stored.GetValue("etag");
+  entry.lastModified = stored.GetValue("last-modified");
+}
+
+void CHttpCache::Remove(const std::string& key)
+{
+  RemoveFile(GetFileName(key));
+}
+
+void CHttpCache::RemoveFile(const std::string& fileName)
+{
+  std::string directory;
+  {
+    CSingleLock lock(m_section);
+    const auto it = m_index.find(fileName);
+    if (it == m_index.end())
+      return;
+
+    m_size -= it->second.size;
+    m_index.erase(it);
+    directory = m_directory;
+  }
+
+  CFile::Delete(directory + fileName);
+}
+
+std::vector<std::string> CHttpCache::Evict()
+{
+  std::vector<std::string> evicted;
+  while (m_size > m_maxSize && !m_index.empty())
+  {
+    const auto oldest = std::min_element(
+        m_index.begin(), m_index.end(),
+        [](const std::pair<const std::string, SIndexEntry>& a,
+           const std::pair<const std::string, SIndexEntry>& b) {
+          return a.second.lastUse < b.second.lastUse;
+        });
+    evicted.push_back(oldest->first);
+    m_size -= oldest->second.size;
+    m_index.erase(oldest);
+    m_stats.evictions++;
+  }
+  return evicted;
+}
+
+void CHttpCache::Clear()
+{
+  std::vector<std::string> files;
+  std::string directory;
+  {
+    CSingleLock lock(m_section);
+    files.reserve(m_index.size());
+    for (const auto& entry : m_index)
+      files.push_back(entry.first);
+    m_index.clear();
+    m_size = 0;
+    m_stats = {};
+    directory = m_directory;
+  }
+
+  for (const auto& fileName : files)
+    CFile::Delete(directory + fileName);
+}
+
+CHttpCache::Stats CHttpCache::GetStats() const
+{
+  CSingleLock lock(m_section);
+  Stats stats = m_stats;
+  stats.size = m_size;
+  stats.entries = m_index.size();
+  return stats;
+}
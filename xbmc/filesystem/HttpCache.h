@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CHttpHeader;
+
+namespace XFILE
+{
+
+/*!
+ \brief On-disk cache of http responses fetched in full by CCurlFile::Get().
+
+ A response is kept if it allows it (status 200, no "Cache-Control: no-store", no
+ "Vary: *") and has a freshness lifetime (Cache-Control max-age or Expires) or a
+ validator (ETag or Last-Modified). A fresh response is served without a request. A stale
+ response is revalidated with If-None-Match/If-Modified-Since and served again when the
+ server answers 304. The cache is limited in size and drops the least recently used
+ responses first.
+
+ The cache is off unless advancedsettings.xml sets <network><httpcachesize> (MiB).
+ */
+class CHttpCache
+{
+public:
+  enum class LookupResult
+  {
+    MISS,  ///< not cached, or can't be revalidated
+    FRESH, ///< can be used as it is
+    STALE, ///< has to be revalidated before use
+  };
+
+  struct CEntry
+  {
+    std::string header; ///< the response header as stored
+    std::string body;
+    std::string etag;
+    std::string lastModified;
+    int64_t expires = 0; ///< time the response stops being fresh
+  };
+
+  struct Stats
+  {
+    uint64_t hits;          ///< served from the cache without a request
+    uint64_t misses;        ///< had to be fetched
+    uint64_t revalidations; ///< stale responses that were revalidated
+    uint64_t notModified;   ///< of which the server answered 304
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t size;          ///< bytes held by all responses
+    size_t entries;
+  };
+
+  static CHttpCache& GetInstance();
+
+  /*!
+   \brief Use the given directory, dropping responses until the cache fits into maxSize.
+   \param directory where to keep the responses, created if needed.
+   \param maxSize size of the cache in bytes, 0 to disable it.
+   */
+  void Configure(const std::string& directory, uint64_t maxSize);
+
+  /*!
+   \brief Whether the cache is in use, configures it from the advanced settings on first call.
+   */
+  bool IsEnabled();
+
+  /*!
+   \brief Get the key of a request, made of its URL and all request headers set by the caller.
+   Header names are compared without case. Requests with credentials or cookies aren't cached.
+   */
+  static std::string GetKey(const std::string& url,
+                            const std::map<std::string, std::string>& requestHeaders);
+
+  LookupResult Lookup(const std::string& key, CEntry& entry);
+
+  /*!
+   \brief Store a response, or drop the stored one if the response can't be cached.
+   \param header the response header, its caching fields decide whether and how long the
+   response is kept.
+   */
+  void Store(const std::string& key, const CHttpHeader& header, const std::string& body);
+
+  /*!
+   \brief Update a stale response with the header of a 304 answer and keep it.
+   \param entry the stale response, updated to what is stored now.
+   */
+  void Revalidated(const std::string& key, const CHttpHeader& header, CEntry& entry);
+
+  void Remove(const std::string& key);
+  void Clear();
+
+  Stats GetStats() const;
+
+  /*!
+   \brief Get how long a response may be used without revalidation.
+   \return lifetime in seconds, -1 if the response must not be stored.
+   */
+  static int64_t GetLifetime(const CHttpHeader& header);
+
+private:
+  CHttpCache() = default;
+  CHttpCache(const CHttpCache&) = delete;
+  CHttpCache& operator=(const CHttpCache&) = delete;
+
+  struct SIndexEntry
+  {
+    uint64_t size;
+    uint64_t lastUse;
+  };
+
+  static std::string GetFileName(const std::string& key);
+  static bool ReadEntry(const std::string& path, const std::string& key, CEntry& entry);
+
+  /*!
+   \brief Drop a response from the index, and then delete its file.
+   */
+  void RemoveFile(const std::string& fileName);
+
+  /*!
+   \brief Drop the least recently used responses from the index until the cache fits.
+   \return the files of the dropped responses, to be deleted once the lock is released.
+   */
+  std::vector<std::string> Evict();
+
+  mutable CCriticalSection m_section;
+  bool m_configured = false;
+  std::string m_directory;
+  uint64_t m_maxSize = 0;
+  uint64_t m_size = 0;
+  uint64_t m_useCounter = 0;
+  unsigned int m_tempFiles = 0; ///< to give each write its own temporary file
+  std::map<std::string, SIndexEntry> m_index; ///< by file name
+  Stats m_stats = {};
+};
+
+} // namespace XFILE
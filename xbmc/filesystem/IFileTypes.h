@@ -9,6 +9,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 namespace XFILE
 {
@@ -40,18 +42,28 @@ namespace XFILE
 /* indicate that caller want to reopen a file if its already open  */
   static const unsigned int READ_REOPEN = 0x100;
 
+/* read ahead of the caller in a window of its own, for local files that aren't cached otherwise. used with READ_CACHED */
+  static const unsigned int READ_PREFETCH = 0x200;
+
 struct SNativeIoControl
 {
   unsigned long int   request;
   void*               param;
 };
 
+struct SReadAhead
+{
+  int64_t offset; /**< start of the data that will be read soon */
+  int64_t length; /**< number of bytes that will be read soon */
+};
+
 struct SCacheStatus
 {
   uint64_t forward;  /**< number of bytes cached forward of current position */
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  std::vector<std::pair<int64_t, int64_t>> ranges; /**< start and end (exclusive) of each cached byte range */
 };
 
 typedef enum {
@@ -61,6 +73,8 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_HINT_SEQUENTIAL = 32, /**< the file will be read from start to end, no parameter */
+  IOCTRL_READ_AHEAD    = 64, /**< SReadAhead structure, start reading the given range in the background */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,259 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentDirectoryCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <ctime>
+#include <stdexcept>
+#include <vector>
+
+// bump when the layout of the stored listings changes
+#define CACHE_VERSION 1
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+CPersistentDirectoryCache::CPersistentDirectoryCache(const std::string& cachePath)
+  : m_cachePath(cachePath)
+{
+  URIUtils::AddSlashAtEnd(m_cachePath);
+}
+
+bool CPersistentDirectoryCache::GetDirectory(const CURL& url, unsigned int trustPeriod, CFileItemList& items)
+{
+  const std::string key = GetKey(url);
+  const std::string cacheName = GetCacheName(key);
+  const std::string cacheFile = m_cachePath + cacheName;
+  {
+    CSingleLock lock(m_cs);
+    LoadIndex();
+    if (m_index.find(cacheName) == m_index.end())
+      return false;
+  }
+
+  // the network is only touched for the validation, and not at all during the trust period
+  bool valid = false;
+  CFile file;
+  if (file.Open(cacheFile))
+  {
+    try
+    {
+      CArchive ar(&file, CArchive::load);
+      int version;
+      std::string path, validator;
+      long long stored;
+      ar >> version;
+      if (version == CACHE_VERSION)
+      {
+        ar >> path;
+        ar >> validator;
+        ar >> stored;
+        if (path == key &&
+            (static_cast<long long>(time(nullptr)) - stored < trustPeriod ||
+             GetValidator(url) == validator))
+        {
+          items.Clear();
+          ar >> items;
+          valid = true;
+        }
+      }
+      ar.Close();
+    }
+    catch (const std::out_of_range&)
+    {
+      CLog::Log(LOGERROR, "CPersistentDirectoryCache: corrupt listing %s", cacheFile.c_str());
+      items.Clear();
+      valid = false;
+    }
+    file.Close();
+  }
+
+  CSingleLock lock(m_cs);
+  if (!valid)
+  {
+    Remove(cacheName);
+    return false;
+  }
+
+  auto it = m_index.find(cacheName);
+  if (it != m_index.end())
+    it->second.lastUse = time(nullptr);
+  return true;
+}
+
+bool CPersistentDirectoryCache::SetDirectory(const CURL& url,
+                                             const std::string& validator,
+                                             CFileItemList& items)
+{
+  if (validator.empty())
+    return false;
+
+  const std::string key = GetKey(url);
+  const std::string cacheName = GetCacheName(key);
+  const std::string cacheFile = m_cachePath + cacheName;
+  {
+    CSingleLock lock(m_cs);
+    LoadIndex();
+  }
+
+  // write to a private file and move it into place, so concurrent readers never see half a listing
+  const std::string tempFile = cacheFile + "." + StringUtils::CreateUUID();
+  uint64_t size = 0;
+  {
+    CFile file;
+    if (!file.OpenForWrite(tempFile, true))
+      return false;
+
+    CArchive ar(&file, CArchive::store);
+    ar << static_cast<int>(CACHE_VERSION);
+    ar << key;
+    ar << validator;
+    ar << static_cast<long long>(time(nullptr));
+    ar << items;
+    ar.Close();
+    size = file.GetPosition();
+    file.Close();
+  }
+
+  CSingleLock lock(m_cs);
+  Remove(cacheName);
+  if (!CFile::Rename(tempFile, cacheFile))
+  {
+    CFile::Delete(tempFile);
+    return false;
+  }
+
+  m_index[cacheName] = {size, static_cast<int64_t>(time(nullptr))};
+  m_size += size;
+  CheckIfFull();
+  return true;
+}
+
+void CPersistentDirectoryCache::ClearDirectory(const CURL& url)
+{
+  CSingleLock lock(m_cs);
+  LoadIndex();
+  Remove(GetCacheName(GetKey(url)));
+}
+
+void CPersistentDirectoryCache::Clear()
+{
+  CSingleLock lock(m_cs);
+  LoadIndex();
+  while (!m_index.empty())
+    Remove(m_index.begin()->first);
+}
+
+void CPersistentDirectoryCache::SetMaxSize(uint64_t maxSize)
+{
+  CSingleLock lock(m_cs);
+  m_maxSize = maxSize;
+  if (m_indexLoaded)
+    CheckIfFull();
+}
+
+std::string CPersistentDirectoryCache::GetValidator(const CURL& url)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(url, &buffer) != 0 || buffer.st_mtime == 0)
+    return "";
+
+  return StringUtils::Format("%lld:%lld", static_cast<long long>(buffer.st_mtime),
+                             static_cast<long long>(buffer.st_size));
+}
+
+std::string CPersistentDirectoryCache::GetKey(const CURL& url)
+{
+  // never keep credentials around in the cache
+  CURL key(url);
+  key.SetOptions("");
+  key.SetProtocolOptions("");
+  std::string path = key.GetWithoutUserDetails();
+  URIUtils::RemoveSlashAtEnd(path);
+  return path;
+}
+
+std::string CPersistentDirectoryCache::GetCacheName(const std::string& key)
+{
+  return CDigest::Calculate(CDigest::Type::MD5, key) + ".fi";
+}
+
+void CPersistentDirectoryCache::LoadIndex()
+{
+  if (m_indexLoaded)
+    return;
+  m_indexLoaded = true;
+
+  if (!CDirectory::Exists(m_cachePath))
+  {
+    CDirectory::Create(m_cachePath);
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(m_cachePath, items, ".fi", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder)
+      continue;
+
+    time_t lastUse = 0;
+    item->m_dateTime.GetAsTime(lastUse);
+    const uint64_t size = static_cast<uint64_t>(item->m_dwSize);
+    m_index[URIUtils::GetFileName(item->GetPath())] = {size, static_cast<int64_t>(lastUse)};
+    m_size += size;
+  }
+  CLog::Log(LOGDEBUG, "CPersistentDirectoryCache: %u listings with %llu bytes in %s",
+            static_cast<unsigned int>(m_index.size()), static_cast<unsigned long long>(m_size),
+            m_cachePath.c_str());
+  CheckIfFull();
+}
+
+void CPersistentDirectoryCache::Remove(const std::string& cacheName)
+{
+  auto it = m_index.find(cacheName);
+  if (it == m_index.end())
+    return;
+
+  m_size -= it->second.size;
+  m_index.erase(it);
+  CFile::Delete(m_cachePath + cacheName);
+}
+
+void CPersistentDirectoryCache::CheckIfFull()
+{
+  if (m_size <= m_maxSize)
+    return;
+
+  // drop the least recently used listings until we're back below 90% of the limit
+  std::vector<std::pair<int64_t, std::string>> entries;
+  entries.reserve(m_index.size());
+  for (const auto& entry : m_index)
+    entries.emplace_back(entry.second.lastUse, entry.first);
+  std::sort(entries.begin(), entries.end());
+
+  const uint64_t target = m_maxSize / 10 * 9;
+  for (const auto& entry : entries)
+  {
+    if (m_size <= target)
+      break;
+    Remove(entry.second);
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+class CFileItemList;
+class CURL;
+
+namespace XFILE
+{
+  /*!
+   \brief On-disk store of directory listings that survives restarts.
+
+   Listings are archived together with a validator of the listed directory (its
+   modification time and size as reported by Stat()). A stored listing is only handed
+   out while the directory still has the same validator, or without revalidation during
+   a trust period chosen by the caller. The least recently used listings are dropped
+   once the store grows beyond its size limit.
+
+   Modification times have a granularity of one second, so a change made in the same
+   second the validator was taken, which leaves the size of the directory as it was, goes
+   unnoticed until the directory changes again. The validator has to be taken before the
+   directory is listed, so at least a change while listing it isn't stored as current.
+   */
+  class CPersistentDirectoryCache
+  {
+  public:
+    explicit CPersistentDirectoryCache(const std::string& cachePath);
+
+    /*!
+     \brief Get the stored listing of a directory.
+     \param url the directory.
+     \param trustPeriod seconds after storing during which the listing is used without revalidation.
+     \param items [out] the stored listing.
+     \return true if a valid listing was found.
+     */
+    bool GetDirectory(const CURL& url, unsigned int trustPeriod, CFileItemList& items);
+
+    /*!
+     \brief Store the listing of a directory, replacing an earlier one.
+     \param validator the validator of the directory, got by GetValidator() before listing it.
+     \return false if the validator is empty or the listing couldn't be written.
+     */
+    bool SetDirectory(const CURL& url, const std::string& validator, CFileItemList& items);
+
+    void ClearDirectory(const CURL& url);
+    void Clear();
+
+    /*!
+     \brief Set the disk space the store may use.
+     \param maxSize size in bytes.
+     */
+    void SetMaxSize(uint64_t maxSize);
+
+    /*!
+     \brief Get the validator of a directory, a Stat() of it.
+     \return the validator, empty if the directory can't be validated.
+     */
+    static std::string GetValidator(const CURL& url);
+
+  private:
+    struct CEntry
+    {
+      uint64_t size;
+      int64_t lastUse;
+    };
+
+    static std::string GetKey(const CURL& url);
+    static std::string GetCacheName(const std::string& key);
+    void LoadIndex();
+    void Remove(const std::string& cacheName);
+    void CheckIfFull();
+
+    std::string m_cachePath;
+    uint64_t m_maxSize = 64 * 1024 * 1024;
+    uint64_t m_size = 0;
+    bool m_indexLoaded = false;
+    std::map<std::string, CEntry> m_index; // stored listings by file name
+    CCriticalSection m_cs;
+  };
+}
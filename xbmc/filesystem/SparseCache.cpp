@@ -0,0 +1,574 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SparseCache.h"
+
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "Util.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+// cached data is kept in blocks of this size, aligned to their position in the file
+#define BLOCK_SIZE (256 * 1024)
+
+using namespace XFILE;
+
+namespace
+{
+int64_t BlockIndex(int64_t pos)
+{
+  return pos / BLOCK_SIZE;
+}
+}
+
+CSparseCache::CSparseCache(size_t front, size_t back, size_t memorySize, uint64_t spillSize)
+  : m_front(front)
+  , m_back(back)
+  , m_memorySize(memorySize)
+  , m_spillSize(spillSize)
+{
+  // the range being read needs its front and back buffer, plus the partially filled blocks at either end
+  m_maxBlocks = std::max(memorySize / BLOCK_SIZE, (front + back) / BLOCK_SIZE + 3);
+  m_maxSlots = static_cast<int64_t>(spillSize / BLOCK_SIZE);
+  Clear(0);
+}
+
+CSparseCache::~CSparseCache()
+{
+  Close();
+}
+
+int CSparseCache::Open()
+{
+  CSingleLock lock(m_sync);
+  Clear(0);
+  return CACHE_RC_OK;
+}
+
+void CSparseCache::Close()
+{
+  CSingleLock lock(m_sync);
+  Clear(0);
+
+  if (m_spillFile)
+  {
+    m_spillFile->Close();
+    if (!m_spillFile->Delete(CURL(m_spillFilename)))
+      CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_spillFilename.c_str());
+    m_spillFile.reset();
+  }
+  m_spillFilename.clear();
+}
+
+size_t CSparseCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  const size_t front = static_cast<size_t>(m_active->end - m_cur);
+  if (front >= m_front)
+    return 0;
+
+  // Never return more than limit and size requested by caller
+  return std::min(iRequestSize, m_front - front);
+}
+
+/**
+ * Appends to the range being read. The write stops at the beginning of the
+ * next range, which is then joined with this one; the caller notices this by
+ * CachedDataEndPos() moving further than the amount written, and is expected
+ * to continue fetching from there.
+ */
+int CSparseCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  const size_t front = static_cast<size_t>(m_active->end - m_cur);
+  if (front >= m_front)
+    return 0;
+
+  // limit by max forward size
+  len = std::min(len, m_front - front);
+
+  // don't write over the range that follows
+  auto next = std::next(m_active);
+  if (next != m_segments.end())
+    len = std::min(len, static_cast<size_t>(next->start - m_active->end));
+
+  size_t written = 0;
+  while (written < len)
+  {
+    CSegment& segment = *m_active;
+    const int64_t block = BlockIndex(segment.end);
+    if (segment.blocks.empty() || block > BlockIndex(segment.start) + static_cast<int64_t>(segment.blocks.size()) - 1)
+    {
+      while (m_memBlocks >= m_maxBlocks)
+      {
+        if (!MakeSpace())
+          break;
+      }
+      if (m_memBlocks >= m_maxBlocks)
+        break;
+
+      segment.blocks.emplace_back();
+      segment.blocks.back().data.reset(new char[BLOCK_SIZE]);
+      segment.memBlocks++;
+      m_memBlocks++;
+    }
+
+    CBlock& target = segment.blocks[block - BlockIndex(segment.start)];
+    const size_t offset = static_cast<size_t>(segment.end % BLOCK_SIZE);
+    const size_t size = std::min(len - written, static_cast<size_t>(BLOCK_SIZE) - offset);
+    if (!WriteBlock(target, offset, buf + written, size))
+      return written ? static_cast<int>(written) : CACHE_RC_ERROR;
+
+    target.lastUse = ++m_useCounter;
+    segment.end += size;
+    written += size;
+  }
+
+  if (written == 0)
+    return 0;
+
+  m_active->lastUse = ++m_useCounter;
+  next = std::next(m_active);
+  if (next != m_segments.end() && next->start == m_active->end)
+    JoinFollowing(m_active);
+
+  m_written.Set();
+
+  return static_cast<int>(written);
+}
+
+/**
+ * Reads data from cache. Will only read up till the end
+ * of a block, so multiple calls may be needed.
+ */
+int CSparseCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  CSegment& segment = *m_active;
+  const size_t offset = static_cast<size_t>(m_cur % BLOCK_SIZE);
+  const size_t avail = static_cast<size_t>(std::min<int64_t>(BLOCK_SIZE - offset, segment.end - m_cur));
+
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if (len > avail)
+    len = avail;
+
+  if (len == 0)
+    return 0;
+
+  CBlock& block = segment.blocks[BlockIndex(m_cur) - BlockIndex(segment.start)];
+  if (!ReadBlock(block, offset, buf, len))
+    return CACHE_RC_ERROR;
+
+  block.lastUse = ++m_useCounter;
+  segment.lastUse = block.lastUse;
+  m_cur += len;
+
+  m_space.Set();
+
+  return static_cast<int>(len);
+}
+
+int64_t CSparseCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = m_active->end - m_cur;
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_front)
+    minimum = m_front;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = m_active->end - m_cur;
+  }
+
+  return avail;
+}
+
+int64_t CSparseCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  const int64_t end = m_active->end;
+  if (pos >= end && pos < end + 100000 && FindSegment(pos) == m_segments.end())
+  {
+    // make everything cached back-cache, to make sure there's sufficient forward space
+    m_cur = end;
+    lock.Leave();
+    WaitForData(static_cast<unsigned int>(pos - end), 5000);
+    lock.Enter();
+  }
+
+  // other ranges are only read after a reset, which moves the source to their end
+  if (pos >= m_active->start && pos <= m_active->end)
+  {
+    m_cur = pos;
+    m_active->lastUse = ++m_useCounter;
+    return pos;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+bool CSparseCache::Reset(int64_t pos, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+  {
+    Clear(pos);
+    return true;
+  }
+
+  // don't keep a range that never got any data
+  auto previous = m_active;
+  auto segment = FindSegment(pos);
+  if (segment == m_segments.end())
+  {
+    auto next = std::find_if(m_segments.begin(), m_segments.end(),
+                             [pos](const CSegment& segment) { return segment.start > pos; });
+    segment = m_segments.emplace(next, pos);
+  }
+
+  m_active = segment;
+  if (previous != m_active && previous->start == previous->end)
+    DropSegment(previous);
+
+  JoinFollowing(m_active);
+  m_cur = pos;
+  m_active->lastUse = ++m_useCounter;
+
+  // the forward buffer is only still there when we landed in a range with data
+  return m_active->end == pos;
+}
+
+int64_t CSparseCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  auto segment = FindSegment(iFilePosition);
+  if (segment == m_segments.end())
+    return iFilePosition;
+
+  // ranges that touch are joined on reset, so count them as one
+  int64_t end = segment->end;
+  for (auto it = std::next(segment); it != m_segments.end() && it->start == end; ++it)
+    end = it->end;
+  return end;
+}
+
+int64_t CSparseCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_active->end;
+}
+
+bool CSparseCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return FindSegment(iFilePosition) != m_segments.end();
+}
+
+void CSparseCache::GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges)
+{
+  CSingleLock lock(m_sync);
+  ranges.clear();
+  for (const auto& segment : m_segments)
+  {
+    if (segment.start < segment.end)
+      ranges.emplace_back(segment.start, segment.end);
+  }
+}
+
+CCacheStrategy *CSparseCache::CreateNew()
+{
+  return new CSparseCache(m_front, m_back, m_memorySize, m_spillSize);
+}
+
+void CSparseCache::Clear(int64_t pos)
+{
+  m_segments.clear();
+  m_memBlocks = 0;
+  m_nextSlot = 0;
+  m_freeSlots.clear();
+
+  m_active = m_segments.emplace(m_segments.end(), pos);
+  m_cur = pos;
+}
+
+CSparseCache::SegmentList::iterator CSparseCache::FindSegment(int64_t pos)
+{
+  return std::find_if(m_segments.begin(), m_segments.end(), [pos](const CSegment& segment) {
+    return pos >= segment.start && pos <= segment.end;
+  });
+}
+
+void CSparseCache::JoinFollowing(SegmentList::iterator segment)
+{
+  auto next = std::next(segment);
+  while (next != m_segments.end() && next->start == segment->end)
+  {
+    if (next->start < next->end)
+    {
+      if (segment->blocks.empty())
+      {
+        segment->blocks = std::move(next->blocks);
+        segment->memBlocks = next->memBlocks;
+      }
+      else
+      {
+        // both ranges may hold part of the block where they meet
+        size_t first = 0;
+        if (BlockIndex(segment->end - 1) == BlockIndex(next->start))
+        {
+          const size_t offset = static_cast<size_t>(next->start % BLOCK_SIZE);
+          const size_t size = static_cast<size_t>(
+              std::min<int64_t>(next->end, (BlockIndex(next->start) + 1) * BLOCK_SIZE) - next->start);
+          char buffer[4096];
+          for (size_t done = 0; done < size; done += sizeof(buffer))
+          {
+            const size_t chunk = std::min(size - done, sizeof(buffer));
+            if (!ReadBlock(next->blocks.front(), offset + done, buffer, chunk) ||
+                !WriteBlock(segment->blocks.back(), offset + done, buffer, chunk))
+            {
+              // keep what we have, the rest is fetched again
+              CLog::LogF(LOGERROR, "failed to join cached ranges");
+              DropSegment(next);
+              return;
+            }
+          }
+          DropBlock(next->blocks.front());
+          first = 1;
+        }
+        for (size_t i = first; i < next->blocks.size(); ++i)
+        {
+          if (next->blocks[i].data)
+            segment->memBlocks++;
+          segment->blocks.push_back(std::move(next->blocks[i]));
+        }
+        next->blocks.clear();
+      }
+      segment->end = next->end;
+      segment->lastUse = std::max(segment->lastUse, next->lastUse);
+    }
+
+    next->memBlocks = 0;
+    next = m_segments.erase(next);
+  }
+}
+
+/**
+ * Moves the least recently used block that isn't needed for reading out of
+ * memory. Candidates are the blocks of the other ranges and those behind the
+ * back buffer of the range being read.
+ *
+ * \return false if there is nothing that can be moved
+ */
+bool CSparseCache::MakeSpace()
+{
+  auto victim = m_segments.end();
+  size_t index = 0;
+  uint64_t lastUse = std::numeric_limits<uint64_t>::max();
+  for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (it == m_active)
+    {
+      const int64_t limit = m_cur - static_cast<int64_t>(m_back);
+      for (size_t i = 0; i < it->blocks.size() && (BlockIndex(it->start) + static_cast<int64_t>(i) + 1) * BLOCK_SIZE <= limit; ++i)
+      {
+        if (it->blocks[i].data)
+        {
+          if (it->blocks[i].lastUse < lastUse)
+          {
+            victim = it;
+            index = i;
+            lastUse = it->blocks[i].lastUse;
+          }
+          break;
+        }
+      }
+    }
+    else if (it->memBlocks > 0 && it->lastUse < lastUse)
+    {
+      victim = it;
+      lastUse = it->lastUse;
+      index = 0;
+      while (!it->blocks[index].data)
+        index++;
+    }
+  }
+
+  if (victim == m_segments.end())
+    return false;
+
+  if (m_maxSlots > 0)
+  {
+    // make room on disk by dropping the least recently used other range
+    if (m_freeSlots.empty() && m_nextSlot >= m_maxSlots)
+    {
+      auto oldest = m_segments.end();
+      for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+      {
+        if (it != m_active && (oldest == m_segments.end() || it->lastUse < oldest->lastUse))
+          oldest = it;
+      }
+      if (oldest != m_segments.end() && oldest != victim)
+      {
+        DropSegment(oldest);
+        return true;
+      }
+    }
+
+    if ((!m_freeSlots.empty() || m_nextSlot < m_maxSlots) && SpillBlock(*victim, index))
+      return true;
+  }
+
+  if (victim == m_active)
+    DropFront(*victim, index + 1);
+  else
+    DropSegment(victim);
+
+  return true;
+}
+
+bool CSparseCache::SpillBlock(CSegment& segment, size_t index)
+{
+  if (!m_spillFile)
+  {
+    m_spillFilename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.spill", 999));
+    if (m_spillFilename.empty())
+    {
+      CLog::LogF(LOGERROR, "unable to generate a new filename");
+      m_maxSlots = 0;
+      return false;
+    }
+
+    m_spillFile.reset(new CacheLocalFile());
+    if (!m_spillFile->OpenForWrite(CURL(m_spillFilename), true))
+    {
+      CLog::LogF(LOGERROR, "failed to create file \"%s\"", m_spillFilename.c_str());
+      m_spillFile.reset();
+      m_spillFilename.clear();
+      m_maxSlots = 0;
+      return false;
+    }
+  }
+
+  int64_t slot;
+  if (!m_freeSlots.empty())
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else
+    slot = m_nextSlot++;
+
+  CBlock& block = segment.blocks[index];
+  if (m_spillFile->Seek(slot * BLOCK_SIZE, SEEK_SET) != slot * BLOCK_SIZE ||
+      m_spillFile->Write(block.data.get(), BLOCK_SIZE) != BLOCK_SIZE)
+  {
+    CLog::LogF(LOGERROR, "failed to write to file \"%s\"", m_spillFilename.c_str());
+    m_freeSlots.push_back(slot);
+    return false;
+  }
+
+  block.data.reset();
+  block.slot = slot;
+  segment.memBlocks--;
+  m_memBlocks--;
+  return true;
+}
+
+void CSparseCache::DropBlock(CBlock& block)
+{
+  if (block.data)
+  {
+    block.data.reset();
+    m_memBlocks--;
+  }
+  else if (block.slot >= 0)
+    m_freeSlots.push_back(block.slot);
+  block.slot = -1;
+}
+
+void CSparseCache::DropFront(CSegment& segment, size_t count)
+{
+  const int64_t first = BlockIndex(segment.start);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (segment.blocks.front().data)
+      segment.memBlocks--;
+    DropBlock(segment.blocks.front());
+    segment.blocks.pop_front();
+  }
+  segment.start = std::min((first + static_cast<int64_t>(count)) * BLOCK_SIZE, segment.end);
+}
+
+void CSparseCache::DropSegment(SegmentList::iterator segment)
+{
+  for (auto& block : segment->blocks)
+    DropBlock(block);
+  m_segments.erase(segment);
+}
+
+bool CSparseCache::ReadBlock(const CBlock& block, size_t offset, char* buf, size_t len)
+{
+  if (block.data)
+  {
+    memcpy(buf, block.data.get() + offset, len);
+    return true;
+  }
+
+  const int64_t pos = block.slot * BLOCK_SIZE + offset;
+  return m_spillFile && m_spillFile->Seek(pos, SEEK_SET) == pos &&
+         m_spillFile->Read(buf, len) == static_cast<ssize_t>(len);
+}
+
+bool CSparseCache::WriteBlock(CBlock& block, size_t offset, const char* buf, size_t len)
+{
+  if (block.data)
+  {
+    memcpy(block.data.get() + offset, buf, len);
+    return true;
+  }
+
+  const int64_t pos = block.slot * BLOCK_SIZE + offset;
+  return m_spillFile && m_spillFile->Seek(pos, SEEK_SET) == pos &&
+         m_spillFile->Write(buf, len) == static_cast<ssize_t>(len);
+}
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE {
+
+class IFile;
+
+/*!
+ \brief Cache strategy keeping several cached ranges of a file.
+
+ A seek outside of the range being read starts a new range instead of throwing away what
+ was cached, so seeking back into a range that was fetched before doesn't hit the source
+ again. A range that grows into the next one is joined with it. The data is held in blocks;
+ once the memory is used up, the least recently used blocks are moved to a file on disk (if
+ allowed), and dropped when that is full as well.
+
+ Only one range is filled and read at a time. Seeking into another range is reported as a
+ cache miss, after which the caller resets the cache to the new position and continues
+ fetching from the end of that range.
+ */
+class CSparseCache : public CCacheStrategy
+{
+public:
+  /*!
+   \param front maximum amount of data cached ahead of the read position
+   \param back amount of data kept behind the read position
+   \param memorySize memory to hold all ranges in, at least front + back is used
+   \param spillSize disk space for data evicted from memory, 0 to drop it instead
+   */
+  CSparseCache(size_t front, size_t back, size_t memorySize, uint64_t spillSize);
+  ~CSparseCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *buf, size_t len) override;
+  int ReadFromCache(char *buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway=true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+  void GetCachedRanges(std::vector<std::pair<int64_t, int64_t>>& ranges) override;
+
+  CCacheStrategy *CreateNew() override;
+
+private:
+  struct CBlock
+  {
+    std::unique_ptr<char[]> data; ///< block in memory, or
+    int64_t slot = -1;            ///< its slot in the spill file
+    uint64_t lastUse = 0;
+  };
+
+  struct CSegment
+  {
+    explicit CSegment(int64_t pos) : start(pos), end(pos) {}
+
+    int64_t start;              ///< index in file of beginning of cached data
+    int64_t end;                ///< index in file of end of cached data
+    std::deque<CBlock> blocks;  ///< blocks aligned to the block size in the file
+    size_t memBlocks = 0;       ///< number of blocks held in memory
+    uint64_t lastUse = 0;
+  };
+
+  using SegmentList = std::list<CSegment>;
+
+  void Clear(int64_t pos);
+  SegmentList::iterator FindSegment(int64_t pos);
+  void JoinFollowing(SegmentList::iterator segment);
+  bool MakeSpace();
+  bool SpillBlock(CSegment& segment, size_t index);
+  void DropBlock(CBlock& block);
+  void DropFront(CSegment& segment, size_t count);
+  void DropSegment(SegmentList::iterator segment);
+  bool ReadBlock(const CBlock& block, size_t offset, char* buf, size_t len);
+  bool WriteBlock(CBlock& block, size_t offset, const char* buf, size_t len);
+
+  SegmentList m_segments;       ///< cached ranges ordered by position, never overlapping
+  SegmentList::iterator m_active; ///< range being read and filled
+  int64_t m_cur = 0;            ///< current reading index in file
+  size_t m_front;
+  size_t m_back;
+  size_t m_memorySize;
+  uint64_t m_spillSize;
+  size_t m_maxBlocks;           ///< blocks that may be held in memory
+  size_t m_memBlocks = 0;
+  int64_t m_maxSlots;           ///< blocks that may be spilled to disk
+  int64_t m_nextSlot = 0;
+  std::vector<int64_t> m_freeSlots;
+  uint64_t m_useCounter = 0;
+  std::unique_ptr<IFile> m_spillFile;
+  std::string m_spillFilename;
+  CCriticalSection m_sync;
+  CEvent m_written;
+};
+
+} // namespace XFILE
@@ -9,6 +9,7 @@
 #include "ZipManager.h"
 
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 #include "File.h"
@@ -25,6 +26,8 @@
 using namespace XFILE;
 
 static const size_t ZC_FLAG_EFS = 1 << 11; // general purpose bit 11 - zip holds utf-8 filenames
+// largest central directory read in one go, about a million entries
+static const unsigned int ZIP_MAX_CDIR_SIZE = 64 * 1024 * 1024;
 
 CZipManager::CZipManager() = default;
 
@@ -54,6 +57,7 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
     }
     mZipMap.erase(it);
     mZipDate.erase(it2);
+    mZipIndex.erase(strFile);
   }
 
   CFile mFile;
@@ -156,32 +160,44 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
     return false;
   cdirOffset = Endian_SwapLE32(cdirOffset);
 
-  // Go to the start of central directory
+  // the sizes come from the file, check them before allocating anything
+  if (cdirSize > ZIP_MAX_CDIR_SIZE ||
+      static_cast<int64_t>(cdirOffset) + cdirSize > fileSize)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    mFile.Close();
+    return false;
+  }
+
+  // Read the whole central directory at once
   mFile.Seek(cdirOffset,SEEK_SET);
+  auto_buffer cdir(cdirSize);
+  if (mFile.Read(cdir.get(), cdirSize) != static_cast<ssize_t>(cdirSize))
+    return false;
 
   CRegExp pathTraversal;
   pathTraversal.RegComp(PATH_TRAVERSAL);
 
-  char temp[CHDR_SIZE];
-  while (mFile.GetPosition() < cdirOffset + cdirSize)
+  size_t cdirPos = 0;
+  while (cdirPos < cdirSize)
   {
     SZipEntry ze;
-    if (mFile.Read(temp, CHDR_SIZE) != CHDR_SIZE)
+    if (cdirPos + CHDR_SIZE > cdirSize)
       return false;
-    readCHeader(temp, ze);
+    readCHeader(cdir.get() + cdirPos, ze);
     if (ze.header != ZIP_CENTRAL_HEADER)
     {
       CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
       mFile.Close();
       return false;
     }
+    cdirPos += CHDR_SIZE;
 
     // Get the filename just after the central file header
-    auto_buffer bufName(ze.flength);
-    if (mFile.Read(bufName.get(), ze.flength) != ze.flength)
+    if (cdirPos + ze.flength > cdirSize)
       return false;
-    std::string strName(bufName.get(), bufName.size());
-    bufName.clear();
+    std::string strName(cdir.get() + cdirPos, ze.flength);
+    cdirPos += ze.flength;
     if ((ze.flags & ZC_FLAG_EFS) == 0)
     {
       std::string tmp(strName);
@@ -191,7 +207,7 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
     strncpy(ze.name, strName.c_str(), strName.size() > 254 ? 254 : strName.size());
 
     // Jump after central file header extra field and file comment
-    mFile.Seek(ze.eclength + ze.clength,SEEK_CUR);
+    cdirPos += ze.eclength + ze.clength;
 
     if (pathTraversal.RegFind(strName) < 0)
       items.push_back(ze);
@@ -212,32 +228,55 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
+  addZipList(strFile, items);
   mFile.Close();
   return true;
 }
 
+void CZipManager::addZipList(const std::string& strFile, const std::vector<SZipEntry>& items)
+{
+  const std::vector<SZipEntry>& entries = mZipMap.insert(make_pair(strFile,items)).first->second;
+
+  std::hash<std::string> hasher;
+  std::vector<std::pair<size_t, size_t> > index;
+  index.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); i++)
+    index.emplace_back(hasher(entries[i].name), i);
+  // entries with the same hash stay in order, so the first of equal names is found
+  std::sort(index.begin(), index.end());
+
+  mZipIndex[strFile] = std::move(index);
+}
+
 bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
 {
   const std::string& strFile = url.GetHostName();
 
   std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  std::vector<SZipEntry> items;
   if (it == mZipMap.end()) // we need to list the zip
   {
-    GetZipList(url,items);
-  }
-  else
-  {
-    items = it->second;
+    std::vector<SZipEntry> items;
+    if (!GetZipList(url,items))
+      return false;
+    it = mZipMap.find(strFile);
+    if (it == mZipMap.end())
+      return false;
   }
 
+  const auto it2 = mZipIndex.find(strFile);
+  if (it2 == mZipIndex.end())
+    return false;
+
   const std::string& strFileName = url.GetFileName();
-  for (const auto& it2 : items)
+  const std::vector<std::pair<size_t, size_t> >& index = it2->second;
+  const size_t hash = std::hash<std::string>()(strFileName);
+  for (auto entry = std::lower_bound(index.begin(), index.end(), std::make_pair(hash, static_cast<size_t>(0)));
+       entry != index.end() && entry->first == hash; ++entry)
   {
-    if (std::string(it2.name) == strFileName)
+    const SZipEntry& ze = it->second[entry->second];
+    if (strFileName == ze.name)
     {
-      item = it2;
+      item = ze;
       return true;
     }
   }
@@ -315,6 +354,7 @@ void CZipManager::release(const std::string& strPath)
     std::map<std::string,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
     mZipMap.erase(it);
     mZipDate.erase(it2);
+    mZipIndex.erase(url.GetHostName());
   }
 }
 
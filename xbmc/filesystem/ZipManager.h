@@ -65,8 +65,12 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
+  void addZipList(const std::string& strFile, const std::vector<SZipEntry>& items);
+
   std::map<std::string,std::vector<SZipEntry> > mZipMap;
   std::map<std::string,int64_t> mZipDate;
+  // per zip, hash of each entry name and its position in mZipMap, sorted by the hash
+  std::map<std::string,std::vector<std::pair<size_t, size_t> > > mZipIndex;
 };
 
 extern CZipManager g_ZipManager;
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/HttpCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/HttpHeader.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+CHttpHeader MakeHeader(const std::string& fields)
+{
+  CHttpHeader header;
+  header.Parse("HTTP/1.1 200 OK\r\n" + fields + "\r\n");
+  return header;
+}
+}
+
+class TestHttpCache : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CHttpCache::GetInstance().Configure(
+        CSpecialProtocol::TranslatePath("special://temp/testhttpcache/"), 16 * 1024);
+    CHttpCache::GetInstance().Clear();
+  }
+
+  void TearDown() override
+  {
+    CHttpCache::GetInstance().Clear();
+    CHttpCache::GetInstance().Configure("", 0);
+  }
+};
+
+TEST_F(TestHttpCache, Lifetime)
+{
+  EXPECT_EQ(600, CHttpCache::GetLifetime(MakeHeader("Cache-Control: public, max-age=600\r\n")));
+  EXPECT_EQ(0, CHttpCache::GetLifetime(MakeHeader("Cache-Control: no-cache, max-age=600\r\n")));
+  EXPECT_EQ(-1, CHttpCache::GetLifetime(MakeHeader("Cache-Control: no-store\r\n")));
+  EXPECT_EQ(-1, CHttpCache::GetLifetime(MakeHeader("Cache-Control: max-age=60\r\nVary: *\r\n")));
+  EXPECT_EQ(3600, CHttpCache::GetLifetime(MakeHeader("Date: Tue, 01 Jun 2021 10:00:00 GMT\r\n"
+                                                     "Expires: Tue, 01 Jun 2021 11:00:00 GMT\r\n")));
+  EXPECT_EQ(0, CHttpCache::GetLifetime(MakeHeader("Expires: 0\r\n")));
+  EXPECT_EQ(0, CHttpCache::GetLifetime(MakeHeader("Content-Type: text/html\r\n")));
+}
+
+TEST_F(TestHttpCache, StoreAndRevalidate)
+{
+  CHttpCache& cache = CHttpCache::GetInstance();
+  const std::string fresh = CHttpCache::GetKey("http://localhost/fresh", {});
+  const std::string stale = CHttpCache::GetKey("http://localhost/stale", {});
+  CHttpCache::CEntry entry;
+
+  EXPECT_EQ(CHttpCache::LookupResult::MISS, cache.Lookup(fresh, entry));
+  cache.Store(fresh, MakeHeader("Cache-Control: max-age=600\r\nContent-Type: text/xml\r\n"), "<a/>");
+  ASSERT_EQ(CHttpCache::LookupResult::FRESH, cache.Lookup(fresh, entry));
+  EXPECT_EQ("<a/>", entry.body);
+
+  // without a validator an expired response is useless
+  cache.Store(stale, MakeHeader("Cache-Control: no-cache\r\n"), "body");
+  EXPECT_EQ(CHttpCache::LookupResult::MISS, cache.Lookup(stale, entry));
+
+  cache.Store(stale, MakeHeader("Cache-Control: no-cache\r\nETag: \"v1\"\r\n"), "body");
+  ASSERT_EQ(CHttpCache::LookupResult::STALE, cache.Lookup(stale, entry));
+  EXPECT_EQ("\"v1\"", entry.etag);
+
+  cache.Revalidated(stale, MakeHeader("Cache-Control: max-age=600\r\n"), entry);
+  ASSERT_EQ(CHttpCache::LookupResult::FRESH, cache.Lookup(stale, entry));
+  EXPECT_EQ("body", entry.body);
+  EXPECT_EQ("\"v1\"", entry.etag);
+
+  // all request headers are part of the key, whatever the case of their names
+  const std::string german = CHttpCache::GetKey("http://localhost/fresh", {{"Accept-Language", "de"}});
+  EXPECT_NE(fresh, german);
+  EXPECT_EQ(german, CHttpCache::GetKey("http://localhost/fresh", {{"accept-language", "de"}}));
+  EXPECT_NE(CHttpCache::GetKey("http://localhost/fresh", {{"X-Api-Key", "a"}}),
+            CHttpCache::GetKey("http://localhost/fresh", {{"X-Api-Key", "b"}}));
+  EXPECT_EQ(CHttpCache::LookupResult::MISS, cache.Lookup(german, entry));
+
+  const CHttpCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(1u, stats.revalidations);
+  EXPECT_EQ(1u, stats.notModified);
+  EXPECT_EQ(2u, stats.entries);
+}
+
+TEST_F(TestHttpCache, EvictsLeastRecentlyUsed)
+{
+  CHttpCache& cache = CHttpCache::GetInstance();
+  const CHttpHeader header = MakeHeader("Cache-Control: max-age=600\r\n");
+  const std::string body(1500, 'x');
+  CHttpCache::CEntry entry;
+
+  for (int i = 0; i < 20; i++)
+  {
+    const std::string key = CHttpCache::GetKey("http://localhost/" + std::to_string(i), {});
+    cache.Store(key, header, body);
+    // keep the first one in use
+    EXPECT_EQ(CHttpCache::LookupResult::FRESH,
+              cache.Lookup(CHttpCache::GetKey("http://localhost/0", {}), entry));
+  }
+
+  const CHttpCache::Stats stats = cache.GetStats();
+  EXPECT_LE(stats.size, 16u * 1024);
+  EXPECT_GT(stats.evictions, 0u);
+  EXPECT_EQ(CHttpCache::LookupResult::MISS,
+            cache.Lookup(CHttpCache::GetKey("http://localhost/1", {}), entry));
+  EXPECT_EQ(CHttpCache::LookupResult::FRESH,
+            cache.Lookup(CHttpCache::GetKey("http://localhost/19", {}), entry));
+
+  // responses too big for the cache aren't kept
+  cache.Store(CHttpCache::GetKey("http://localhost/big", {}), header, std::string(4096, 'x'));
+  EXPECT_EQ(CHttpCache::LookupResult::MISS,
+            cache.Lookup(CHttpCache::GetKey("http://localhost/big", {}), entry));
+}
+
+TEST_F(TestHttpCache, Clear)
+{
+  CHttpCache& cache = CHttpCache::GetInstance();
+  const std::string key = CHttpCache::GetKey("http://localhost/clear", {});
+  cache.Store(key, MakeHeader("Cache-Control: max-age=600\r\n"), "body");
+  ASSERT_EQ(1u, cache.GetStats().entries);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetStats().entries);
+  EXPECT_EQ(0u, cache.GetStats().size);
+
+  // the response is gone from the disk too, it isn't picked up again
+  cache.Configure(CSpecialProtocol::TranslatePath("special://temp/testhttpcache/"), 16 * 1024);
+  CHttpCache::CEntry entry;
+  EXPECT_EQ(CHttpCache::LookupResult::MISS, cache.Lookup(key, entry));
+}
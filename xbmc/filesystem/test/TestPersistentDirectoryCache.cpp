@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/PersistentDirectoryCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "test/TestUtils.h"
+#include "utils/URIUtils.h"
+
+#include <gtest/gtest.h>
+
+class TestPersistentDirectoryCache : public testing::Test
+{
+protected:
+  TestPersistentDirectoryCache()
+  {
+    m_root = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestPersistentDirectoryCache");
+    m_cachePath = URIUtils::AddFileToFolder(m_root, "cache");
+    m_listedPath = URIUtils::AddFileToFolder(m_root, "listed");
+    XFILE::CDirectory::Create(m_listedPath);
+
+    m_items.Add(CFileItemPtr(new CFileItem(URIUtils::AddFileToFolder(m_listedPath, "a.mkv"), false)));
+    m_items.Add(CFileItemPtr(new CFileItem(URIUtils::AddFileToFolder(m_listedPath, "b"), true)));
+  }
+
+  ~TestPersistentDirectoryCache() override
+  {
+    XFILE::CDirectory::RemoveRecursive(m_root);
+  }
+
+  std::string m_root;
+  std::string m_cachePath;
+  std::string m_listedPath;
+  CFileItemList m_items;
+};
+
+TEST_F(TestPersistentDirectoryCache, StoreAndLoad)
+{
+  const CURL url(m_listedPath);
+  XFILE::CPersistentDirectoryCache cache(m_cachePath);
+  const std::string validator = cache.GetValidator(url);
+  EXPECT_FALSE(validator.empty());
+  ASSERT_TRUE(cache.SetDirectory(url, validator, m_items));
+
+  // a second instance has to pick up the listings from disk
+  XFILE::CPersistentDirectoryCache reopened(m_cachePath);
+  CFileItemList items;
+  ASSERT_TRUE(reopened.GetDirectory(url, 0, items));
+  ASSERT_EQ(2, items.Size());
+  EXPECT_EQ(m_items[0]->GetPath(), items[0]->GetPath());
+  EXPECT_FALSE(items[0]->m_bIsFolder);
+  EXPECT_EQ(m_items[1]->GetPath(), items[1]->GetPath());
+  EXPECT_TRUE(items[1]->m_bIsFolder);
+
+  reopened.ClearDirectory(url);
+  EXPECT_FALSE(reopened.GetDirectory(url, 0, items));
+}
+
+TEST_F(TestPersistentDirectoryCache, Validation)
+{
+  const CURL url(m_listedPath);
+  XFILE::CPersistentDirectoryCache cache(m_cachePath);
+  ASSERT_TRUE(cache.SetDirectory(url, cache.GetValidator(url), m_items));
+  ASSERT_TRUE(XFILE::CDirectory::Remove(m_listedPath));
+
+  // trusted listings are used without looking at the directory
+  CFileItemList items;
+  EXPECT_TRUE(cache.GetDirectory(url, 3600, items));
+  EXPECT_EQ(2, items.Size());
+
+  // otherwise the vanished directory invalidates the listing
+  EXPECT_FALSE(cache.GetDirectory(url, 0, items));
+  EXPECT_FALSE(cache.GetDirectory(url, 3600, items));
+}
+
+TEST_F(TestPersistentDirectoryCache, Eviction)
+{
+  const CURL url(m_listedPath);
+  XFILE::CPersistentDirectoryCache cache(m_cachePath);
+  ASSERT_TRUE(cache.SetDirectory(url, cache.GetValidator(url), m_items));
+
+  cache.SetMaxSize(1);
+  CFileItemList items;
+  EXPECT_FALSE(cache.GetDirectory(url, 3600, items));
+
+  // listings that don't fit are dropped right away
+  EXPECT_TRUE(cache.SetDirectory(url, cache.GetValidator(url), m_items));
+  EXPECT_FALSE(cache.GetDirectory(url, 3600, items));
+}
+
+TEST_F(TestPersistentDirectoryCache, ValidatedBeforeListing)
+{
+  const CURL url(m_listedPath);
+  XFILE::CPersistentDirectoryCache cache(m_cachePath);
+  EXPECT_FALSE(cache.SetDirectory(url, "", m_items));
+
+  // the directory changed after it was validated, while listing it
+  ASSERT_TRUE(cache.SetDirectory(url, "1:0", m_items));
+  CFileItemList items;
+  EXPECT_TRUE(cache.GetDirectory(url, 3600, items));
+  EXPECT_FALSE(cache.GetDirectory(url, 0, items));
+}
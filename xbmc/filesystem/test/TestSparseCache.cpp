@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/SparseCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const size_t MiB = 1024 * 1024;
+
+char DataAt(int64_t pos)
+{
+  return static_cast<char>((pos * 2654435761u) >> 13);
+}
+
+// fill the cache from its write position like CFileCache does
+void Fill(CSparseCache& cache, int64_t& source, size_t size)
+{
+  std::vector<char> buffer(size);
+  for (size_t i = 0; i < size; ++i)
+    buffer[i] = DataAt(source + i);
+
+  size_t total = 0;
+  while (total < size)
+  {
+    const int written = cache.WriteToCache(buffer.data() + total, size - total);
+    ASSERT_GE(written, 0);
+    if (written == 0)
+      break;
+    total += written;
+    if (cache.CachedDataEndPos() != source + static_cast<int64_t>(total))
+      break;
+  }
+  source = cache.CachedDataEndPos();
+}
+
+bool ReadAndCheck(CSparseCache& cache, int64_t pos, size_t size)
+{
+  std::vector<char> buffer(size);
+  size_t total = 0;
+  while (total < size)
+  {
+    const int read = cache.ReadFromCache(buffer.data() + total, size - total);
+    if (read <= 0)
+      return false;
+    total += read;
+  }
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (buffer[i] != DataAt(pos + i))
+      return false;
+  }
+  return true;
+}
+
+// seek like CFileCache, returns the position the source has to continue from
+int64_t SeekTo(CSparseCache& cache, int64_t pos)
+{
+  if (cache.Seek(pos) == pos)
+    return cache.CachedDataEndPos();
+
+  const int64_t end = cache.CachedDataEndPosIfSeekTo(pos);
+  cache.Reset(pos, false);
+  EXPECT_EQ(end, cache.CachedDataEndPos());
+  return end;
+}
+}
+
+TEST(TestSparseCache, KeepsRangesAcrossSeeks)
+{
+  CSparseCache cache(4 * MiB, 1 * MiB, 16 * MiB, 0);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  int64_t source = 0;
+  Fill(cache, source, 2 * MiB);
+  EXPECT_TRUE(ReadAndCheck(cache, 0, 1 * MiB));
+
+  // jump far ahead, the first range has to stay
+  source = SeekTo(cache, 100 * MiB);
+  EXPECT_EQ(100 * MiB, source);
+  Fill(cache, source, 1 * MiB);
+  EXPECT_TRUE(ReadAndCheck(cache, 100 * MiB, 1 * MiB));
+
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  cache.GetCachedRanges(ranges);
+  ASSERT_EQ(2u, ranges.size());
+  EXPECT_EQ(0, ranges[0].first);
+  EXPECT_EQ(static_cast<int64_t>(2 * MiB), ranges[0].second);
+  EXPECT_EQ(static_cast<int64_t>(100 * MiB), ranges[1].first);
+  EXPECT_EQ(static_cast<int64_t>(101 * MiB), ranges[1].second);
+
+  // going back doesn't need the source
+  EXPECT_TRUE(cache.IsCachedPosition(512 * 1024));
+  source = SeekTo(cache, 512 * 1024);
+  EXPECT_EQ(static_cast<int64_t>(2 * MiB), source);
+  EXPECT_TRUE(ReadAndCheck(cache, 512 * 1024, 1536 * 1024));
+  cache.Close();
+}
+
+TEST(TestSparseCache, JoinsAdjacentRanges)
+{
+  CSparseCache cache(8 * MiB, 1 * MiB, 32 * MiB, 0);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // a range in the middle of a block, followed by one at the start
+  int64_t source = SeekTo(cache, 3 * MiB + 1000);
+  Fill(cache, source, 1 * MiB);
+  source = SeekTo(cache, 0);
+  Fill(cache, source, 2 * MiB);
+
+  // filling up to the second range continues after its end
+  Fill(cache, source, 2 * MiB);
+  EXPECT_EQ(static_cast<int64_t>(4 * MiB + 1000), source);
+
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  cache.GetCachedRanges(ranges);
+  ASSERT_EQ(1u, ranges.size());
+  EXPECT_EQ(0, ranges[0].first);
+  EXPECT_EQ(static_cast<int64_t>(4 * MiB + 1000), ranges[0].second);
+  EXPECT_TRUE(ReadAndCheck(cache, 0, 4 * MiB + 1000));
+  cache.Close();
+}
+
+TEST(TestSparseCache, EvictsLeastRecentlyUsed)
+{
+  CSparseCache cache(2 * MiB, 1 * MiB, 4 * MiB, 0);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  int64_t source = 0;
+  Fill(cache, source, 1 * MiB);
+  source = SeekTo(cache, 10 * MiB);
+  Fill(cache, source, 1 * MiB);
+
+  // reading a long way on has to make room by dropping the first range
+  source = SeekTo(cache, 20 * MiB);
+  for (int i = 0; i < 8; ++i)
+  {
+    Fill(cache, source, 1 * MiB);
+    EXPECT_TRUE(ReadAndCheck(cache, 20 * MiB + i * MiB, 1 * MiB));
+  }
+
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(28 * MiB));
+  cache.Close();
+}
@@ -0,0 +1,468 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIBenchmark.h"
+
+#include "FileItem.h"
+#include "GUIComponent.h"
+#include "GUIControlGroup.h"
+#include "GUIMessage.h"
+#include "GUIWindow.h"
+#include "GUIWindowManager.h"
+#include "ServiceBroker.h"
+#include "WindowIDs.h"
+#include "addons/Skin.h"
+#include "filesystem/File.h"
+#include "input/WindowTranslator.h"
+#include "media/MediaType.h"
+#include "messaging/ApplicationMessenger.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Metrics.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+#include "utils/log.h"
+#include "video/VideoInfoTag.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
+
+#include <algorithm>
+#include <math.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace KODI::MESSAGING;
+
+#define GUIBENCHMARK_OUTPUT "special://temp/guibenchmark.json"
+#define GUIBENCHMARK_FRAMES 300
+#define GUIBENCHMARK_WARMUP 60
+
+namespace
+{
+const char* const PASS_NAMES[] = {"process", "render"};
+
+uint64_t GetEvaluations()
+{
+  static std::atomic<uint64_t>& evaluations = CMetrics::GetInstance().GetCounter("guiinfo.evaluations");
+  return evaluations;
+}
+
+/*!
+ \brief Get the bytes allocated from the heap, -1 if the C library doesn't tell.
+ */
+int64_t GetHeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return static_cast<int64_t>(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+  return static_cast<int64_t>(static_cast<unsigned int>(mallinfo().uordblks));
+#else
+  return -1;
+#endif
+}
+
+const char* GetTypeName(int type)
+{
+  switch (type)
+  {
+    case CGUIControl::GUICONTROL_BUTTON: return "button";
+    case CGUIControl::GUICONTROL_FADELABEL: return "fadelabel";
+    case CGUIControl::GUICONTROL_IMAGE: return "image";
+    case CGUIControl::GUICONTROL_BORDEREDIMAGE: return "borderedimage";
+    case CGUIControl::GUICONTROL_LABEL: return "label";
+    case CGUIControl::GUICONTROL_LISTGROUP: return "listgroup";
+    case CGUIControl::GUICONTROL_PROGRESS: return "progress";
+    case CGUIControl::GUICONTROL_RADIO: return "radiobutton";
+    case CGUIControl::GUICONTROL_RSS: return "rss";
+    case CGUIControl::GUICONTROL_SLIDER: return "slider";
+    case CGUIControl::GUICONTROL_SETTINGS_SLIDER: return "sliderex";
+    case CGUIControl::GUICONTROL_SPIN: return "spincontrol";
+    case CGUIControl::GUICONTROL_SPINEX: return "spincontrolex";
+    case CGUIControl::GUICONTROL_TEXTBOX: return "textbox";
+    case CGUIControl::GUICONTROL_TOGGLEBUTTON: return "togglebutton";
+    case CGUIControl::GUICONTROL_VIDEO: return "videowindow";
+    case CGUIControl::GUICONTROL_GAME: return "gamewindow";
+    case CGUIControl::GUICONTROL_MOVER: return "mover";
+    case CGUIControl::GUICONTROL_RESIZE: return "resize";
+    case CGUIControl::GUICONTROL_EDIT: return "edit";
+    case CGUIControl::GUICONTROL_VISUALISATION: return "visualisation";
+    case CGUIControl::GUICONTROL_RENDERADDON: return "renderaddon";
+    case CGUIControl::GUICONTROL_MULTI_IMAGE: return "multiimage";
+    case CGUIControl::GUICONTROL_GROUP: return "group";
+    case CGUIControl::GUICONTROL_GROUPLIST: return "grouplist";
+    case CGUIControl::GUICONTROL_SCROLLBAR: return "scrollbar";
+    case CGUIControl::GUICONTROL_LISTLABEL: return "listlabel";
+    case CGUIControl::GUICONTROL_GAMECONTROLLER: return "gamecontroller";
+    case CGUIControl::GUICONTAINER_LIST: return "list";
+    case CGUIControl::GUICONTAINER_WRAPLIST: return "wraplist";
+    case CGUIControl::GUICONTAINER_FIXEDLIST: return "fixedlist";
+    case CGUIControl::GUICONTAINER_EPGGRID: return "epggrid";
+    case CGUIControl::GUICONTAINER_PANEL: return "panel";
+    case CGUIControl::GUICONTROL_RANGES: return "ranges";
+    default: return "unknown";
+  }
+}
+
+/*!
+ \brief Get the average, median, 90th and 99th percentile and maximum of values.
+ */
+CVariant Summarize(std::vector<double>& values)
+{
+  CVariant result(CVariant::VariantTypeObject);
+  if (values.empty())
+    return result;
+
+  std::sort(values.begin(), values.end());
+  double total = 0;
+  for (double value : values)
+    total += value;
+
+  // nearest rank, a percentile is a value that was measured
+  const auto percentile = [&values](double part) {
+    const size_t rank = static_cast<size_t>(ceil(part / 100.0 * values.size()));
+    return values[std::max<size_t>(rank, 1) - 1];
+  };
+
+  result["avg"] = total / values.size();
+  result["p50"] = percentile(50);
+  result["p90"] = percentile(90);
+  result["p99"] = percentile(99);
+  result["max"] = values.back();
+  return result;
+}
+} // unnamed namespace
+
+bool CGUIBenchmark::m_bIsRunning = false;
+
+CGUIBenchmark::CGUIBenchmark() = default;
+
+CGUIBenchmark::~CGUIBenchmark() = default;
+
+CGUIBenchmark& CGUIBenchmark::GetInstance()
+{
+  static CGUIBenchmark benchmark;
+  return benchmark;
+}
+
+bool CGUIBenchmark::Start(const std::string& script, bool quitWhenDone)
+{
+  if (m_bIsRunning)
+  {
+    CLog::Log(LOGERROR, "CGUIBenchmark::Start - a benchmark is running already");
+    return false;
+  }
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(script))
+  {
+    CLog::Log(LOGERROR, "CGUIBenchmark::Start - unable to load %s: %s at line %d", script.c_str(),
+              doc.ErrorDesc(), doc.ErrorRow());
+    return false;
+  }
+
+  const TiXmlElement* root = doc.RootElement();
+  if (!root || root->ValueStr() != "guibenchmark")
+  {
+    CLog::Log(LOGERROR, "CGUIBenchmark::Start - %s has no <guibenchmark> element", script.c_str());
+    return false;
+  }
+
+  m_output = GUIBENCHMARK_OUTPUT;
+  XMLUtils::GetPath(root, "output", m_output);
+  int frames = GUIBENCHMARK_FRAMES;
+  XMLUtils::GetInt(root, "frames", frames, 1, 100000);
+  int warmup = GUIBENCHMARK_WARMUP;
+  XMLUtils::GetInt(root, "warmup", warmup, 0, 100000);
+
+  m_windows.clear();
+  for (const TiXmlElement* element = root->FirstChildElement("window"); element;
+       element = element->NextSiblingElement("window"))
+  {
+    SWindow window;
+    window.name = element->FirstChild() ? element->FirstChild()->ValueStr() : "";
+    window.id = CWindowTranslator::TranslateWindow(window.name);
+    if (window.id == WINDOW_INVALID)
+    {
+      CLog::Log(LOGWARNING, "CGUIBenchmark::Start - skipping unknown window '%s'",
+                window.name.c_str());
+      continue;
+    }
+
+    int value;
+    window.frames = frames;
+    if (element->QueryIntAttribute("frames", &value) == TIXML_SUCCESS && value > 0)
+      window.frames = value;
+    window.items = 0;
+    if (element->QueryIntAttribute("items", &value) == TIXML_SUCCESS && value > 0)
+      window.items = value;
+    const char* path = element->Attribute("path");
+    if (path)
+      window.path = path;
+    m_windows.push_back(window);
+  }
+
+  if (m_windows.empty())
+  {
+    CLog::Log(LOGERROR, "CGUIBenchmark::Start - %s has no windows to open", script.c_str());
+    return false;
+  }
+
+  CGraphicContext& gfxContext = CServiceBroker::GetWinSystem()->GetGfxContext();
+  m_results.reset(new CVariant(CVariant::VariantTypeObject));
+  (*m_results)["script"] = script;
+  if (g_SkinInfo)
+  {
+    (*m_results)["skin"] = g_SkinInfo->ID();
+    (*m_results)["skinversion"] = g_SkinInfo->Version().asString();
+  }
+  (*m_results)["width"] = gfxContext.GetWidth();
+  (*m_results)["height"] = gfxContext.GetHeight();
+  (*m_results)["warmup"] = warmup;
+  (*m_results)["timeunit"] = "us";
+  (*m_results)["windows"] = CVariant(CVariant::VariantTypeArray);
+
+  m_warmup = warmup;
+  m_quitWhenDone = quitWhenDone;
+  m_current = 0;
+  m_frame = 0;
+  m_measuring = false;
+  m_bIsRunning = true;
+
+  CLog::Log(LOGINFO, "CGUIBenchmark::Start - running %s, %zu windows", script.c_str(),
+            m_windows.size());
+  return true;
+}
+
+void CGUIBenchmark::FrameMove()
+{
+  if (m_measuring)
+  {
+    // the previous frame was processed and rendered by now
+    const uint64_t evaluations = GetEvaluations();
+    m_sample.evaluations = evaluations - m_evaluations;
+    m_evaluations = evaluations;
+    m_samples.push_back(m_sample);
+    m_sample = {};
+
+    if (m_samples.size() >= m_windows[m_current].frames)
+    {
+      EndWindow();
+      m_current++;
+      m_frame = 0;
+    }
+  }
+
+  if (m_current >= m_windows.size())
+  {
+    Finish();
+    return;
+  }
+
+  if (m_frame == 0)
+    OpenWindow(m_windows[m_current]);
+  if (m_frame == m_warmup)
+    BeginWindow();
+  m_frame++;
+
+  // regions the skin didn't mark dirty would not be timed
+  CServiceBroker::GetGUI()->GetWindowManager().MarkDirty();
+}
+
+void CGUIBenchmark::OpenWindow(const SWindow& window)
+{
+  CLog::Log(LOGINFO, "CGUIBenchmark - opening %s", window.name.c_str());
+
+  CGUIWindowManager& windowManager = CServiceBroker::GetGUI()->GetWindowManager();
+  std::vector<std::string> params;
+  if (!window.path.empty())
+    params.push_back(window.path);
+  windowManager.ActivateWindow(window.id, params);
+
+  m_items.reset();
+  if (window.items == 0)
+    return;
+
+  CGUIWindow* pWindow = windowManager.GetWindow(window.id);
+  if (!pWindow || !pWindow->IsActive())
+  {
+    CLog::Log(LOGWARNING, "CGUIBenchmark - %s isn't open, not filling it", window.name.c_str());
+    return;
+  }
+
+  // the containers keep the items, the list only has to outlive the window
+  m_items.reset(new CFileItemList);
+  FillItems(*m_items, window.items);
+
+  std::vector<CGUIControl*> containers;
+  pWindow->GetContainers(containers);
+  for (CGUIControl* container : containers)
+  {
+    CGUIMessage message(GUI_MSG_LABEL_BIND, pWindow->GetID(), container->GetID(), 0, 0,
+                        m_items.get());
+    container->OnMessage(message);
+  }
+}
+
+void CGUIBenchmark::FillItems(CFileItemList& items, int count)
+{
+  static const char* const genres[] = {"Action", "Comedy", "Documentary",
+                                       "Drama", "Science Fiction", "Thriller"};
+  static const size_t genreCount = sizeof(genres) / sizeof(genres[0]);
+
+  items.SetContent("movies");
+  for (int i = 1; i <= count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("Movie %04d", i)));
+    item->SetPath(StringUtils::Format("videodb://movies/titles/%d", i));
+
+    const int year = 1960 + i % 60;
+    CVideoInfoTag* tag = item->GetVideoInfoTag();
+    tag->m_iDbId = i;
+    tag->m_type = MediaTypeMovie;
+    tag->SetTitle(item->GetLabel());
+    tag->SetYear(year);
+    tag->SetGenre({genres[i % genreCount], genres[(i / genreCount) % genreCount]});
+    tag->SetRating(static_cast<float>(i % 100) / 10.0f, i * 7);
+    tag->SetDuration(60 * (80 + i % 90));
+    tag->SetTagLine(StringUtils::Format("Tagline of movie %d", i));
+    tag->SetPlot(StringUtils::Format("Plot of movie %d, long enough to need a few lines in the "
+                                     "info panels of a skin and to have to be wrapped there.",
+                                     i));
+    tag->SetPlayCount(i % 3 == 0 ? 1 : 0);
+    item->SetLabel2(StringUtils::Format("%d", year));
+    items.Add(item);
+  }
+}
+
+void CGUIBenchmark::BeginWindow()
+{
+  m_measuring = true;
+  m_sample = {};
+  m_samples.clear();
+  m_samples.reserve(m_windows[m_current].frames);
+  m_evaluations = GetEvaluations();
+  m_heap = GetHeapInUse();
+}
+
+void CGUIBenchmark::EndWindow()
+{
+  m_measuring = false;
+
+  const SWindow& window = m_windows[m_current];
+  const double scale = 1000000.0 / CurrentHostFrequency();
+
+  CVariant result(CVariant::VariantTypeObject);
+  result["window"] = window.name;
+  result["id"] = window.id;
+  result["items"] = window.items;
+  result["frames"] = m_samples.size();
+
+  std::vector<double> values;
+  values.reserve(m_samples.size());
+  for (int pass = 0; pass < PASS_COUNT; pass++)
+  {
+    values.clear();
+    for (const auto& sample : m_samples)
+      values.push_back(sample.passes[pass] * scale);
+    result[PASS_NAMES[pass]] = Summarize(values);
+  }
+
+  values.clear();
+  for (const auto& sample : m_samples)
+    values.push_back((sample.passes[PASS_PROCESS] + sample.passes[PASS_RENDER]) * scale);
+  result["total"] = Summarize(values);
+  const double median = result["total"]["p50"].asDouble();
+
+  values.clear();
+  for (const auto& sample : m_samples)
+    values.push_back(static_cast<double>(sample.evaluations));
+  result["infobools"] = Summarize(values);
+
+  const int64_t heap = GetHeapInUse();
+  if (heap >= 0 && m_heap >= 0)
+    result["heapgrowth"] = heap - m_heap;
+
+  CVariant controls(CVariant::VariantTypeObject);
+  for (int type = 0; type < CONTROL_TYPES; type++)
+  {
+    CVariant control(CVariant::VariantTypeObject);
+    bool used = false;
+    for (int pass = 0; pass < PASS_COUNT; pass++)
+    {
+      values.clear();
+      for (const auto& sample : m_samples)
+      {
+        values.push_back(sample.controls[pass][type] * scale);
+        used |= sample.controls[pass][type] != 0;
+      }
+      control[PASS_NAMES[pass]] = Summarize(values);
+    }
+    if (used)
+      controls[GetTypeName(type)] = control;
+  }
+  result["controls"] = controls;
+
+  (*m_results)["windows"].push_back(result);
+  m_samples.clear();
+  m_items.reset();
+
+  CLog::Log(LOGINFO, "CGUIBenchmark - %s: %zu frames, median %.0fus per frame", window.name.c_str(),
+            static_cast<size_t>(result["frames"].asUnsignedInteger()), median);
+}
+
+void CGUIBenchmark::Finish()
+{
+  m_bIsRunning = false;
+  m_measuring = false;
+  m_items.reset();
+
+  std::string json;
+  XFILE::CFile output;
+  if (!CJSONVariantWriter::Write(*m_results, json, false) || !output.OpenForWrite(m_output, true) ||
+      output.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+    CLog::Log(LOGERROR, "CGUIBenchmark - unable to write the results to %s", m_output.c_str());
+  else
+    CLog::Log(LOGINFO, "CGUIBenchmark - results written to %s", m_output.c_str());
+  output.Close();
+  m_results.reset();
+
+  if (m_quitWhenDone)
+    CApplicationMessenger::GetInstance().PostMsg(TMSG_QUIT);
+}
+
+void CGUIBenchmark::BeginPass(Pass pass)
+{
+  m_pass = pass;
+  m_passStart = CurrentHostCounter();
+  m_children = 0;
+}
+
+void CGUIBenchmark::EndPass()
+{
+  if (m_measuring && m_pass != PASS_NONE)
+    m_sample.passes[m_pass] += CurrentHostCounter() - m_passStart;
+  m_pass = PASS_NONE;
+}
+
+void CGUIBenchmark::BeginControl(int64_t& start, int64_t& children)
+{
+  children = m_children;
+  m_children = 0;
+  start = CurrentHostCounter();
+}
+
+void CGUIBenchmark::EndControl(CGUIControl::GUICONTROLTYPES type, int64_t start, int64_t children)
+{
+  const int64_t elapsed = CurrentHostCounter() - start;
+  if (m_measuring && m_pass != PASS_NONE)
+    m_sample.controls[m_pass][type] += elapsed - m_children;
+  m_children = children + elapsed;
+}
@@ -0,0 +1,166 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "GUIControl.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CFileItemList;
+class CVariant;
+
+/*!
+ \brief Scripted benchmark of the skin, measures what its windows cost per frame.
+
+ The script lists the windows to open in turn, each with the frames to measure it for and
+ optionally a number of synthetic movies to fill its containers with:
+
+ \code{.xml}
+ <guibenchmark>
+   <output>special://temp/guibenchmark.json</output>
+   <frames>300</frames>  <!-- per window, unless the window says otherwise -->
+   <warmup>60</warmup>   <!-- frames before measuring, for animations and textures to settle -->
+   <window>Home</window>
+   <window frames="600" items="2000" path="videodb://movies/titles/">Videos</window>
+ </guibenchmark>
+ \endcode
+
+ Every frame all windows are marked dirty, so each one is rendered in full. A window is
+ measured for the time CGUIWindowManager spends processing and rendering it, the time spent
+ in each type of control (not counting the time of the controls within it), the InfoBools
+ evaluated and how much the heap grew. The results are written as JSON, with the median,
+ 90th and 99th percentile and maximum per frame. Times are wall-clock microseconds taken on
+ the application thread, not its CPU time: they include time the thread was preempted or
+ blocked, e.g. in the graphics driver, so run the benchmark on an otherwise idle system.
+ */
+class CGUIBenchmark
+{
+public:
+  enum Pass
+  {
+    PASS_NONE = -1,
+    PASS_PROCESS,
+    PASS_RENDER,
+    PASS_COUNT
+  };
+
+  static CGUIBenchmark& GetInstance();
+  static bool IsRunning() { return m_bIsRunning; }
+
+  /*!
+   \brief Load a script and start running it with the next frame.
+   \param script path of the script.
+   \param quitWhenDone quit the application once the results are written.
+   \return false if the script can't be loaded or has no windows.
+   */
+  bool Start(const std::string& script, bool quitWhenDone);
+
+  /*!
+   \brief Move on by a frame, opens the next window when the current one is done.
+   Called by the application before the windows are processed.
+   */
+  void FrameMove();
+
+  void BeginPass(Pass pass);
+  void EndPass();
+
+  /*!
+   \brief Get the time spent in the innermost control.
+   The controls within it have to be done already, time spent in them is subtracted.
+   */
+  void BeginControl(int64_t& start, int64_t& children);
+  void EndControl(CGUIControl::GUICONTROLTYPES type, int64_t start, int64_t children);
+
+private:
+  CGUIBenchmark();
+  ~CGUIBenchmark();
+  CGUIBenchmark(const CGUIBenchmark&) = delete;
+  CGUIBenchmark& operator=(const CGUIBenchmark&) = delete;
+
+  static const int CONTROL_TYPES = CGUIControl::GUICONTROL_RANGES + 1;
+
+  struct SWindow
+  {
+    int id;
+    std::string name;
+    std::string path;
+    unsigned int frames;
+    int items;
+  };
+
+  /*! \brief Host counter ticks spent in a frame */
+  struct SFrame
+  {
+    int64_t passes[PASS_COUNT];
+    int64_t controls[PASS_COUNT][CONTROL_TYPES];
+    uint64_t evaluations;
+  };
+
+  void OpenWindow(const SWindow& window);
+  void BeginWindow();
+  void EndWindow();
+  void Finish();
+  static void FillItems(CFileItemList& items, int count);
+
+  static bool m_bIsRunning;
+
+  std::vector<SWindow> m_windows;
+  std::string m_output;
+  unsigned int m_warmup = 0;
+  bool m_quitWhenDone = false;
+
+  size_t m_current = 0;          ///< window being measured
+  unsigned int m_frame = 0;      ///< frames since the window was opened
+  bool m_measuring = false;
+  std::unique_ptr<CFileItemList> m_items;
+
+  Pass m_pass = PASS_NONE;
+  int64_t m_passStart = 0;
+  int64_t m_children = 0;        ///< ticks spent in the controls done within the current one
+  SFrame m_sample = {};          ///< the frame being measured
+  std::vector<SFrame> m_samples; ///< the frames of the current window
+  uint64_t m_evaluations = 0;    ///< evaluation counter at the start of the frame
+  int64_t m_heap = 0;            ///< heap in use when measuring the window started
+
+  std::unique_ptr<CVariant> m_results;
+};
+
+/*!
+ \brief Times a control while the benchmark runs, does nothing otherwise.
+ */
+class CGUIBenchmarkControl
+{
+public:
+  explicit CGUIBenchmarkControl(CGUIControl::GUICONTROLTYPES type) : m_type(type)
+  {
+    if (CGUIBenchmark::IsRunning())
+    {
+      m_running = true;
+      CGUIBenchmark::GetInstance().BeginControl(m_start, m_children);
+    }
+  }
+
+  ~CGUIBenchmarkControl()
+  {
+    if (m_running)
+      CGUIBenchmark::GetInstance().EndControl(m_type, m_start, m_children);
+  }
+
+private:
+  CGUIBenchmarkControl(const CGUIBenchmarkControl&) = delete;
+  CGUIBenchmarkControl& operator=(const CGUIBenchmarkControl&) = delete;
+
+  CGUIControl::GUICONTROLTYPES m_type;
+  bool m_running = false;
+  int64_t m_start = 0;
+  int64_t m_children = 0;
+};
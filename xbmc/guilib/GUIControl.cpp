@@ -9,6 +9,7 @@
 #include "GUIControl.h"
 
 #include "GUIAction.h"
+#include "GUIBenchmark.h"
 #include "GUIComponent.h"
 #include "GUIControlProfiler.h"
 #include "GUIInfoManager.h"
@@ -117,6 +118,8 @@ void CGUIControl::DynamicResourceAlloc(bool bOnOff)
 // 3. reset the animation transform
 void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
+  CGUIBenchmarkControl benchmark(ControlType);
+
   CRect dirtyRegion = m_renderRegion;
 
   bool changed = (m_controlDirtyState & DIRTY_STATE_CONTROL) != 0 || (m_bInvalidated && IsVisible());
@@ -168,6 +171,8 @@ void CGUIControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregio
 // 3. reset the animation transform
 void CGUIControl::DoRender()
 {
+  CGUIBenchmarkControl benchmark(ControlType);
+
   if (IsVisible())
   {
     bool hasStereo = m_stereo != 0.0
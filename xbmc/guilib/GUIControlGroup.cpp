@@ -492,6 +492,17 @@ void CGUIControlGroup::SaveStates(std::vector<CControlState> &states)
     control->SaveStates(states);
 }
 
+void CGUIControlGroup::GetContainers(std::vector<CGUIControl *> &containers) const
+{
+  for (auto *control : m_children)
+  {
+    if (control->IsContainer())
+      containers.push_back(control);
+    else if (CGUIControlGroup *group = dynamic_cast<CGUIControlGroup *>(control))
+      group->GetContainers(containers);
+  }
+}
+
 // Note: This routine doesn't delete the control.  It just removes it from the control list
 bool CGUIControlGroup::RemoveControl(const CGUIControl *control)
 {
@@ -66,6 +66,11 @@ public:
 
   void SaveStates(std::vector<CControlState> &states) override;
 
+  /*! \brief Get the containers in this group and in the groups within it
+   \param containers [out] the containers are appended to this
+   */
+  void GetContainers(std::vector<CGUIControl *> &containers) const;
+
   bool IsGroup() const override { return true; };
 
 #ifdef _DEBUG
@@ -93,6 +93,7 @@ void CGUIIncludes::Clear()
   m_constants.clear();
   m_skinvariables.clear();
   m_files.clear();
+  m_fileConditions.clear();
   m_expressions.clear();
 }
 
@@ -104,6 +105,20 @@ void CGUIIncludes::Load(const std::string &file)
   FlattenSkinVariableConditions();
 }
 
+void CGUIIncludes::Load(const std::vector<std::string> &files)
+{
+  bool loaded = false;
+  for (const auto& file : files)
+  {
+    if (!HasLoaded(file) && Load_Internal(file))
+      loaded = true;
+  }
+  if (!loaded)
+    return;
+  FlattenExpressions();
+  FlattenSkinVariableConditions();
+}
+
 bool CGUIIncludes::Load_Internal(const std::string &file)
 {
   // check to see if we already have this loaded
@@ -232,7 +247,9 @@ void CGUIIncludes::LoadIncludes(const TiXmlElement *node)
 
       if (condition)
       { // load include file if condition evals to true
-        if (CServiceBroker::GetGUI()->GetInfoManager().Register(condition)->Get())
+        const bool result = CServiceBroker::GetGUI()->GetInfoManager().Register(condition)->Get();
+        m_fileConditions.insert(std::make_pair(condition, result));
+        if (result)
           Load_Internal(file);
       }
       else
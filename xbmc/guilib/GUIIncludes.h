@@ -43,6 +43,14 @@ public:
   */
   void Load(const std::string &file);
 
+  /*!
+   \brief Load the include components of those of \code{files} that aren't loaded yet, and only
+   then flatten the expressions and variable conditions.
+
+   \param files the files to load, as returned by GetFiles()
+  */
+  void Load(const std::vector<std::string> &files);
+
   /*!
    \brief Resolve all include components (defaults, constants, variables, expressions and includes)
    for the given \code{node}. Place the conditions specified for <include> elements in \code{includeConditions}.
@@ -61,6 +69,17 @@ public:
    */
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*!
+   \brief Get the files loaded so far, in the order they were loaded.
+   */
+  const std::vector<std::string>& GetFiles() const { return m_files; }
+
+  /*!
+   \brief Get the conditions of the include files loaded only if a condition held, with the
+   values they had. Files whose condition was false are in here too.
+   */
+  const std::map<std::string, bool>& GetFileConditions() const { return m_fileConditions; }
+
 private:
   enum ResolveParamsResult
   {
@@ -119,6 +138,7 @@ private:
   std::string ResolveExpressions(const std::string &expression) const;
 
   std::vector<std::string> m_files;
+  std::map<std::string, bool> m_fileConditions;
   std::map<std::string, std::pair<TiXmlElement, Params>> m_includes;
   std::map<std::string, TiXmlElement> m_defaults;
   std::map<std::string, TiXmlElement> m_skinvariables;
@@ -0,0 +1,420 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUISkinCache.h"
+
+#include "FileItem.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/GUIComponent.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+#define SKINCACHE_DIRECTORY "special://temp/skincache/"
+#define SKINCACHE_EXTENSION ".bin"
+#define SKINCACHE_MAGIC "KODI-SKINCACHE"
+// bump whenever the format of the stored windows changes
+#define SKINCACHE_VERSION 2
+
+namespace
+{
+enum NodeType : uint8_t
+{
+  NODE_END = 0,
+  NODE_ELEMENT,
+  NODE_TEXT,
+  NODE_CDATA,
+};
+
+void WriteUInt(std::string& data, uint32_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteInt64(std::string& data, int64_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string& data, const char* value)
+{
+  const uint32_t length = value ? strlen(value) : 0;
+  WriteUInt(data, length);
+  data.append(value ? value : "", length);
+}
+
+bool ReadUInt(const char*& data, const char* end, uint32_t& value)
+{
+  if (static_cast<size_t>(end - data) < sizeof(value))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return true;
+}
+
+bool ReadInt64(const char*& data, const char* end, int64_t& value)
+{
+  if (static_cast<size_t>(end - data) < sizeof(value))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return true;
+}
+
+bool ReadString(const char*& data, const char* end, std::string& value)
+{
+  uint32_t length;
+  if (!ReadUInt(data, end, length) || static_cast<size_t>(end - data) < length)
+    return false;
+  value.assign(data, length);
+  data += length;
+  return true;
+}
+
+/*!
+ \brief Get what identifies the content of a file, its modification time and size.
+ */
+bool GetFileStamp(const std::string& file, int64_t& time, int64_t& size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(file, &buffer) != 0)
+    return false;
+  time = static_cast<int64_t>(buffer.st_mtime);
+  size = static_cast<int64_t>(buffer.st_size);
+  return true;
+}
+
+bool WriteFileStamp(std::string& data, const std::string& file)
+{
+  int64_t time, size;
+  if (!GetFileStamp(file, time, size))
+    return false;
+  WriteString(data, file.c_str());
+  WriteInt64(data, time);
+  WriteInt64(data, size);
+  return true;
+}
+
+bool ReadFileStamp(const char*& data, const char* end, std::string& file, bool check)
+{
+  int64_t time, size;
+  if (!ReadString(data, end, file) || !ReadInt64(data, end, time) || !ReadInt64(data, end, size))
+    return false;
+
+  int64_t currentTime, currentSize;
+  return !check || (GetFileStamp(file, currentTime, currentSize) && currentTime == time &&
+                    currentSize == size);
+}
+} // unnamed namespace
+
+void CGUISkinCache::Configure(const std::string& skinKey)
+{
+  CSingleLock lock(m_section);
+  m_windows.clear();
+  m_directory.clear();
+
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiSkinCache)
+    return;
+
+  // windows of other skins are of no use anymore
+  const std::string name = CDigest::Calculate(CDigest::Type::MD5, skinKey);
+  CFileItemList items;
+  CDirectory::GetDirectory(SKINCACHE_DIRECTORY, items, "", DIR_FLAG_BYPASS_CACHE);
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder && item->GetLabel() != name)
+      CDirectory::RemoveRecursive(item->GetPath());
+  }
+
+  const std::string directory = SKINCACHE_DIRECTORY + name + "/";
+  if ((!CDirectory::Exists(SKINCACHE_DIRECTORY) && !CDirectory::Create(SKINCACHE_DIRECTORY)) ||
+      (!CDirectory::Exists(directory) && !CDirectory::Create(directory)))
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Configure - unable to create %s, windows are not stored",
+              directory.c_str());
+    return;
+  }
+  m_directory = directory;
+}
+
+std::string CGUISkinCache::GetFileName(const std::string& path) const
+{
+  return m_directory + CDigest::Calculate(CDigest::Type::MD5, path) + SKINCACHE_EXTENSION;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Load(const std::string& path,
+                                                  std::map<INFO::InfoPtr, bool>& includeConditions,
+                                                  std::vector<std::string>& includeFiles)
+{
+  CSingleLock lock(m_section);
+
+  // windows read from disk have to be checked against the files they were resolved from,
+  // the ones in memory were checked already or are stored by this session
+  auto it = m_windows.find(path);
+  const bool check = it == m_windows.end();
+  if (check)
+  {
+    if (m_directory.empty())
+      return nullptr;
+
+    auto_buffer buffer;
+    CFile file;
+    if (file.LoadFile(GetFileName(path), buffer) <= 0)
+      return nullptr;
+    it = m_windows.emplace(path, std::string(buffer.get(), buffer.size())).first;
+  }
+
+  const char* data = it->second.c_str();
+  const char* end = data + it->second.size();
+
+  std::string value;
+  uint32_t version, count;
+  if (!ReadString(data, end, value) || value != SKINCACHE_MAGIC ||
+      !ReadUInt(data, end, version) || version != SKINCACHE_VERSION ||
+      !ReadString(data, end, value) || value != path)
+  {
+    Remove(path);
+    return nullptr;
+  }
+
+  // the window file itself followed by the include files
+  std::vector<std::string> files;
+  if (!ReadUInt(data, end, count))
+  {
+    Remove(path);
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (!ReadFileStamp(data, end, value, check))
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache::Load - %s changed, resolving %s again", value.c_str(),
+                path.c_str());
+      Remove(path);
+      return nullptr;
+    }
+    if (i > 0)
+      files.push_back(value);
+  }
+
+  // so do the include files loaded, or not loaded
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  if (!ReadUInt(data, end, count))
+  {
+    Remove(path);
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (!ReadString(data, end, value) || data == end)
+    {
+      Remove(path);
+      return nullptr;
+    }
+    const bool result = *data++ != 0;
+
+    INFO::InfoPtr condition = infoMgr.Register(value);
+    if (!condition || condition->Get() != result)
+      return nullptr;
+  }
+
+  // the includes taken depend on their conditions
+  std::map<INFO::InfoPtr, bool> conditions;
+  if (!ReadUInt(data, end, count))
+  {
+    Remove(path);
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (!ReadString(data, end, value) || data == end)
+    {
+      Remove(path);
+      return nullptr;
+    }
+    const bool result = *data++ != 0;
+
+    INFO::InfoPtr condition = infoMgr.Register(value);
+    if (!condition || condition->Get() != result)
+      return nullptr;
+    conditions.insert(std::make_pair(condition, result));
+  }
+
+  std::unique_ptr<TiXmlElement> window = Deserialize(data, end);
+  if (!window)
+  {
+    Remove(path);
+    return nullptr;
+  }
+
+  includeConditions = std::move(conditions);
+  includeFiles = std::move(files);
+  return window;
+}
+
+void CGUISkinCache::Store(const std::string& path,
+                          const TiXmlElement& window,
+                          const std::map<INFO::InfoPtr, bool>& includeConditions,
+                          const std::vector<std::string>& includeFiles,
+                          const std::map<std::string, bool>& fileConditions)
+{
+  std::string data;
+  WriteString(data, SKINCACHE_MAGIC);
+  WriteUInt(data, SKINCACHE_VERSION);
+  WriteString(data, path.c_str());
+
+  // a window that can't be checked for changes isn't kept
+  WriteUInt(data, includeFiles.size() + 1);
+  if (!WriteFileStamp(data, path))
+    return;
+  for (const auto& file : includeFiles)
+  {
+    if (!WriteFileStamp(data, file))
+      return;
+  }
+
+  WriteUInt(data, fileConditions.size());
+  for (const auto& condition : fileConditions)
+  {
+    WriteString(data, condition.first.c_str());
+    data += static_cast<char>(condition.second);
+  }
+
+  WriteUInt(data, includeConditions.size());
+  for (const auto& condition : includeConditions)
+  {
+    WriteString(data, condition.first->GetExpression().c_str());
+    data += static_cast<char>(condition.second);
+  }
+
+  Serialize(window, data);
+
+  CSingleLock lock(m_section);
+  m_windows[path] = data;
+  if (m_directory.empty())
+    return;
+
+  // write next to the window first, a half written file must not be found
+  const std::string fileName = GetFileName(path);
+  const std::string tempName = fileName + ".tmp";
+  CFile file;
+  if (!file.OpenForWrite(tempName, true) ||
+      file.Write(data.c_str(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    file.Close();
+    CFile::Delete(tempName);
+    return;
+  }
+  file.Close();
+
+  CFile::Delete(fileName);
+  if (!CFile::Rename(tempName, fileName))
+    CFile::Delete(tempName);
+}
+
+void CGUISkinCache::Remove(const std::string& path)
+{
+  m_windows.erase(path);
+  if (!m_directory.empty())
+    CFile::Delete(GetFileName(path));
+}
+
+void CGUISkinCache::Serialize(const TiXmlElement& element, std::string& data)
+{
+  data += static_cast<char>(NODE_ELEMENT);
+  WriteString(data, element.Value());
+
+  uint32_t attributes = 0;
+  for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute;
+       attribute = attribute->Next())
+    attributes++;
+  WriteUInt(data, attributes);
+  for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute;
+       attribute = attribute->Next())
+  {
+    WriteString(data, attribute->Name());
+    WriteString(data, attribute->Value());
+  }
+
+  // comments and declarations don't make it into controls
+  for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+  {
+    const TiXmlElement* childElement = child->ToElement();
+    const TiXmlText* text = child->ToText();
+    if (childElement)
+      Serialize(*childElement, data);
+    else if (text)
+    {
+      data += static_cast<char>(text->CDATA() ? NODE_CDATA : NODE_TEXT);
+      WriteString(data, text->Value());
+    }
+  }
+
+  data += static_cast<char>(NODE_END);
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Deserialize(const char*& data, const char* end)
+{
+  std::string name, value;
+  uint32_t attributes;
+  if (data == end || *data++ != NODE_ELEMENT || !ReadString(data, end, name) ||
+      !ReadUInt(data, end, attributes))
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> element(new TiXmlElement(name.c_str()));
+  for (uint32_t i = 0; i < attributes; i++)
+  {
+    if (!ReadString(data, end, name) || !ReadString(data, end, value))
+      return nullptr;
+    element->SetAttribute(name.c_str(), value.c_str());
+  }
+
+  while (data != end)
+  {
+    const uint8_t type = static_cast<uint8_t>(*data);
+    if (type == NODE_END)
+    {
+      data++;
+      return element;
+    }
+    else if (type == NODE_ELEMENT)
+    {
+      std::unique_ptr<TiXmlElement> child = Deserialize(data, end);
+      if (!child)
+        return nullptr;
+      element->LinkEndChild(child.release());
+    }
+    else if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      data++;
+      if (!ReadString(data, end, value))
+        return nullptr;
+      TiXmlText* text = new TiXmlText(value.c_str());
+      text->SetCDATA(type == NODE_CDATA);
+      element->LinkEndChild(text);
+    }
+    else
+      return nullptr;
+  }
+
+  // missing the end of the element
+  return nullptr;
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TiXmlElement;
+
+/*!
+ \brief Cache of skin windows with their includes, constants and expressions resolved.
+
+ A resolved <window> element is kept in a compact binary form, in memory and on disk,
+ together with the conditions of the includes it took, the files it was resolved from and
+ the conditions those files were loaded on. It is used instead of loading and resolving the
+ window again as long as these files are unchanged and the conditions still have the values
+ they had when it was resolved.
+
+ Every skin version gets a directory of its own, the windows stored for any other skin
+ are dropped when a skin is loaded. The disk cache is turned on with
+ <gui><skincache>true</skincache></gui> in advancedsettings.xml.
+ */
+class CGUISkinCache
+{
+public:
+  /*!
+   \brief Start caching the windows of a skin.
+   \param skinKey identifies the skin and its version.
+   */
+  void Configure(const std::string& skinKey);
+
+  /*!
+   \brief Get a resolved window.
+   \param path the xml file of the window.
+   \param includeConditions [out] the conditions of the includes in the window and their values.
+   \param includeFiles [out] the include files the window was resolved with.
+   \return the <window> element, nullptr if it isn't cached or is out of date.
+   */
+  std::unique_ptr<TiXmlElement> Load(const std::string& path,
+                                     std::map<INFO::InfoPtr, bool>& includeConditions,
+                                     std::vector<std::string>& includeFiles);
+
+  /*!
+   \brief Keep a resolved window.
+   \param path the xml file of the window.
+   \param window the <window> element with all includes resolved.
+   \param includeConditions the conditions of the includes as they were evaluated.
+   \param includeFiles the include files the window was resolved with.
+   \param fileConditions the conditions include files were loaded on, or not, and their values.
+   */
+  void Store(const std::string& path,
+             const TiXmlElement& window,
+             const std::map<INFO::InfoPtr, bool>& includeConditions,
+             const std::vector<std::string>& includeFiles,
+             const std::map<std::string, bool>& fileConditions);
+
+  /*!
+   \brief Append an element, its attributes, text and child elements to data.
+   */
+  static void Serialize(const TiXmlElement& element, std::string& data);
+
+  /*!
+   \brief Rebuild an element written by Serialize.
+   \param data [in,out] start of the element, moved past it.
+   \param end end of the data.
+   \return the element, nullptr if the data is truncated or invalid.
+   */
+  static std::unique_ptr<TiXmlElement> Deserialize(const char*& data, const char* end);
+
+private:
+  std::string GetFileName(const std::string& path) const;
+  void Remove(const std::string& path);
+
+  CCriticalSection m_section;
+  std::string m_directory; ///< empty if windows are only cached in memory
+  std::map<std::string, std::string> m_windows; ///< serialized windows by path
+};
@@ -9,6 +9,7 @@
 #include "GUITexture.h"
 
 #include "GUILargeTextureManager.h"
+#include "TextureCache.h"
 #include "TextureManager.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
@@ -294,8 +295,10 @@ bool CGUITexture::AllocResources()
     }
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
+      if (!IsAllocated())
+        m_largePath = GetLargeImagePath();
       CTextureArray texture;
-      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_largePath, texture, !IsAllocated(), m_use_cache))
       {
         m_isAllocated = LARGE;
 
@@ -339,6 +342,22 @@ bool CGUITexture::AllocResources()
   return changed;
 }
 
+std::string CGUITexture::GetLargeImagePath() const
+{
+  // a control that always shows the whole image doesn't need more pixels than it covers
+  if (!m_use_cache || m_aspect.ratio != CAspectRatio::AR_KEEP)
+    return m_info.filename;
+
+  const CGraphicContext& context = CServiceBroker::GetWinSystem()->GetGfxContext();
+  const float width = m_width * context.GetGUIScaleX();
+  const float height = m_height * context.GetGUIScaleY();
+  if (width <= 0 || height <= 0)
+    return m_info.filename;
+
+  return CTextureCache::GetInstance().GetImageVariant(m_info.filename, MathUtils::round_int(width),
+                                                      MathUtils::round_int(height));
+}
+
 bool CGUITexture::CalculateSize()
 {
   if (m_currentFrame >= m_texture.size())
@@ -437,7 +456,7 @@ bool CGUITexture::CalculateSize()
 void CGUITexture::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_largePath, immediately || (m_isAllocated == LARGE_FAILED));
   else if (m_isAllocated == NORMAL && m_texture.size())
     CServiceBroker::GetGUI()->GetTextureManager().ReleaseTexture(m_info.filename, immediately);
 
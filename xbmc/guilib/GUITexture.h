@@ -127,6 +127,7 @@ protected:
               float v3);
   static void OrientateTexture(CRect &rect, float width, float height, int orientation);
   void ResetAnimState();
+  std::string GetLargeImagePath() const;
 
   // functions that our implementation classes handle
   virtual void Allocate() {}; ///< called after our textures have been allocated
@@ -170,6 +171,7 @@ protected:
   ALLOCATE_TYPE m_isAllocated;
 
   CTextureInfo m_info;
+  std::string m_largePath; // path requested from the large texture manager
   CAspectRatio m_aspect;
 
   CTextureArray m_diffuse;
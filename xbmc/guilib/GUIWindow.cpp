@@ -125,6 +125,14 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  // a window resolved before doesn't need its xml as long as the include conditions still match
+  std::unique_ptr<TiXmlElement> cachedRoot = g_SkinInfo->GetCachedWindow(strPath, &m_xmlIncludeConditions);
+  if (cachedRoot)
+  {
+    CLog::Log(LOGDEBUG, "Using cached skin file %s", strPath.c_str());
+    return Load(cachedRoot.get());
+  }
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
@@ -151,7 +159,9 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  std::unique_ptr<TiXmlElement> preparedRoot = Prepare(m_windowXMLRootElement);
+  g_SkinInfo->CacheWindow(strPath, preparedRoot.get(), m_xmlIncludeConditions);
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
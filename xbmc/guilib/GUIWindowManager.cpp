@@ -10,6 +10,7 @@
 
 #include "Application.h"
 #include "GUIAudioManager.h"
+#include "GUIBenchmark.h"
 #include "GUIDialog.h"
 #include "GUIInfoManager.h"
 #include "GUIPassword.h"
@@ -39,6 +40,7 @@
 #include "settings/windows/GUIWindowSettingsScreenCalibration.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -1096,6 +1098,10 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CTraceZone zone("WindowManager::Process");
+
+  if (CGUIBenchmark::IsRunning())
+    CGUIBenchmark::GetInstance().BeginPass(CGUIBenchmark::PASS_PROCESS);
 
   m_dirtyregions.clear();
 
@@ -1113,6 +1119,9 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   for (auto& itr : m_dirtyregions)
     m_tracker.MarkDirtyRegion(itr);
+
+  if (CGUIBenchmark::IsRunning())
+    CGUIBenchmark::GetInstance().EndPass();
 }
 
 void CGUIWindowManager::MarkDirty()
@@ -1177,6 +1186,10 @@ bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CTraceZone zone("WindowManager::Render");
+
+  if (CGUIBenchmark::IsRunning())
+    CGUIBenchmark::GetInstance().BeginPass(CGUIBenchmark::PASS_RENDER);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
@@ -1219,6 +1232,9 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(i, 0x4c00ff00);
   }
 
+  if (CGUIBenchmark::IsRunning())
+    CGUIBenchmark::GetInstance().EndPass();
+
   return hasRendered;
 }
 
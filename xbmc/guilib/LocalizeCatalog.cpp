@@ -0,0 +1,301 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LocalizeCatalog.h"
+
+#include "LocalizeStrings.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+#ifdef TARGET_POSIX
+#include "filesystem/SpecialProtocol.h"
+#include "platform/posix/utils/Mmap.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+#define CATALOG_MAGIC "KODI-STRINGS"
+// bump whenever the format of the catalog changes
+#define CATALOG_VERSION 1
+
+namespace
+{
+void WriteUInt(std::string& data, uint32_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteInt64(std::string& data, int64_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string& data, const std::string& value)
+{
+  WriteUInt(data, static_cast<uint32_t>(value.size()));
+  data.append(value);
+}
+
+bool ReadUInt(const char*& data, const char* end, uint32_t& value)
+{
+  if (static_cast<size_t>(end - data) < sizeof(value))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return true;
+}
+
+bool ReadInt64(const char*& data, const char* end, int64_t& value)
+{
+  if (static_cast<size_t>(end - data) < sizeof(value))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return true;
+}
+
+bool ReadString(const char*& data, const char* end, std::string& value)
+{
+  uint32_t length;
+  if (!ReadUInt(data, end, length) || static_cast<size_t>(end - data) < length)
+    return false;
+  value.assign(data, length);
+  data += length;
+  return true;
+}
+
+/*!
+ \brief Get what identifies the content of a file, its modification time and size.
+ */
+bool GetFileStamp(const std::string& file, int64_t& time, int64_t& size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(file, &buffer) != 0)
+    return false;
+  time = static_cast<int64_t>(buffer.st_mtime);
+  size = static_cast<int64_t>(buffer.st_size);
+  return true;
+}
+} // unnamed namespace
+
+CLocalizeCatalog::~CLocalizeCatalog()
+{
+  if (m_strings)
+  {
+    for (size_t i = 0; i < m_count; i++)
+      delete m_strings[i].load();
+  }
+}
+
+std::unique_ptr<CLocalizeCatalog> CLocalizeCatalog::Open(const std::string& file,
+                                                         const std::vector<std::string>& sources)
+{
+  std::unique_ptr<CLocalizeCatalog> catalog(new CLocalizeCatalog);
+
+#ifdef TARGET_POSIX
+  const int fd = open(CSpecialProtocol::TranslatePath(file).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    try
+    {
+      // the pages are shared with every other load of the same strings
+      catalog->m_map.reset(new KODI::UTILS::POSIX::CMmap(
+          nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0));
+      catalog->m_data = static_cast<const char*>(catalog->m_map->Data());
+      catalog->m_size = catalog->m_map->Size();
+    }
+    catch (const std::system_error&)
+    {
+      // fall back to reading the catalog
+    }
+  }
+  close(fd);
+#endif
+
+  if (!catalog->m_data)
+  {
+    CFile input;
+    auto_buffer buffer;
+    if (input.LoadFile(file, buffer) <= 0)
+      return nullptr;
+
+    catalog->m_buffer.assign(buffer.get(), buffer.size());
+    catalog->m_data = catalog->m_buffer.data();
+    catalog->m_size = catalog->m_buffer.size();
+  }
+
+  if (!catalog->Parse(sources, true))
+    return nullptr;
+
+  return catalog;
+}
+
+std::unique_ptr<CLocalizeCatalog> CLocalizeCatalog::Create(const std::string& file,
+                                                           const std::vector<std::string>& sources,
+                                                           const std::map<uint32_t, LocStr>& strings)
+{
+  std::string data;
+  WriteString(data, CATALOG_MAGIC);
+  WriteUInt(data, CATALOG_VERSION);
+  WriteUInt(data, static_cast<uint32_t>(sources.size()));
+  for (const auto& source : sources)
+  {
+    int64_t time = 0, size = 0;
+    GetFileStamp(source, time, size);
+    WriteString(data, source);
+    WriteInt64(data, time);
+    WriteInt64(data, size);
+  }
+  // the table is read in place
+  data.append((alignof(SEntry) - data.size() % alignof(SEntry)) % alignof(SEntry), '\0');
+
+  std::string pool;
+  std::vector<SEntry> entries;
+  entries.reserve(strings.size());
+  for (const auto& it : strings)
+  {
+    entries.push_back({it.first, static_cast<uint32_t>(pool.size()),
+                       static_cast<uint32_t>(it.second.strTranslated.size())});
+    pool.append(it.second.strTranslated);
+    pool.push_back('\0');
+  }
+
+  WriteUInt(data, static_cast<uint32_t>(entries.size()));
+  WriteUInt(data, static_cast<uint32_t>(pool.size()));
+  data.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SEntry));
+  data.append(pool);
+
+  // written next to the catalog and renamed, so the catalog stays intact for those that mapped it
+  const std::string temp = file + ".tmp";
+  CFile output;
+  if (CDirectory::Create(URIUtils::GetDirectory(file)) && output.OpenForWrite(temp, true) &&
+      output.Write(data.c_str(), data.size()) == static_cast<ssize_t>(data.size()))
+  {
+    output.Close();
+    if (CFile::Rename(temp, file))
+    {
+      std::unique_ptr<CLocalizeCatalog> catalog = Open(file, sources);
+      if (catalog)
+        return catalog;
+    }
+    else
+      CFile::Delete(temp);
+  }
+  else
+    CLog::Log(LOGWARNING, "CLocalizeCatalog::Create - unable to write %s, keeping it in memory",
+              file.c_str());
+
+  std::unique_ptr<CLocalizeCatalog> catalog(new CLocalizeCatalog);
+  catalog->m_buffer = std::move(data);
+  catalog->m_data = catalog->m_buffer.data();
+  catalog->m_size = catalog->m_buffer.size();
+  if (!catalog->Parse(sources, false))
+    return nullptr;
+
+  return catalog;
+}
+
+bool CLocalizeCatalog::Parse(const std::vector<std::string>& sources, bool checkSources)
+{
+  const char* data = m_data;
+  const char* end = m_data + m_size;
+
+  std::string value;
+  uint32_t version, nofSources;
+  if (!ReadString(data, end, value) || value != CATALOG_MAGIC || !ReadUInt(data, end, version) ||
+      version != CATALOG_VERSION || !ReadUInt(data, end, nofSources) ||
+      nofSources != sources.size())
+    return false;
+
+  for (const auto& source : sources)
+  {
+    int64_t time, size, currentTime, currentSize;
+    if (!ReadString(data, end, value) || value != source || !ReadInt64(data, end, time) ||
+        !ReadInt64(data, end, size))
+      return false;
+
+    if (checkSources && (!GetFileStamp(source, currentTime, currentSize) ||
+                         currentTime != time || currentSize != size))
+      return false;
+  }
+
+  const size_t padding = (alignof(SEntry) - (data - m_data) % alignof(SEntry)) % alignof(SEntry);
+  if (static_cast<size_t>(end - data) < padding)
+    return false;
+  data += padding;
+
+  uint32_t count, poolSize;
+  if (!ReadUInt(data, end, count) || !ReadUInt(data, end, poolSize) ||
+      static_cast<uint64_t>(end - data) < static_cast<uint64_t>(count) * sizeof(SEntry) + poolSize ||
+      reinterpret_cast<uintptr_t>(data) % alignof(SEntry) != 0)
+    return false;
+
+  m_entries = reinterpret_cast<const SEntry*>(data);
+  m_count = count;
+  m_pool = data + m_count * sizeof(SEntry);
+  for (size_t i = 0; i < m_count; i++)
+  {
+    if (static_cast<uint64_t>(m_entries[i].offset) + m_entries[i].length > poolSize)
+      return false;
+  }
+
+  m_strings.reset(new std::atomic<std::string*>[m_count]());
+  return true;
+}
+
+const CLocalizeCatalog::SEntry* CLocalizeCatalog::Find(uint32_t id) const
+{
+  const SEntry* last = m_entries + m_count;
+  const SEntry* entry = std::lower_bound(
+      m_entries, last, id, [](const SEntry& entry, uint32_t id) { return entry.id < id; });
+  if (entry == last || entry->id != id)
+    return nullptr;
+  return entry;
+}
+
+const std::string* CLocalizeCatalog::Get(uint32_t id) const
+{
+  const SEntry* entry = Find(id);
+  if (!entry)
+    return nullptr;
+
+  std::atomic<std::string*>& slot = m_strings[entry - m_entries];
+  std::string* value = slot.load(std::memory_order_acquire);
+  if (value)
+    return value;
+
+  // readers share a lock, the first one to create the string keeps it
+  std::unique_ptr<std::string> created(new std::string(m_pool + entry->offset, entry->length));
+  if (slot.compare_exchange_strong(value, created.get(), std::memory_order_acq_rel))
+    return created.release();
+  return value;
+}
+
+bool CLocalizeCatalog::Get(uint32_t id, std::string& value) const
+{
+  const SEntry* entry = Find(id);
+  if (!entry)
+    return false;
+
+  value.assign(m_pool + entry->offset, entry->length);
+  return true;
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifdef TARGET_POSIX
+namespace KODI
+{
+namespace UTILS
+{
+namespace POSIX
+{
+class CMmap;
+}
+}
+}
+#endif
+
+struct LocStr;
+
+/*!
+ \brief Compiled form of the strings loaded from strings.po files.
+
+ A catalog file holds the modification time and size of the strings.po files it was
+ compiled from, a table of the string ids, sorted, and a pool of the translated strings
+ the table points into. It is mapped into memory (or read in one go where mapping isn't
+ available), so loading the strings again doesn't parse the po files nor allocate a
+ string per id, and looking one up is a binary search of the table.
+ */
+class CLocalizeCatalog
+{
+public:
+  ~CLocalizeCatalog();
+
+  /*!
+   \brief Open a catalog file if it was compiled from the given files as they are now.
+   \param file the catalog file.
+   \param sources the strings.po files, in the order they were loaded in.
+   \return the catalog, nullptr if it's missing, damaged or older than its sources.
+   */
+  static std::unique_ptr<CLocalizeCatalog> Open(const std::string& file,
+                                                const std::vector<std::string>& sources);
+
+  /*!
+   \brief Compile strings into a catalog file and open it.
+   \param file the catalog file, replaced if it exists. When it can't be written the catalog is
+   kept in memory.
+   \param sources the strings.po files the strings were loaded from.
+   \param strings the strings to compile, only the translated strings are kept.
+   */
+  static std::unique_ptr<CLocalizeCatalog> Create(const std::string& file,
+                                                  const std::vector<std::string>& sources,
+                                                  const std::map<uint32_t, LocStr>& strings);
+
+  /*!
+   \brief Get the string with the given id.
+   \return the string, nullptr if the catalog has none with this id. The string is created on
+   first use and stays valid as long as the catalog.
+   */
+  const std::string* Get(uint32_t id) const;
+
+  /*!
+   \brief Copy the string with the given id without keeping it around.
+   \return false if the catalog has no string with this id.
+   */
+  bool Get(uint32_t id, std::string& value) const;
+
+  size_t Size() const { return m_count; }
+
+private:
+  CLocalizeCatalog() = default;
+  CLocalizeCatalog(const CLocalizeCatalog&) = delete;
+  CLocalizeCatalog& operator=(const CLocalizeCatalog&) = delete;
+
+  struct SEntry
+  {
+    uint32_t id;
+    uint32_t offset; ///< offset of the string in the pool
+    uint32_t length;
+  };
+
+  bool Parse(const std::vector<std::string>& sources, bool checkSources);
+  const SEntry* Find(uint32_t id) const;
+
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+#ifdef TARGET_POSIX
+  std::unique_ptr<KODI::UTILS::POSIX::CMmap> m_map;
+#endif
+  std::string m_buffer; ///< the catalog when it isn't mapped
+
+  const SEntry* m_entries = nullptr;
+  size_t m_count = 0;
+  const char* m_pool = nullptr;
+  mutable std::unique_ptr<std::atomic<std::string*>[]> m_strings; ///< created by Get(), per entry
+};
@@ -13,11 +13,18 @@
 #include "filesystem/SpecialProtocol.h"
 #include "threads/SharedSection.h"
 #include "utils/CharsetConverter.h"
+#include "utils/Digest.h"
 #include "utils/POUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <vector>
+
+using KODI::UTILITY::CDigest;
+
+#define CATALOG_DIRECTORY "special://temp/strings/"
+#define CATALOG_EXTENSION ".bin"
 
 /*! \brief Tries to load ids and strings from a strings.po file to the `strings` map.
  * It should only be called from the LoadStr2Mem function to have a fallback.
@@ -83,16 +90,12 @@ static bool LoadPO(const std::string &filename, std::map<uint32_t, LocStr>& stri
   return true;
 }
 
-/*! \brief Loads language ids and strings to memory map `strings`.
+/*! \brief Finds the strings file of a language.
  \param pathname The directory name, where we look for the strings file.
- \param language We load the strings for this language. Fallback language is always English.
- \param strings [out] The resulting strings map.
- \param encoding Encoding of the strings. For PO files we only use utf-8.
- \param offset An offset value to place strings from the id value.
- \return false if no strings.po file was loaded.
+ \param language The language of the strings.
+ \return the path of the strings.po file, empty if there's no directory for the language.
  */
-static bool LoadStr2Mem(const std::string &pathname_in, const std::string &language,
-    std::map<uint32_t, LocStr>& strings,  std::string &encoding, uint32_t offset = 0 )
+static std::string GetPOFile(const std::string &pathname_in, const std::string &language)
 {
   std::string pathname = CSpecialProtocol::TranslatePathConvertCase(pathname_in + language);
   if (!XFILE::CDirectory::Exists(pathname))
@@ -107,12 +110,30 @@ static bool LoadStr2Mem(const std::string &pathname_in, const std::string &langu
     }
 
     if (!exists)
-      return false;
+      return "";
   }
 
+  return URIUtils::AddFileToFolder(pathname, "strings.po");
+}
+
+/*! \brief Loads language ids and strings to memory map `strings`.
+ \param pathname The directory name, where we look for the strings file.
+ \param language We load the strings for this language. Fallback language is always English.
+ \param strings [out] The resulting strings map.
+ \param encoding Encoding of the strings. For PO files we only use utf-8.
+ \param offset An offset value to place strings from the id value.
+ \return false if no strings.po file was loaded.
+ */
+static bool LoadStr2Mem(const std::string &pathname_in, const std::string &language,
+    std::map<uint32_t, LocStr>& strings,  std::string &encoding, uint32_t offset = 0 )
+{
+  const std::string filename = GetPOFile(pathname_in, language);
+  if (filename.empty())
+    return false;
+
   bool useSourceLang = StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT) || StringUtils::EqualsNoCase(language, LANGUAGE_OLD_DEFAULT);
 
-  return LoadPO(URIUtils::AddFileToFolder(pathname, "strings.po"), strings, encoding, offset, useSourceLang);
+  return LoadPO(filename, strings, encoding, offset, useSourceLang);
 }
 
 static bool LoadWithFallback(const std::string& path, const std::string& language, std::map<uint32_t, LocStr>& strings)
@@ -131,33 +152,8 @@ static bool LoadWithFallback(const std::string& path, const std::string& languag
   return true;
 }
 
-CLocalizeStrings::CLocalizeStrings(void) = default;
-
-CLocalizeStrings::~CLocalizeStrings(void) = default;
-
-void CLocalizeStrings::ClearSkinStrings()
+static void AddConstantStrings(std::map<uint32_t, LocStr>& strings)
 {
-  // clear the skin strings
-  CExclusiveLock lock(m_stringsMutex);
-  Clear(31000, 31999);
-}
-
-bool CLocalizeStrings::LoadSkinStrings(const std::string& path, const std::string& language)
-{
-  //! @todo shouldn't hold lock while loading file
-  CExclusiveLock lock(m_stringsMutex);
-  ClearSkinStrings();
-  // load the skin strings in.
-  return LoadWithFallback(path, language, m_strings);
-}
-
-bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& strLanguage)
-{
-  std::map<uint32_t, LocStr> strings;
-  if (!LoadWithFallback(strPathName, strLanguage, strings))
-    return false;
-
-  // fill in the constant strings
   strings[20022].strTranslated = "";
   strings[20027].strTranslated = "°F";
   strings[20028].strTranslated = "K";
@@ -180,6 +176,75 @@ bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& s
   strings[20209].strTranslated = "inch/s";
   strings[20210].strTranslated = "yard/s";
   strings[20211].strTranslated = "Furlong/Fortnight";
+}
+
+/*! \brief Loads the compiled catalog of the strings of a language and its fallback.
+ The catalog is compiled from the strings.po files the first time and again whenever they
+ changed, afterwards it's only mapped.
+ \param path The directory name, where we look for the strings files.
+ \param language We load the strings for this language. Fallback language is always English.
+ \param constants If the constant strings of the units are added.
+ \return nullptr if no strings.po file was loaded.
+ */
+static std::unique_ptr<CLocalizeCatalog> LoadCatalog(const std::string& path, const std::string& language, bool constants = false)
+{
+  std::vector<std::string> sources;
+  const std::string file = GetPOFile(path, language);
+  if (!file.empty())
+    sources.push_back(file);
+  else if (StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT)) // no fallback, nothing to do
+    return nullptr;
+
+  if (!StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT))
+  {
+    const std::string fallback = GetPOFile(path, LANGUAGE_DEFAULT);
+    if (!fallback.empty())
+      sources.push_back(fallback);
+  }
+
+  const std::string key = StringUtils::Join(sources, "|") + (constants ? "|constants" : "");
+  const std::string catalogFile = URIUtils::AddFileToFolder(
+      CATALOG_DIRECTORY, CDigest::Calculate(CDigest::Type::MD5, key) + CATALOG_EXTENSION);
+
+  std::unique_ptr<CLocalizeCatalog> catalog = CLocalizeCatalog::Open(catalogFile, sources);
+  if (catalog)
+    return catalog;
+
+  std::map<uint32_t, LocStr> strings;
+  if (!LoadWithFallback(path, language, strings))
+    return nullptr;
+
+  if (constants)
+    AddConstantStrings(strings);
+
+  return CLocalizeCatalog::Create(catalogFile, sources, strings);
+}
+
+CLocalizeStrings::CLocalizeStrings(void) = default;
+
+CLocalizeStrings::~CLocalizeStrings(void) = default;
+
+void CLocalizeStrings::ClearSkinStrings()
+{
+  // clear the skin strings
+  CExclusiveLock lock(m_stringsMutex);
+  m_skinStrings.reset();
+}
+
+bool CLocalizeStrings::LoadSkinStrings(const std::string& path, const std::string& language)
+{
+  std::unique_ptr<CLocalizeCatalog> strings = LoadCatalog(path, language);
+
+  CExclusiveLock lock(m_stringsMutex);
+  m_skinStrings = std::move(strings);
+  return m_skinStrings != nullptr;
+}
+
+bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& strLanguage)
+{
+  std::unique_ptr<CLocalizeCatalog> strings = LoadCatalog(strPathName, strLanguage, true);
+  if (!strings)
+    return false;
 
   CExclusiveLock lock(m_stringsMutex);
   Clear();
@@ -190,37 +255,27 @@ bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& s
 const std::string& CLocalizeStrings::Get(uint32_t dwCode) const
 {
   CSharedLock lock(m_stringsMutex);
-  ciStrings i = m_strings.find(dwCode);
-  if (i == m_strings.end())
-  {
+  const std::string* value = m_strings ? m_strings->Get(dwCode) : nullptr;
+  // the skin can't override the strings of the language
+  if (!value && m_skinStrings)
+    value = m_skinStrings->Get(dwCode);
+
+  if (!value)
     return StringUtils::Empty;
-  }
-  return i->second.strTranslated;
+  return *value;
 }
 
 void CLocalizeStrings::Clear()
 {
   CExclusiveLock lock(m_stringsMutex);
-  m_strings.clear();
-}
-
-void CLocalizeStrings::Clear(uint32_t start, uint32_t end)
-{
-  CExclusiveLock lock(m_stringsMutex);
-  iStrings it = m_strings.begin();
-  while (it != m_strings.end())
-  {
-    if (it->first >= start && it->first <= end)
-      m_strings.erase(it++);
-    else
-      ++it;
-  }
+  m_strings.reset();
+  m_skinStrings.reset();
 }
 
 bool CLocalizeStrings::LoadAddonStrings(const std::string& path, const std::string& language, const std::string& addonId)
 {
-  std::map<uint32_t, LocStr> strings;
-  if (!LoadWithFallback(path, language, strings))
+  std::unique_ptr<CLocalizeCatalog> strings = LoadCatalog(path, language);
+  if (!strings)
     return false;
 
   CExclusiveLock lock(m_addonStringsMutex);
@@ -238,9 +293,9 @@ std::string CLocalizeStrings::GetAddonString(const std::string& addonId, uint32_
   if (i == m_addonStrings.end())
     return StringUtils::Empty;
 
-  auto j = i->second.find(code);
-  if (j == i->second.end())
+  std::string value;
+  if (!i->second->Get(code, value))
     return StringUtils::Empty;
 
-  return j->second.strTranslated;
+  return value;
 }
@@ -13,10 +13,12 @@
 \brief
 */
 
+#include "LocalizeCatalog.h"
 #include "threads/SharedSection.h"
 #include "utils/ILocalizer.h"
 
 #include <map>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -52,12 +54,9 @@ public:
   std::string Localize(std::uint32_t code) const override { return Get(code); }
 
 protected:
-  void Clear(uint32_t start, uint32_t end);
-
-  std::map<uint32_t, LocStr> m_strings;
-  std::map<std::string, std::map<uint32_t, LocStr>> m_addonStrings;
-  typedef std::map<uint32_t, LocStr>::const_iterator ciStrings;
-  typedef std::map<uint32_t, LocStr>::iterator       iStrings;
+  std::unique_ptr<CLocalizeCatalog> m_strings;
+  std::unique_ptr<CLocalizeCatalog> m_skinStrings;
+  std::map<std::string, std::unique_ptr<CLocalizeCatalog>> m_addonStrings;
 
   mutable CSharedSection m_stringsMutex;
   CSharedSection m_addonStringsMutex;
@@ -93,11 +93,11 @@ class CXBTFBase
 public:
   virtual ~CXBTFBase() = default;
 
-  uint64_t GetHeaderSize() const;
+  virtual uint64_t GetHeaderSize() const;
 
-  bool Exists(const std::string& name) const;
-  bool Get(const std::string& name, CXBTFFile& file) const;
-  std::vector<CXBTFFile> GetFiles() const;
+  virtual bool Exists(const std::string& name) const;
+  virtual bool Get(const std::string& name, CXBTFFile& file) const;
+  virtual std::vector<CXBTFFile> GetFiles() const;
   void AddFile(const CXBTFFile& file);
   void UpdateFile(const CXBTFFile& file);
 
@@ -6,6 +6,7 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include <algorithm>
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
@@ -21,38 +22,50 @@
 #include "platform/win32/PlatformDefs.h"
 #endif
 
-static bool ReadString(FILE* file, char* str, size_t max_length)
+// magic word, version and number of files
+#define XBTF_HEADER_START_SIZE 9
+// path, loop and number of frames of a file
+#define XBTF_FILE_RECORD_SIZE (CXBTFFile::MaximumPathLength + 8)
+// width, height, format, packed and unpacked size, duration and offset of a frame
+#define XBTF_FRAME_RECORD_SIZE 40
+
+namespace
 {
-  if (file == nullptr || str == nullptr || max_length <= 0)
-    return false;
 
-  return (fread(str, max_length, 1, file) == 1);
+uint32_t ReadUInt32(const char* data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return Endian_SwapLE32(value);
 }
 
-static bool ReadUInt32(FILE* file, uint32_t& value)
+uint64_t ReadUInt64(const char* data)
 {
-  if (file == nullptr)
-    return false;
-
-  if (fread(&value, sizeof(uint32_t), 1, file) != 1)
-    return false;
-
-  value = Endian_SwapLE32(value);
-  return true;
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return Endian_SwapLE64(value);
 }
 
-static bool ReadUInt64(FILE* file, uint64_t& value)
+size_t PathLength(const char* record)
 {
-  if (file == nullptr)
-    return false;
-
-  if (fread(&value, sizeof(uint64_t), 1, file) != 1)
-    return false;
+  const void* end = memchr(record, 0, CXBTFFile::MaximumPathLength);
+  return end ? static_cast<const char*>(end) - record : CXBTFFile::MaximumPathLength;
+}
 
-  value = Endian_SwapLE64(value);
-  return true;
+// FNV-1a
+uint32_t HashPath(const char* path, size_t length)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++)
+  {
+    hash ^= static_cast<unsigned char>(path[i]);
+    hash *= 16777619u;
+  }
+  return hash;
 }
 
+} // unnamed namespace
+
 CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path()
@@ -80,93 +93,177 @@ bool CXBTFReader::Open(const std::string& path)
   if (m_file == nullptr)
     return false;
 
-  // read the magic word
-  char magic[4];
-  if (!ReadString(m_file, magic, sizeof(magic)))
+  if (!ReadHeader())
     return false;
 
-  if (strncmp(XBTF_MAGIC.c_str(), magic, sizeof(magic)) != 0)
+  // read the magic word
+  if (strncmp(XBTF_MAGIC.c_str(), m_header, 4) != 0)
     return false;
 
   // read the version
-  char version[1];
-  if (!ReadString(m_file, version, sizeof(version)))
+  if (strncmp(XBTF_VERSION.c_str(), m_header + 4, 1) != 0)
     return false;
 
-  if (strncmp(XBTF_VERSION.c_str(), version, sizeof(version)) != 0)
-    return false;
+  return BuildIndex();
+}
 
-  unsigned int nofFiles;
-  if (!ReadUInt32(m_file, nofFiles))
+bool CXBTFReader::ReadHeader()
+{
+  // copied out rather than mapped, a mapping of a bundle replaced or truncated while it's open
+  // faults on access. Read the records one at a time, each tells the size of the next part
+  m_headerBuffer.resize(XBTF_HEADER_START_SIZE);
+  if (fread(m_headerBuffer.data(), XBTF_HEADER_START_SIZE, 1, m_file) != 1)
     return false;
 
+  const uint32_t nofFiles = ReadUInt32(m_headerBuffer.data() + 5);
   for (uint32_t i = 0; i < nofFiles; i++)
   {
-    CXBTFFile xbtfFile;
-    uint32_t u32;
-    uint64_t u64;
-
-    // one extra char to null terminate the string with the following memset
-    char path[CXBTFFile::MaximumPathLength + 1];
-    memset(path, 0, sizeof(path));
-    if (!ReadString(m_file, path, sizeof(path) - 1))
+    size_t pos = m_headerBuffer.size();
+    m_headerBuffer.resize(pos + XBTF_FILE_RECORD_SIZE);
+    if (fread(m_headerBuffer.data() + pos, XBTF_FILE_RECORD_SIZE, 1, m_file) != 1)
       return false;
-    xbtfFile.SetPath(path);
 
-    if (!ReadUInt32(m_file, u32))
-      return false;
-    xbtfFile.SetLoop(u32);
+    const uint32_t nofFrames = ReadUInt32(m_headerBuffer.data() + pos + XBTF_FILE_RECORD_SIZE - 4);
+    if (nofFrames == 0)
+      continue;
 
-    unsigned int nofFrames;
-    if (!ReadUInt32(m_file, nofFrames))
+    pos = m_headerBuffer.size();
+    m_headerBuffer.resize(pos + static_cast<size_t>(nofFrames) * XBTF_FRAME_RECORD_SIZE);
+    if (fread(m_headerBuffer.data() + pos, XBTF_FRAME_RECORD_SIZE, nofFrames, m_file) != nofFrames)
       return false;
+  }
 
-    for (uint32_t j = 0; j < nofFrames; j++)
-    {
-      CXBTFFrame frame;
+  m_header = m_headerBuffer.data();
+  m_headerSize = m_headerBuffer.size();
+  return true;
+}
 
-      if (!ReadUInt32(m_file, u32))
-        return false;
-      frame.SetWidth(u32);
+bool CXBTFReader::BuildIndex()
+{
+  if (m_headerSize < XBTF_HEADER_START_SIZE)
+    return false;
 
-      if (!ReadUInt32(m_file, u32))
-        return false;
-      frame.SetHeight(u32);
+  const uint32_t nofFiles = ReadUInt32(m_header + 5);
+  m_index.reserve(nofFiles);
 
-      if (!ReadUInt32(m_file, u32))
-        return false;
-      frame.SetFormat(u32);
+  uint64_t pos = XBTF_HEADER_START_SIZE;
+  for (uint32_t i = 0; i < nofFiles; i++)
+  {
+    if (pos + XBTF_FILE_RECORD_SIZE > m_headerSize)
+      return false;
 
-      if (!ReadUInt64(m_file, u64))
-        return false;
-      frame.SetPackedSize(u64);
+    const char* record = m_header + pos;
+    const uint32_t nofFrames = ReadUInt32(record + XBTF_FILE_RECORD_SIZE - 4);
+    const uint64_t recordSize =
+        XBTF_FILE_RECORD_SIZE + static_cast<uint64_t>(nofFrames) * XBTF_FRAME_RECORD_SIZE;
+    if (pos + recordSize > m_headerSize || pos > UINT32_MAX)
+      return false;
 
-      if (!ReadUInt64(m_file, u64))
-        return false;
-      frame.SetUnpackedSize(u64);
+    m_index.push_back({HashPath(record, PathLength(record)), static_cast<uint32_t>(pos)});
+    pos += recordSize;
+  }
 
-      if (!ReadUInt32(m_file, u32))
-        return false;
-      frame.SetDuration(u32);
+  // the first of several files with the same path wins
+  std::sort(m_index.begin(), m_index.end(), [](const SIndexEntry& a, const SIndexEntry& b) {
+    return a.hash < b.hash || (a.hash == b.hash && a.offset < b.offset);
+  });
 
-      if (!ReadUInt64(m_file, u64))
-        return false;
-      frame.SetOffset(u64);
+  m_headerSize = pos;
+  return true;
+}
 
-      xbtfFile.GetFrames().push_back(frame);
-    }
+const char* CXBTFReader::FindRecord(const std::string& name) const
+{
+  if (name.size() > CXBTFFile::MaximumPathLength)
+    return nullptr;
+
+  const uint32_t hash = HashPath(name.c_str(), name.size());
+  auto it = std::lower_bound(m_index.begin(), m_index.end(), hash,
+                             [](const SIndexEntry& entry, uint32_t hash) {
+                               return entry.hash < hash;
+                             });
+  for (; it != m_index.end() && it->hash == hash; ++it)
+  {
+    const char* record = m_header + it->offset;
+    if (PathLength(record) == name.size() && memcmp(record, name.c_str(), name.size()) == 0)
+      return record;
+  }
+  return nullptr;
+}
+
+void CXBTFReader::ReadRecord(const char* record, CXBTFFile& file) const
+{
+  file.SetPath(std::string(record, PathLength(record)));
+  record += CXBTFFile::MaximumPathLength;
+  file.SetLoop(ReadUInt32(record));
+
+  const uint32_t nofFrames = ReadUInt32(record + 4);
+  record += 8;
 
-    AddFile(xbtfFile);
+  std::vector<CXBTFFrame>& frames = file.GetFrames();
+  frames.clear();
+  frames.reserve(nofFrames);
+  for (uint32_t j = 0; j < nofFrames; j++, record += XBTF_FRAME_RECORD_SIZE)
+  {
+    CXBTFFrame frame;
+    frame.SetWidth(ReadUInt32(record));
+    frame.SetHeight(ReadUInt32(record + 4));
+    frame.SetFormat(ReadUInt32(record + 8));
+    frame.SetPackedSize(ReadUInt64(record + 12));
+    frame.SetUnpackedSize(ReadUInt64(record + 20));
+    frame.SetDuration(ReadUInt32(record + 28));
+    frame.SetOffset(ReadUInt64(record + 32));
+    frames.push_back(frame);
   }
+}
 
-  // Sanity check
-  uint64_t pos = static_cast<uint64_t>(ftell(m_file));
-  if (pos != GetHeaderSize())
+uint64_t CXBTFReader::GetHeaderSize() const
+{
+  return m_headerSize;
+}
+
+bool CXBTFReader::Exists(const std::string& name) const
+{
+  return FindRecord(name) != nullptr;
+}
+
+bool CXBTFReader::Get(const std::string& name, CXBTFFile& file) const
+{
+  const char* record = FindRecord(name);
+  if (record == nullptr)
     return false;
 
+  ReadRecord(record, file);
   return true;
 }
 
+std::vector<CXBTFFile> CXBTFReader::GetFiles() const
+{
+  // in order of the path, like the files of CXBTFBase
+  std::vector<uint32_t> offsets;
+  offsets.reserve(m_index.size());
+  for (const auto& entry : m_index)
+    offsets.push_back(entry.offset);
+
+  std::stable_sort(offsets.begin(), offsets.end(), [this](uint32_t a, uint32_t b) {
+    return strncmp(m_header + a, m_header + b, CXBTFFile::MaximumPathLength) < 0;
+  });
+
+  std::vector<CXBTFFile> files;
+  files.reserve(offsets.size());
+  for (size_t i = 0; i < offsets.size(); i++)
+  {
+    if (i > 0 && strncmp(m_header + offsets[i - 1], m_header + offsets[i],
+                         CXBTFFile::MaximumPathLength) == 0)
+      continue;
+
+    files.emplace_back();
+    ReadRecord(m_header + offsets[i], files.back());
+  }
+
+  return files;
+}
+
 bool CXBTFReader::IsOpen() const
 {
   return m_file != nullptr;
@@ -180,6 +277,11 @@ void CXBTFReader::Close()
     m_file = nullptr;
   }
 
+  m_index.clear();
+  m_headerBuffer.clear();
+  m_header = nullptr;
+  m_headerSize = 0;
+
   m_path.clear();
   m_files.clear();
 }
@@ -15,6 +15,13 @@
 #include <string>
 #include <vector>
 
+/*!
+ \brief Reads XBT texture bundles.
+
+ The header of the bundle is read into memory and only indexed on open: a table sorted by the hash of each file's path points
+ at its record in the header. Files are decoded from their record when they're looked up,
+ so opening a large bundle doesn't build a map of all its files and frames.
+ */
 class CXBTFReader : public CXBTFBase
 {
 public:
@@ -29,9 +36,29 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  uint64_t GetHeaderSize() const override;
+  bool Exists(const std::string& name) const override;
+  bool Get(const std::string& name, CXBTFFile& file) const override;
+  std::vector<CXBTFFile> GetFiles() const override;
+
 private:
+  struct SIndexEntry
+  {
+    uint32_t hash;
+    uint32_t offset; ///< offset of the file's record in the header
+  };
+
+  bool ReadHeader();
+  bool BuildIndex();
+  const char* FindRecord(const std::string& name) const;
+  void ReadRecord(const char* record, CXBTFFile& file) const;
+
   std::string m_path;
   FILE* m_file = nullptr;
+  const char* m_header = nullptr;
+  uint64_t m_headerSize = 0;
+  std::vector<char> m_headerBuffer;
+  std::vector<SIndexEntry> m_index;
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUISkinCache.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::unique_ptr<TiXmlElement> Parse(const std::string& xml)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(xml);
+  if (!doc.RootElement())
+    return nullptr;
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+}
+
+std::string Print(const TiXmlElement& element)
+{
+  TiXmlPrinter printer;
+  element.Accept(&printer);
+  return printer.Str();
+}
+} // namespace
+
+TEST(TestGUISkinCache, RoundTrip)
+{
+  std::unique_ptr<TiXmlElement> window =
+      Parse("<window id=\"1\" type=\"dialog\">"
+            "<!-- comments are dropped -->"
+            "<controls>"
+            "<control type=\"label\" id=\"2\"><label>$INFO[ListItem.Label] &amp; more</label></control>"
+            "<control type=\"group\"><control type=\"image\"><texture>a.png</texture></control></control>"
+            "<control type=\"textbox\"><label><![CDATA[<b>not markup</b>]]></label></control>"
+            "</controls>"
+            "<onload/>"
+            "</window>");
+  ASSERT_TRUE(window);
+
+  std::string data;
+  CGUISkinCache::Serialize(*window, data);
+
+  const char* read = data.c_str();
+  const char* end = read + data.size();
+  std::unique_ptr<TiXmlElement> restored = CGUISkinCache::Deserialize(read, end);
+  ASSERT_TRUE(restored);
+  EXPECT_EQ(end, read);
+
+  EXPECT_STREQ("1", restored->Attribute("id"));
+  EXPECT_STREQ("dialog", restored->Attribute("type"));
+  const TiXmlElement* controls = restored->FirstChildElement("controls");
+  ASSERT_TRUE(controls);
+  const TiXmlElement* label = controls->FirstChildElement("control")->FirstChildElement("label");
+  ASSERT_TRUE(label && label->FirstChild());
+  EXPECT_EQ("$INFO[ListItem.Label] & more", label->FirstChild()->ValueStr());
+
+  const TiXmlElement* textbox = controls->FirstChildElement("control")->NextSiblingElement("control")->NextSiblingElement("control");
+  ASSERT_TRUE(textbox && textbox->FirstChildElement("label"));
+  const TiXmlText* cdata = textbox->FirstChildElement("label")->FirstChild()->ToText();
+  ASSERT_TRUE(cdata);
+  EXPECT_TRUE(cdata->CDATA());
+  EXPECT_EQ("<b>not markup</b>", cdata->ValueStr());
+
+  // the comment is the only thing lost
+  window->RemoveChild(window->FirstChild());
+  EXPECT_EQ(Print(*window), Print(*restored));
+}
+
+TEST(TestGUISkinCache, Truncated)
+{
+  std::unique_ptr<TiXmlElement> window =
+      Parse("<window><controls><control type=\"label\"><label>text</label></control></controls></window>");
+  ASSERT_TRUE(window);
+
+  std::string data;
+  CGUISkinCache::Serialize(*window, data);
+
+  // every shorter prefix is rejected instead of being read past its end
+  for (size_t size = 0; size < data.size(); size++)
+  {
+    const std::string truncated = data.substr(0, size);
+    const char* read = truncated.c_str();
+    EXPECT_FALSE(CGUISkinCache::Deserialize(read, read + truncated.size())) << "size " << size;
+  }
+
+  // as is anything that isn't an element
+  std::string invalid = data;
+  invalid[0] = 42;
+  const char* read = invalid.c_str();
+  EXPECT_FALSE(CGUISkinCache::Deserialize(read, read + invalid.size()));
+}
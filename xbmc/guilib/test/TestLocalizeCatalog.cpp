@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/LocalizeCatalog.h"
+#include "guilib/LocalizeStrings.h"
+#include "utils/auto_buffer.h"
+
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const std::string TEST_PATH = "special://temp/localizecatalog/";
+
+bool WriteFile(const std::string& file, const std::string& data)
+{
+  CFile output;
+  return output.OpenForWrite(file, true) &&
+         output.Write(data.c_str(), data.size()) == static_cast<ssize_t>(data.size());
+}
+
+std::string ReadFile(const std::string& file)
+{
+  CFile input;
+  XUTILS::auto_buffer buffer;
+  if (input.LoadFile(file, buffer) <= 0)
+    return std::string();
+  return std::string(buffer.get(), buffer.size());
+}
+} // namespace
+
+class TestLocalizeCatalog : public testing::Test
+{
+protected:
+  TestLocalizeCatalog()
+  {
+    CDirectory::Create(TEST_PATH);
+    EXPECT_TRUE(WriteFile(source, "msgctxt \"#1\"\nmsgid \"One\"\nmsgstr \"Eins\"\n"));
+    sources.push_back(source);
+
+    strings[1].strTranslated = "Eins";
+    strings[5].strTranslated = "Fünf";
+    strings[30000].strTranslated = "";
+  }
+
+  ~TestLocalizeCatalog() override { CDirectory::RemoveRecursive(TEST_PATH); }
+
+  const std::string source = TEST_PATH + "strings.po";
+  const std::string file = TEST_PATH + "strings.catalog";
+  std::vector<std::string> sources;
+  std::map<uint32_t, LocStr> strings;
+};
+
+TEST_F(TestLocalizeCatalog, RoundTrip)
+{
+  std::unique_ptr<CLocalizeCatalog> created = CLocalizeCatalog::Create(file, sources, strings);
+  ASSERT_TRUE(created);
+  EXPECT_EQ(3u, created->Size());
+  ASSERT_TRUE(created->Get(5));
+  EXPECT_EQ("Fünf", *created->Get(5));
+  created.reset();
+
+  std::unique_ptr<CLocalizeCatalog> catalog = CLocalizeCatalog::Open(file, sources);
+  ASSERT_TRUE(catalog);
+  EXPECT_EQ(3u, catalog->Size());
+
+  const std::string* value = catalog->Get(1);
+  ASSERT_TRUE(value);
+  EXPECT_EQ("Eins", *value);
+  // the string is kept with the catalog
+  EXPECT_EQ(value, catalog->Get(1));
+
+  ASSERT_TRUE(catalog->Get(30000));
+  EXPECT_TRUE(catalog->Get(30000)->empty());
+
+  std::string copy;
+  EXPECT_TRUE(catalog->Get(5, copy));
+  EXPECT_EQ("Fünf", copy);
+}
+
+TEST_F(TestLocalizeCatalog, Missing)
+{
+  std::unique_ptr<CLocalizeCatalog> catalog = CLocalizeCatalog::Create(file, sources, strings);
+  ASSERT_TRUE(catalog);
+
+  std::string value = "unchanged";
+  for (const uint32_t id : {0u, 2u, 29999u, 30001u, 0xffffffffu})
+  {
+    EXPECT_EQ(nullptr, catalog->Get(id)) << id;
+    EXPECT_FALSE(catalog->Get(id, value)) << id;
+  }
+  EXPECT_EQ("unchanged", value);
+
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(TEST_PATH + "missing.catalog", sources));
+
+  std::unique_ptr<CLocalizeCatalog> empty =
+      CLocalizeCatalog::Create(file, sources, std::map<uint32_t, LocStr>());
+  ASSERT_TRUE(empty);
+  EXPECT_EQ(0u, empty->Size());
+  EXPECT_EQ(nullptr, empty->Get(1));
+}
+
+TEST_F(TestLocalizeCatalog, SourcesChanged)
+{
+  ASSERT_TRUE(CLocalizeCatalog::Create(file, sources, strings));
+  ASSERT_TRUE(CLocalizeCatalog::Open(file, sources));
+
+  // compiled from other files
+  std::vector<std::string> others = sources;
+  others.push_back(TEST_PATH + "skin.po");
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, others));
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, std::vector<std::string>()));
+
+  // a source was edited, the catalog is compiled again
+  ASSERT_TRUE(WriteFile(source, "msgctxt \"#1\"\nmsgid \"One\"\nmsgstr \"Ein\"\n"));
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, sources));
+
+  strings[1].strTranslated = "Ein";
+  ASSERT_TRUE(CLocalizeCatalog::Create(file, sources, strings));
+  std::unique_ptr<CLocalizeCatalog> catalog = CLocalizeCatalog::Open(file, sources);
+  ASSERT_TRUE(catalog);
+  ASSERT_TRUE(catalog->Get(1));
+  EXPECT_EQ("Ein", *catalog->Get(1));
+
+  // a source was removed
+  ASSERT_TRUE(CFile::Delete(source));
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, sources));
+}
+
+TEST_F(TestLocalizeCatalog, Corrupt)
+{
+  ASSERT_TRUE(CLocalizeCatalog::Create(file, sources, strings));
+  const std::string data = ReadFile(file);
+  ASSERT_FALSE(data.empty());
+
+  // every part of the catalog is needed
+  for (size_t size = 0; size < data.size(); ++size)
+  {
+    ASSERT_TRUE(WriteFile(file, data.substr(0, size)));
+    EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, sources)) << "truncated to " << size;
+  }
+
+  std::string corrupt = data;
+  corrupt[4] = 'X';
+  ASSERT_TRUE(WriteFile(file, corrupt));
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, sources)) << "magic";
+
+  // the pool is "Eins\0Fünf\0\0", the table before it holds three entries of id, offset, length
+  const size_t pool = strlen("Eins") + strlen("Fünf") + 3;
+  const size_t table = data.size() - pool - 3 * 3 * sizeof(uint32_t);
+  uint32_t length;
+  memcpy(&length, data.data() + table + 2 * sizeof(uint32_t), sizeof(length));
+  ASSERT_EQ(4u, length);
+
+  corrupt = data;
+  length = 0x7fffffff;
+  memcpy(&corrupt[table + 2 * sizeof(uint32_t)], &length, sizeof(length));
+  ASSERT_TRUE(WriteFile(file, corrupt));
+  EXPECT_EQ(nullptr, CLocalizeCatalog::Open(file, sources)) << "string past the pool";
+
+  ASSERT_TRUE(WriteFile(file, data));
+  EXPECT_TRUE(CLocalizeCatalog::Open(file, sources));
+}
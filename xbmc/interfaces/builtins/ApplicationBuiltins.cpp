@@ -20,6 +20,7 @@
 #include "utils/FileOperationJob.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -28,6 +29,22 @@
 
 using namespace KODI::MESSAGING;
 
+/*! \brief Write the recorded zones of the trace profiler.
+ *  \param params The parameters.
+ *  \details params[0] = File to write to (optional).
+ */
+static int DumpTrace(const std::vector<std::string>& params)
+{
+  std::string file = params.empty() ? "" : params[0];
+  if (file.empty())
+    file = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_traceFile;
+
+  size_t events = 0;
+  CTraceProfiler::GetInstance().Dump(file, events);
+
+  return 0;
+}
+
 /*! \brief Extract an archive.
  *  \param params The parameters
  *  \details params[0] = The archive URL.
@@ -120,6 +137,16 @@ static int ToggleDebug(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Toggle recording of the trace profiler.
+ *  \param params (ignored)
+ */
+static int ToggleTrace(const std::vector<std::string>& params)
+{
+  CTraceProfiler::GetInstance().SetEnabled(!CTraceProfiler::IsEnabled());
+
+  return 0;
+}
+
 /*! \brief Toggle DPMS state.
  *  \param params (ignored)
  */
@@ -153,6 +180,13 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 ///     Function,
 ///     Description }
 ///   \table_row2_l{
+///     <b>`DumpTrace([file])`</b>
+///     ,
+///     Writes the zones recorded while tracing in the Chrome trace event format.
+///     @param[in] file                  File to write to (optional).
+///             @note If not given\, the dumpfile of the trace advanced settings.
+///   }
+///   \table_row2_l{
 ///     <b>`Extract(url [\, dest])`</b>
 ///     ,
 ///     Extracts a specified archive to an optionally specified 'absolute' path.
@@ -192,6 +226,11 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 ///     Toggle DPMS mode manually
 ///   }
 ///   \table_row2_l{
+///     <b>`ToggleTrace`</b>
+///     ,
+///     Toggles recording the timeline of the traced zones on/off
+///   }
+///   \table_row2_l{
 ///     <b>`WakeOnLan(mac)`</b>
 ///     ,
 ///     Sends the wake-up packet to the broadcast address for the specified MAC
@@ -204,12 +243,14 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 CBuiltins::CommandMap CApplicationBuiltins::GetOperations() const
 {
   return {
+           {"dumptrace", {"Writes the recorded trace zones", 0, DumpTrace}},
            {"extract", {"Extracts the specified archive", 1, Extract}},
            {"mute", {"Mute the player", 0, Mute}},
            {"notifyall", {"Notify all connected clients", 2, NotifyAll}},
            {"setvolume", {"Set the current volume", 1, SetVolume}},
            {"toggledebug", {"Enables/disables debug mode", 0, ToggleDebug}},
            {"toggledpms", {"Toggle DPMS mode manually", 0, ToggleDPMS}},
+           {"toggletrace", {"Enables/disables trace recording", 0, ToggleTrace}},
            {"wakeonlan", {"Sends the wake-up packet to the broadcast address for the specified MAC address", 1, WakeOnLAN}}
          };
 }
@@ -8,17 +8,23 @@
 
 #include "InfoBool.h"
 
+#include "utils/Metrics.h"
 #include "utils/StringUtils.h"
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  std::atomic<uint64_t>& InfoBool::m_evaluations =
+      CMetrics::GetInstance().GetCounter("guiinfo.evaluations");
+
+  InfoBool::InfoBool(const std::string &expression, int context, const InfoEpochs &epochs)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependencies(INFO_DEPENDS_VOLATILE),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_evaluated(false),
+      m_epoch(0),
+      m_epochs(epochs)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -8,13 +8,59 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <stdint.h>
 #include <string>
 
 class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief What the value of a bool depends on, decides when it has to be evaluated again
+ */
+enum InfoDependency
+{
+  INFO_DEPENDS_NONE     = 0,      ///< constant
+  INFO_DEPENDS_SKIN     = 1 << 0, ///< skin settings
+  INFO_DEPENDS_SETTINGS = 1 << 1, ///< settings
+  INFO_DEPENDS_ADDONS   = 1 << 2, ///< installed and enabled add-ons
+  INFO_DEPENDS_VOLATILE = 1 << 3, ///< anything else, evaluated again every frame
+};
+
+/*!
+ \ingroup info
+ \brief Change counters of the sources bools depend on, as seen at the start of the frame
+ */
+struct InfoEpochs
+{
+  unsigned int frame = 0;    ///< moves with every frame
+  unsigned int reset = 0;    ///< moves when all bools have to be evaluated again
+  unsigned int skin = 0;
+  unsigned int settings = 0;
+  unsigned int addons = 0;
+
+  /*! \brief Get the epoch of a bool, which only moves if one of its sources changed
+   \param dependencies the InfoDependency flags of the bool
+   */
+  unsigned int Get(unsigned int dependencies) const
+  {
+    if (dependencies & INFO_DEPENDS_VOLATILE)
+      return frame;
+
+    unsigned int epoch = reset;
+    if (dependencies & INFO_DEPENDS_SKIN)
+      epoch += skin;
+    if (dependencies & INFO_DEPENDS_SETTINGS)
+      epoch += settings;
+    if (dependencies & INFO_DEPENDS_ADDONS)
+      epoch += addons;
+    return epoch;
+  }
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +68,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, const InfoEpochs &epochs);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,11 +80,20 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
+    {
+      m_evaluations.fetch_add(1, std::memory_order_relaxed);
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+    }
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      const unsigned int epoch = m_epochs.Get(m_dependencies);
+      if (epoch != m_epoch || !m_evaluated)
+      {
+        m_evaluations.fetch_add(1, std::memory_order_relaxed);
+        Update(NULL);
+        m_epoch = epoch;
+        m_evaluated = true;
+      }
     }
     return m_value;
   }
@@ -66,16 +121,21 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency flags, set by Initialize
   std::string  m_expression;   ///< original expression
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  static std::atomic<uint64_t>& m_evaluations; ///< of all bools, the "guiinfo.evaluations" metric
+
+  bool m_evaluated;
+  unsigned int m_epoch;
+  const InfoEpochs &m_epochs;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -13,6 +13,7 @@
 #include "guilib/GUIComponent.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <stack>
@@ -21,7 +22,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependencies = infoMgr.GetConditionDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -36,11 +39,19 @@ void InfoExpression::Initialize()
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
     m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
   }
+
+  m_expression_tree->Flatten(m_nodes, m_infos);
+  m_expression_tree.reset();
+
+  /* The expression only has to be evaluated again if one of its operands might have changed */
+  m_dependencies = INFO_DEPENDS_NONE;
+  for (const auto& info : m_infos)
+    m_dependencies |= info->GetDependencies();
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Evaluate(0, item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -59,11 +70,17 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * The tree is then flattened into an array holding the nodes in pre-order, each
+ * group followed by its children. A child is skipped over by its size, so
+ * evaluation walks a single block of memory, and reordering a group is a
+ * rotation of the ranges of its children.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoLeaf::Flatten(std::vector<InfoNode> &nodes, std::vector<InfoPtr> &infos) const
 {
-  return m_invert ^ m_info->Get(item);
+  nodes.push_back({NODE_LEAF, m_invert, 1, m_info.get()});
+  infos.push_back(m_info);
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -86,27 +103,42 @@ void InfoExpression::InfoAssociativeGroup::Merge(const std::shared_ptr<InfoAssoc
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoAssociativeGroup::Flatten(std::vector<InfoNode> &nodes, std::vector<InfoPtr> &infos) const
+{
+  const size_t index = nodes.size();
+  nodes.push_back({m_type, false, 0, nullptr});
+  for (const auto& child : m_children)
+    child->Flatten(nodes, infos);
+  nodes[index].size = nodes.size() - index;
+}
+
+bool InfoExpression::Evaluate(size_t index, const CGUIListItem *item)
 {
+  const InfoNode &node = m_nodes[index];
+  if (node.type == NODE_LEAF)
+    return node.invert ^ node.info->Get(item);
+
   /* Handle either AND or OR by using the relation
    * A AND B == !(!A OR !B)
    * to convert ANDs into ORs
    */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  const bool use_and = (node.type == NODE_AND);
+  const size_t first = index + 1;
+  const size_t last = index + node.size;
+  for (size_t child = first; child < last; child += m_nodes[child].size)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    if (use_and ^ Evaluate(child, item))
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      /* Move this child to the head of the group so we evaluate faster next time */
+      if (child != first)
+      {
+        const auto begin = m_nodes.begin();
+        std::rotate(begin + first, begin + child, begin + child + m_nodes[child].size);
+      }
+      return !use_and;
     }
   }
-  return use_and ^ result;
+  return use_and;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
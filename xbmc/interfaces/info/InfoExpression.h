@@ -16,6 +16,7 @@
 #include <vector>
 
 class CGUIListItem;
+class TestInfoExpression;
 
 namespace INFO
 {
@@ -24,8 +25,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, const InfoEpochs &epochs)
+    : InfoBool(expression, context, epochs) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -38,14 +39,16 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, const InfoEpochs &epochs)
+    : InfoBool(expression, context, epochs) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
 private:
+  friend class ::TestInfoExpression;
+
   typedef enum
   {
     OPERATOR_NONE  = 0,
@@ -63,12 +66,21 @@ private:
     NODE_OR,
   } node_type_t;
 
+  // A node of the expression tree as it is evaluated, stored in pre-order
+  struct InfoNode
+  {
+    node_type_t type;
+    bool invert;       // leaves only
+    unsigned int size; // number of nodes in this subtree, including this one
+    InfoBool *info;    // leaves only, owned by m_infos
+  };
+
   // An abstract base class for nodes in the expression tree
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
+    virtual void Flatten(std::vector<InfoNode> &nodes, std::vector<InfoPtr> &infos) const = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -79,7 +91,7 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(std::move(info)), m_invert(invert){};
-    bool Evaluate(const CGUIListItem *item) override;
+    void Flatten(std::vector<InfoNode> &nodes, std::vector<InfoPtr> &infos) const override;
     node_type_t Type() const override { return NODE_LEAF; };
   private:
     InfoPtr m_info;
@@ -93,7 +105,7 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(const std::shared_ptr<InfoAssociativeGroup>& other);
-    bool Evaluate(const CGUIListItem *item) override;
+    void Flatten(std::vector<InfoNode> &nodes, std::vector<InfoPtr> &infos) const override;
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
@@ -103,7 +115,10 @@ private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  bool Evaluate(size_t index, const CGUIListItem *item);
+  InfoSubexpressionPtr m_expression_tree; // only kept while parsing
+  std::vector<InfoNode> m_nodes;
+  std::vector<InfoPtr> m_infos;
 };
 
 };
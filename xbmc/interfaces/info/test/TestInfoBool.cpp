@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/info/InfoBool.h"
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+class CCountingBool : public InfoBool
+{
+public:
+  CCountingBool(const InfoEpochs& epochs, unsigned int dependencies)
+    : InfoBool("counting", 0, epochs)
+  {
+    m_dependencies = dependencies;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_value = !m_value;
+    updates++;
+  }
+
+  int updates = 0;
+};
+}
+
+TEST(TestInfoBool, EpochsConstant)
+{
+  InfoEpochs epochs;
+  const unsigned int epoch = epochs.Get(INFO_DEPENDS_NONE);
+  epochs.frame++;
+  epochs.skin++;
+  epochs.settings++;
+  epochs.addons++;
+  EXPECT_EQ(epoch, epochs.Get(INFO_DEPENDS_NONE));
+
+  // only a reset moves constants
+  epochs.reset++;
+  EXPECT_NE(epoch, epochs.Get(INFO_DEPENDS_NONE));
+}
+
+TEST(TestInfoBool, EpochsSources)
+{
+  InfoEpochs epochs;
+  const unsigned int skin = epochs.Get(INFO_DEPENDS_SKIN);
+  const unsigned int mixed = epochs.Get(INFO_DEPENDS_SETTINGS | INFO_DEPENDS_ADDONS);
+
+  epochs.frame++;
+  epochs.skin++;
+  EXPECT_NE(skin, epochs.Get(INFO_DEPENDS_SKIN));
+  EXPECT_EQ(mixed, epochs.Get(INFO_DEPENDS_SETTINGS | INFO_DEPENDS_ADDONS));
+
+  const unsigned int skinAfter = epochs.Get(INFO_DEPENDS_SKIN);
+  epochs.addons++;
+  EXPECT_EQ(skinAfter, epochs.Get(INFO_DEPENDS_SKIN));
+  EXPECT_NE(mixed, epochs.Get(INFO_DEPENDS_SETTINGS | INFO_DEPENDS_ADDONS));
+
+  const unsigned int mixedAfter = epochs.Get(INFO_DEPENDS_SETTINGS | INFO_DEPENDS_ADDONS);
+  epochs.reset++;
+  EXPECT_NE(skinAfter, epochs.Get(INFO_DEPENDS_SKIN));
+  EXPECT_NE(mixedAfter, epochs.Get(INFO_DEPENDS_SETTINGS | INFO_DEPENDS_ADDONS));
+}
+
+TEST(TestInfoBool, EpochsVolatile)
+{
+  InfoEpochs epochs;
+  const unsigned int epoch = epochs.Get(INFO_DEPENDS_VOLATILE | INFO_DEPENDS_SKIN);
+  epochs.skin++;
+  EXPECT_EQ(epoch, epochs.Get(INFO_DEPENDS_VOLATILE | INFO_DEPENDS_SKIN));
+  epochs.frame++;
+  EXPECT_NE(epoch, epochs.Get(INFO_DEPENDS_VOLATILE | INFO_DEPENDS_SKIN));
+}
+
+TEST(TestInfoBool, GetCached)
+{
+  InfoEpochs epochs;
+  CCountingBool skin(epochs, INFO_DEPENDS_SKIN);
+  CCountingBool dynamic(epochs, INFO_DEPENDS_VOLATILE);
+
+  // evaluated on first use
+  EXPECT_TRUE(skin.Get());
+  EXPECT_TRUE(dynamic.Get());
+
+  epochs.frame++;
+  EXPECT_TRUE(skin.Get());
+  EXPECT_FALSE(dynamic.Get());
+  EXPECT_EQ(1, skin.updates);
+  EXPECT_EQ(2, dynamic.updates);
+
+  epochs.skin++;
+  EXPECT_FALSE(skin.Get());
+  EXPECT_FALSE(skin.Get());
+  EXPECT_EQ(2, skin.updates);
+}
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/info/InfoExpression.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+#define VALUES 6
+
+namespace
+{
+class CValueBool : public InfoBool
+{
+public:
+  CValueBool(const InfoEpochs& epochs, const bool& value)
+    : InfoBool("value", 0, epochs), m_source(value)
+  {
+  }
+
+  void Update(const CGUIListItem* item) override { m_value = m_source; }
+
+private:
+  const bool& m_source;
+};
+}
+
+class TestInfoExpression : public testing::Test
+{
+protected:
+  typedef InfoExpression::InfoSubexpressionPtr Node;
+
+  TestInfoExpression() : expression("test", 0, epochs)
+  {
+    for (const auto& value : values)
+      leaves.push_back(std::make_shared<CValueBool>(epochs, value));
+  }
+
+  Node Leaf(size_t index, bool invert = false)
+  {
+    return std::make_shared<InfoExpression::InfoLeaf>(leaves[index], invert);
+  }
+
+  Node Group(bool isAnd, const std::vector<Node>& children)
+  {
+    const auto type = isAnd ? InfoExpression::NODE_AND : InfoExpression::NODE_OR;
+    const size_t count = children.size();
+    auto group = std::make_shared<InfoExpression::InfoAssociativeGroup>(
+        type, children[count - 2], children[count - 1]);
+    for (size_t i = count - 2; i > 0; --i)
+      group->AddChild(children[i - 1]);
+    return group;
+  }
+
+  void Build(const Node& tree) { tree->Flatten(expression.m_nodes, expression.m_infos); }
+
+  bool Evaluate()
+  {
+    // the leaves are volatile, they are read again every frame
+    epochs.frame++;
+    return expression.Evaluate(0, nullptr);
+  }
+
+  size_t NodeCount() const { return expression.m_nodes.size(); }
+  size_t Size(size_t index) const { return expression.m_nodes[index].size; }
+  bool IsLeaf(size_t index) const
+  {
+    return expression.m_nodes[index].type == InfoExpression::NODE_LEAF;
+  }
+
+  // sets the values to the bits of combination, and checks the expression against the tree
+  void CheckAll(const std::function<bool()>& tree)
+  {
+    const unsigned int combinations = 1 << VALUES;
+    // in an order that moves different children to the front
+    for (unsigned int i = 0; i < combinations * 3; ++i)
+    {
+      const unsigned int combination = (i * 37) % combinations;
+      for (size_t bit = 0; bit < VALUES; ++bit)
+        values[bit] = (combination >> bit) & 1;
+      ASSERT_EQ(tree(), Evaluate()) << "combination " << combination;
+      ASSERT_EQ(tree(), Evaluate()) << "combination " << combination << " evaluated again";
+    }
+  }
+
+  InfoEpochs epochs;
+  bool values[VALUES] = {};
+  std::vector<InfoPtr> leaves;
+  InfoExpression expression;
+};
+
+TEST_F(TestInfoExpression, Flatten)
+{
+  // A|[B+!C]|[D+[E|F]]
+  Build(Group(false, {Leaf(0), Group(true, {Leaf(1), Leaf(2, true)}),
+                      Group(true, {Leaf(3), Group(false, {Leaf(4), Leaf(5)})})}));
+  ASSERT_EQ(10u, NodeCount());
+  EXPECT_EQ(10u, Size(0));
+  EXPECT_TRUE(IsLeaf(1));
+  EXPECT_EQ(3u, Size(2));
+  EXPECT_EQ(5u, Size(5));
+  EXPECT_EQ(3u, Size(7));
+}
+
+TEST_F(TestInfoExpression, RotateGroups)
+{
+  const bool* v = values;
+  Build(Group(false, {Leaf(0), Group(true, {Leaf(1), Leaf(2, true)}),
+                      Group(true, {Leaf(3), Group(false, {Leaf(4), Leaf(5)})})}));
+
+  // B+!C is true, it moves in front of A
+  values[1] = true;
+  EXPECT_TRUE(Evaluate());
+  EXPECT_EQ(3u, Size(1));
+  EXPECT_TRUE(IsLeaf(4));
+
+  // D+[E|F] is true, it moves in front of both, F in front of E
+  values[1] = false;
+  values[3] = true;
+  values[5] = true;
+  EXPECT_TRUE(Evaluate());
+  ASSERT_EQ(5u, Size(1));
+  EXPECT_EQ(3u, Size(3));
+  EXPECT_EQ(3u, Size(6));
+  EXPECT_TRUE(IsLeaf(9));
+
+  // all three false, the order stays
+  values[3] = false;
+  EXPECT_FALSE(Evaluate());
+  EXPECT_EQ(5u, Size(1));
+  EXPECT_EQ(10u, Size(0));
+
+  CheckAll([v]() { return v[0] || (v[1] && !v[2]) || (v[3] && (v[4] || v[5])); });
+}
+
+TEST_F(TestInfoExpression, RotateAnd)
+{
+  // A+[B|!C]+[D|[E+F]]+!A is never true, its children are moved around
+  Build(Group(true, {Leaf(0), Group(false, {Leaf(1), Leaf(2, true)}),
+                     Group(false, {Leaf(3), Group(true, {Leaf(4), Leaf(5)})}), Leaf(0, true)}));
+  CheckAll([]() { return false; });
+
+  EXPECT_EQ(11u, Size(0));
+}
+
+TEST_F(TestInfoExpression, MatchesTree)
+{
+  const bool* v = values;
+  // [A|!B]+[[C+D]|[E+!F]|B]
+  Build(Group(true, {Group(false, {Leaf(0), Leaf(1, true)}),
+                     Group(false, {Group(true, {Leaf(2), Leaf(3)}),
+                                   Group(true, {Leaf(4), Leaf(5, true)}), Leaf(1)})}));
+  CheckAll([v]() { return (v[0] || !v[1]) && ((v[2] && v[3]) || (v[4] && !v[5]) || v[1]); });
+  EXPECT_EQ(NodeCount(), Size(0));
+}
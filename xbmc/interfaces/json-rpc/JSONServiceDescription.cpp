@@ -243,7 +243,10 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.GetMetrics",                              CXBMCOperations::GetMetrics },
+  { "XBMC.SetTracing",                              CXBMCOperations::SetTracing },
+  { "XBMC.DumpTrace",                               CXBMCOperations::DumpTrace }
 };
 
 JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
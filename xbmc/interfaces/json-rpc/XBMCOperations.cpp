@@ -11,6 +11,10 @@
 #include "ServiceBroker.h"
 #include "messaging/ApplicationMessenger.h"
 #include "powermanagement/PowerManager.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/Metrics.h"
+#include "utils/TraceProfiler.h"
 #include "utils/Variant.h"
 
 using namespace JSONRPC;
@@ -85,3 +89,36 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const std::string &method, ITran
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::GetMetrics(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CMetrics& metrics = CMetrics::GetInstance();
+  metrics.Serialize(result, parameterObject["prefix"].asString());
+  if (parameterObject["reset"].asBoolean())
+    metrics.Reset();
+
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::SetTracing(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CTraceProfiler::GetInstance().SetEnabled(parameterObject["enabled"].asBoolean());
+
+  return ACK;
+}
+
+JSONRPC_STATUS CXBMCOperations::DumpTrace(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  // clients don't choose the file, they could overwrite any file Kodi may write
+  const std::string& file =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_traceFile;
+
+  size_t events = 0;
+  if (!CTraceProfiler::GetInstance().Dump(file, events))
+    return InternalError;
+
+  result["file"] = file;
+  result["events"] = static_cast<uint64_t>(events);
+
+  return OK;
+}
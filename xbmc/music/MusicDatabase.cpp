@@ -2804,7 +2804,8 @@ void CMusicDatabase::GetFileItemFromDataset(CFileItem* item, const CMusicDbUrl &
   GetFileItemFromDataset(m_pDS->get_sql_record(), item, baseUrl);
 }
 
-void CMusicDatabase::GetFileItemFromDataset(const dbiplus::sql_record* const record, CFileItem* item, const CMusicDbUrl &baseUrl)
+template<typename Record>
+void CMusicDatabase::GetFileItemFromDataset(const Record* const record, CFileItem* item, const CMusicDbUrl &baseUrl)
 {
   // get the artist string from songview (not the song_artist and artist tables)
   item->GetMusicInfoTag()->SetArtistDesc(record->at(song_strArtists).get_asString());
@@ -2947,7 +2948,8 @@ CAlbum CMusicDatabase::GetAlbumFromDataset(const dbiplus::sql_record* const reco
   return album;
 }
 
-CArtistCredit CMusicDatabase::GetArtistCreditFromDataset(const dbiplus::sql_record* const record, int offset /* = 0 */)
+template<typename Record>
+CArtistCredit CMusicDatabase::GetArtistCreditFromDataset(const Record* const record, int offset /* = 0 */)
 {
   CArtistCredit artistCredit;
   artistCredit.idArtist = record->at(offset + artistCredit_idArtist).get_asInt();
@@ -2961,7 +2963,8 @@ CArtistCredit CMusicDatabase::GetArtistCreditFromDataset(const dbiplus::sql_reco
   return artistCredit;
 }
 
-CMusicRole CMusicDatabase::GetArtistRoleFromDataset(const dbiplus::sql_record* const record, int offset /* = 0 */)
+template<typename Record>
+CMusicRole CMusicDatabase::GetArtistRoleFromDataset(const Record* const record, int offset /* = 0 */)
 {
   CMusicRole ArtistRole(record->at(offset + artistCredit_idRole).get_asInt(),
                         record->at(offset + artistCredit_strRole).get_asString(),
@@ -5297,7 +5300,7 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
     // run query
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
     querytime = XbmcThreads::SystemClockMillis();
-    if (!m_pDS->query(strSQL)) 
+    if (!m_pDS->query_bound(strSQL))
       return false;
     int iRowsFound = m_pDS->num_rows();
     if (iRowsFound == 0)
@@ -5713,8 +5716,8 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
     querytime = XbmcThreads::SystemClockMillis();
-    // run query
-    if (!m_pDS->query(strSQL))
+    // run query, fetching the (potentially very large) result in columnar form
+    if (!m_pDS->query_bound(strSQL, dbiplus::rsColumns))
       return false;
 
     int iRowsFound = m_pDS->num_rows();
@@ -5743,12 +5746,13 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     int songArtistOffset = song_enumCount;
     int songId = -1;
     VECARTISTCREDITS artistCredits;
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
+    const dbiplus::column_data &data = m_pDS->get_result_set().columns;
     int count = 0;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::column_record row = data.row(targetRow);
+      const dbiplus::column_record* const record = &row;
 
       try
       {
@@ -5860,7 +5864,7 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!m_pDS->query_bound(strSQL))
       return false;
 
     int iRowsFound = m_pDS->num_rows();
@@ -10725,6 +10729,10 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 
 bool CMusicDatabase::CommitTransaction()
 {
+  // the counts are refreshed once the batch is committed
+  if (InBatch())
+    return CDatabase::CommitTransaction();
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
@@ -31,6 +31,7 @@ namespace dbiplus
 {
   class field_value;
   typedef std::vector<field_value> sql_record;
+  class column_record;
 }
 
 #include <set>
@@ -741,11 +742,15 @@ private:
   CArtist GetArtistFromDataset(const dbiplus::sql_record* const record, int offset = 0, bool needThumb = true);
   CAlbum GetAlbumFromDataset(dbiplus::Dataset* pDS, int offset = 0, bool imageURL = false);
   CAlbum GetAlbumFromDataset(const dbiplus::sql_record* const record, int offset = 0, bool imageURL = false);
-  CArtistCredit GetArtistCreditFromDataset(const dbiplus::sql_record* const record, int offset = 0);
-  CMusicRole GetArtistRoleFromDataset(const dbiplus::sql_record* const record, int offset = 0);
+  // Record is either a dbiplus::sql_record or a dbiplus::column_record
+  template<typename Record>
+  CArtistCredit GetArtistCreditFromDataset(const Record* const record, int offset = 0);
+  template<typename Record>
+  CMusicRole GetArtistRoleFromDataset(const Record* const record, int offset = 0);
   std::string GetMediaDateFromFile(const std::string& strFileNameAndPath);
   void GetFileItemFromDataset(CFileItem* item, const CMusicDbUrl &baseUrl);
-  void GetFileItemFromDataset(const dbiplus::sql_record* const record, CFileItem* item, const CMusicDbUrl &baseUrl);
+  template<typename Record>
+  void GetFileItemFromDataset(const Record* const record, CFileItem* item, const CMusicDbUrl &baseUrl);
   void GetFileItemFromArtistCredits(VECARTISTCREDITS& artistCredits, CFileItem* item);
     
   bool DeleteRemovedLinks();
@@ -41,18 +41,23 @@
 #include "music/MusicUtils.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderTagLib.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 using namespace MUSIC_INFO;
@@ -62,6 +67,55 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+// songs added to the library before the database batch is committed
+#define SCAN_BATCH_SONGS 1000
+
+namespace
+{
+/*!
+ \brief Tags to be read by any number of threads at once.
+ Each thread calls ReadNext() until it returns false, the owner then waits for the rest.
+ */
+class CTagReadBatch
+{
+public:
+  void Add(const CFileItemPtr& item, IMusicInfoTagLoader* loader)
+  {
+    m_reads.emplace_back(item, std::unique_ptr<IMusicInfoTagLoader>(loader));
+  }
+  bool Empty() const { return m_reads.empty(); }
+
+  bool ReadNext()
+  {
+    const size_t i = m_next++;
+    if (i >= m_reads.size())
+      return false;
+
+    // a cancelled batch only counts the files left, so that Wait() returns
+    const CFileItemPtr& item = m_reads[i].first;
+    if (!m_cancelled)
+      m_reads[i].second->Load(item->GetPath(), *item->GetMusicInfoTag());
+    if (++m_done == m_reads.size())
+      m_finished.Set();
+    return true;
+  }
+
+  void Cancel() { m_cancelled = true; }
+
+  void Wait()
+  {
+    m_finished.Wait();
+  }
+
+private:
+  std::vector<std::pair<CFileItemPtr, std::unique_ptr<IMusicInfoTagLoader>>> m_reads;
+  std::atomic<size_t> m_next{0};
+  std::atomic<size_t> m_done{0};
+  std::atomic<bool> m_cancelled{false};
+  CEvent m_finished{true};
+};
+}
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -122,6 +176,14 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      int tagReaders = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iMusicLibraryTagReaders;
+      if (tagReaders <= 0)
+        tagReaders = std::min(CServiceBroker::GetCPUInfo()->GetCPUCount(), 8);
+      // this thread reads tags as well
+      m_tagReaderCount = tagReaders - 1;
+      if (m_tagReaderCount > 0)
+        m_tagReaders.reset(new CJobQueue(false, m_tagReaderCount, CJob::PRIORITY_DEDICATED));
+
       bool commit = true;
       for (const auto& it : m_pathsToScan)
       {
@@ -141,7 +203,26 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+
+        // add the source in large transactions, but commit before going online for art and info
+        m_musicDatabase.BeginBatch();
+        m_songsInBatch = 0;
         bool scancomplete = DoScan(it);
+        CommitBatch();
+
+        // scan the folders that were lost with a batch again, outside of one
+        if (scancomplete && !m_pathsToRescan.empty())
+        {
+          for (const auto& path : m_pathsToRescan)
+            m_seenPaths.erase(path);
+          for (const auto& path : m_pathsToRescan)
+          {
+            scancomplete = DoScan(path);
+            if (!scancomplete)
+              break;
+          }
+        }
+        m_pathsToRescan.clear();
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -189,6 +270,7 @@ void CMusicInfoScanner::Process()
       }
 
       m_fileCountReader.StopThread();
+      m_tagReaders.reset();
 
       m_musicDatabase.EmptyCache();
 
@@ -291,6 +373,9 @@ void CMusicInfoScanner::Start(const std::string& strDirectory, int flags)
   m_pathsToScan.clear();
   m_seenPaths.clear();
   m_albumsAdded.clear();
+  m_albumsInBatch.clear();
+  m_pathsInBatch.clear();
+  m_pathsToRescan.clear();
   m_flags = flags;
 
   m_musicDatabase.Open();
@@ -499,7 +584,8 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
   // check whether we need to rescan or not
   std::string dbHash;
-  if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
+  if ((m_flags & SCAN_RESCAN) || m_pathsToRescan.find(strDirectory) != m_pathsToRescan.end() ||
+      !m_musicDatabase.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
   { // path has changed - rescan
     if (dbHash.empty())
       CLog::Log(LOGDEBUG, "%s Scanning dir '%s' as not in the database", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
@@ -562,11 +648,9 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> files;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -575,15 +659,22 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    files.push_back(pItem);
+  }
+
+  if (m_bStop)
+    return INFO_CANCELLED;
+
+  LoadTags(files);
+
+  for (const auto& pItem : files)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
-    }
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -607,6 +698,56 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
   return INFO_ADDED;
 }
 
+void CMusicInfoScanner::LoadTags(const std::vector<CFileItemPtr>& files)
+{
+  std::shared_ptr<CTagReadBatch> batch = std::make_shared<CTagReadBatch>();
+  std::vector<std::pair<CFileItemPtr, std::unique_ptr<IMusicInfoTagLoader>>> serialLoads;
+  for (const auto& pItem : files)
+  {
+    if (pItem->GetMusicInfoTag()->Loaded())
+      continue;
+
+    // loaders are created here as add-on instances must not be shared between threads
+    std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
+    if (nullptr == pLoader)
+      continue;
+
+    if (m_tagReaders && dynamic_cast<CTagLoaderTagLib*>(pLoader.get()))
+      batch->Add(pItem, pLoader.release());
+    else
+      serialLoads.emplace_back(pItem, std::move(pLoader));
+  }
+
+  if (!batch->Empty())
+  {
+    // a reader starting after the batch is done finds nothing left and returns right away
+    for (int i = 0; i < m_tagReaderCount; ++i)
+      m_tagReaders->Submit([batch]() {
+        while (batch->ReadNext())
+        {
+        }
+      });
+  }
+
+  for (const auto& load : serialLoads)
+  {
+    if (m_bStop)
+      break;
+    load.second->Load(load.first->GetPath(), *load.first->GetMusicInfoTag());
+  }
+
+  if (batch->Empty())
+    return;
+
+  // read along with the tag readers, they stop with this thread
+  while (!m_bStop && batch->ReadNext())
+  {
+  }
+  if (m_bStop)
+    batch->Cancel();
+  batch->Wait();
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
@@ -887,6 +1028,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 {
   MAPSONGS songsMap;
 
+  if (m_musicDatabase.InBatch())
+    m_pathsInBatch.push_back(strDirectory);
+
   // get all information for all files in current directory from database, and remove them
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
@@ -942,14 +1086,58 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
       album.releaseType = CAlbum::Single;
 
     album.strPath = strDirectory;
+    const bool inBatch = m_musicDatabase.InBatch();
     m_musicDatabase.AddAlbum(album, m_idSourcePath);
+    if (inBatch && !m_musicDatabase.InBatch())
+    {
+      // the batch was rolled back with this album, this folder is among those scanned again
+      OnBatchLost();
+      break;
+    }
+    if (inBatch)
+      m_albumsInBatch.push_back(album.idAlbum);
     m_albumsAdded.insert(album.idAlbum);
 
     numAdded += static_cast<int>(album.songs.size());
   }
+
+  // don't keep the database locked for too long
+  m_songsInBatch += numAdded;
+  if (m_songsInBatch >= SCAN_BATCH_SONGS && m_musicDatabase.InBatch())
+  {
+    CommitBatch();
+    m_musicDatabase.BeginBatch();
+  }
   return numAdded;
 }
 
+void CMusicInfoScanner::CommitBatch()
+{
+  if (!m_musicDatabase.CommitBatch())
+    OnBatchLost();
+
+  m_albumsInBatch.clear();
+  m_pathsInBatch.clear();
+  m_songsInBatch = 0;
+}
+
+void CMusicInfoScanner::OnBatchLost()
+{
+  if (m_albumsInBatch.empty() && m_pathsInBatch.empty())
+    return;
+
+  CLog::Log(LOGWARNING, "%s - %u albums in %u folders were rolled back, scanning them again",
+            __FUNCTION__, static_cast<unsigned int>(m_albumsInBatch.size()),
+            static_cast<unsigned int>(m_pathsInBatch.size()));
+
+  for (const auto idAlbum : m_albumsInBatch)
+    m_albumsAdded.erase(idAlbum);
+  m_pathsToRescan.insert(m_pathsInBatch.begin(), m_pathsInBatch.end());
+
+  m_albumsInBatch.clear();
+  m_pathsInBatch.clear();
+}
+
 void MUSIC_INFO::CMusicInfoScanner::ScrapeInfoAddedAlbums()
 {
   /* Strategy: Having scanned tags, make a list of albums and add them to the library, only then try
@@ -16,9 +16,13 @@
 #include "threads/Thread.h"
 #include "utils/ScraperUrl.h"
 
+#include <memory>
+#include <vector>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
+class CJobQueue;
 
 namespace MUSIC_INFO
 {
@@ -223,6 +227,15 @@ protected:
   void RetrieveLocalArt();
   void ScrapeInfoAddedAlbums();
 
+  /*! \brief Commit the database batch, and note what was lost if it couldn't be.
+   */
+  void CommitBatch();
+
+  /*! \brief Forget the albums added in a batch that was rolled back, and note their folders
+   to be scanned again.
+   */
+  void OnBatchLost();
+
   /*! \brief Scan in the ID3/Ogg/FLAC tags for a bunch of FileItems
     Given a list of FileItems, scan in the tags for those FileItems
    and populate a new FileItemList with the files that were successfully scanned.
@@ -231,6 +244,13 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Load the tags of files that haven't got them yet
+   TagLib based loaders run on the tag reader workers, next to this thread. Other loaders, such as
+   audio decoder add-ons, are run on this thread only.
+   \param files [in] the files to load the tags of
+   */
+  void LoadTags(const std::vector<CFileItemPtr>& files);
   int GetPathHash(const CFileItemList &items, std::string &hash);
 
   void Run() override;
@@ -261,5 +281,11 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+  std::unique_ptr<CJobQueue> m_tagReaders; //!< null while tags are read on the scanner thread only
+  int m_tagReaderCount = 0;
+  int m_songsInBatch = 0; //!< songs added since the database batch was last committed
+  std::vector<int> m_albumsInBatch; //!< albums added since the database batch was last committed
+  std::vector<std::string> m_pathsInBatch; //!< folders scanned since then
+  std::set<std::string> m_pathsToRescan; //!< folders rolled back with a batch
 };
 }
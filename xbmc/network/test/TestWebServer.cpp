@@ -17,6 +17,8 @@
 #include "URL.h"
 #include "filesystem/CurlFile.h"
 #include "filesystem/File.h"
+#include "filesystem/HttpCache.h"
+#include "filesystem/SpecialProtocol.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
@@ -594,6 +596,44 @@ TEST_F(TestWebServer, CanGetCachedFileWithOlderIfModifiedSince)
   CheckRangesTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanRevalidateFileInHttpCache)
+{
+  CHttpCache& cache = CHttpCache::GetInstance();
+  cache.Configure(CSpecialProtocol::TranslatePath("special://temp/testwebserverhttpcache/"), 1024 * 1024);
+  cache.Clear();
+
+  // the html file is sent with "no-cache", it's stored with its Last-Modified
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_HTML), result));
+  EXPECT_STREQ(TEST_FILES_DATA, result.c_str());
+  CHttpCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.stores);
+  EXPECT_EQ(1u, stats.entries);
+
+  // and revalidated by the next request, the webserver answers 304 and the stored file is used
+  CCurlFile curlRevalidated;
+  ASSERT_TRUE(curlRevalidated.Get(GetUrlOfTestFile(TEST_FILES_HTML), result));
+  EXPECT_STREQ(TEST_FILES_DATA, result.c_str());
+  CheckHtmlTestFileResponse(curlRevalidated);
+  stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.revalidations);
+  EXPECT_EQ(1u, stats.notModified);
+
+  // the ranges file may be used for a year, it's served without asking the webserver
+  CCurlFile curlRanges;
+  ASSERT_TRUE(curlRanges.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  webserver.Stop();
+  CCurlFile curlCached;
+  ASSERT_TRUE(curlCached.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  EXPECT_STREQ(TEST_FILES_DATA_RANGES, result.c_str());
+  CheckRangesTestFileResponse(curlCached);
+  EXPECT_EQ(1u, cache.GetStats().hits);
+
+  cache.Clear();
+  cache.Configure("", 0);
+}
+
 /** @todo Fix these two tests, they keep failing and
  *  we want to enable the test suite on PR
  */
@@ -897,3 +937,64 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, CanReadFileOverSeveralConnections)
+{
+  // big enough to be split into ranges for all connections
+  const size_t size = 32 * 1024 * 1024 + 1234;
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; i++)
+    content[i] = static_cast<char>((i * 2654435761u) >> 13);
+
+  CFile* tempFile = XBMC_CREATETEMPFILE(".bin");
+  ASSERT_NE(nullptr, tempFile);
+  ASSERT_EQ(static_cast<ssize_t>(size), tempFile->Write(content.data(), size));
+  tempFile->Close();
+
+  // share the directory of the file
+  const std::string tempPath = XBMC_TEMPFILEPATH(tempFile);
+  CMediaSource source;
+  source.strName = "WebServer Temp Share";
+  source.strPath = URIUtils::GetDirectory(tempPath);
+  source.vecPaths.push_back(source.strPath);
+  source.m_allowSharing = true;
+  source.m_iDriveType = CMediaSource::SOURCE_TYPE_LOCAL;
+  source.m_iLockMode = LOCK_MODE_EVERYONE;
+  source.m_ignore = true;
+  CMediaSourceSettings::GetInstance().AddShare("videos", source);
+
+  CCurlFile curl;
+  curl.SetConnections(4);
+  ASSERT_TRUE(curl.Open(CURL(GetUrl(URIUtils::AddFileToFolder("vfs", CURL::Encode(tempPath))))));
+  EXPECT_EQ(static_cast<int64_t>(size), curl.GetLength());
+
+  // read it all in order
+  std::string result(size, '\0');
+  size_t total = 0;
+  while (total < size)
+  {
+    const ssize_t read = curl.Read(&result[total], 65536);
+    ASSERT_GT(read, 0);
+    total += read;
+  }
+  EXPECT_EQ(0, curl.Read(&result[0], 1));
+  EXPECT_TRUE(result == content);
+
+  // jump back and forth
+  const int64_t positions[] = { 17 * 1024 * 1024 + 5, 100, static_cast<int64_t>(size) - 10 };
+  for (int64_t position : positions)
+  {
+    char buffer[10];
+    ASSERT_EQ(position, curl.Seek(position, SEEK_SET));
+    for (size_t got = 0; got < sizeof(buffer);)
+    {
+      const ssize_t read = curl.Read(buffer + got, sizeof(buffer) - got);
+      ASSERT_GT(read, 0);
+      got += read;
+    }
+    EXPECT_EQ(0, memcmp(buffer, content.data() + position, sizeof(buffer)));
+  }
+
+  curl.Close();
+  XBMC_DELETETEMPFILE(tempFile);
+}
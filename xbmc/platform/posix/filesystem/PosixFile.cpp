@@ -267,6 +267,22 @@ int CPosixFile::IoControl(EIoControl request, void* param)
         return 0; // size of file is 1 byte or more and seeking not possible
     }
   }
+#if defined(POSIX_FADV_SEQUENTIAL)
+  else if (request == IOCTRL_HINT_SEQUENTIAL)
+  {
+    // lets the kernel read ahead further than usual
+    return posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL) == 0 ? 0 : -1;
+  }
+#endif
+#if defined(POSIX_FADV_WILLNEED)
+  else if (request == IOCTRL_READ_AHEAD)
+  {
+    if (!param)
+      return -1;
+    const SReadAhead* range = static_cast<const SReadAhead*>(param);
+    return posix_fadvise(m_fd, range->offset, range->length, POSIX_FADV_WILLNEED) == 0 ? 0 : -1;
+  }
+#endif
 
   return -1;
 }
@@ -258,6 +258,7 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_imageVariants = false;
 
   m_sambaclienttimeout = 30;
   m_sambadoscodepage = "";
@@ -284,11 +285,14 @@ void CAdvancedSettings::Initialize()
   m_videoItemSeparator = " / ";
   m_iMusicLibraryDateAdded = 1; // prefer mtime over ctime and current time
   m_bMusicLibraryUseISODates = false;
+  m_iMusicLibraryTagReaders = 1;
 
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryUseFastHash = true;
+  m_videoLibraryScanConcurrency = 1;
+  m_videoLibraryScanConcurrencyProtocols.clear();
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
@@ -337,6 +341,8 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 30;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlConnections = 1;
+  m_httpCacheSize = 0;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
@@ -377,24 +383,38 @@ void CAdvancedSettings::Initialize()
   m_PVRDefaultSortOrder.sortBy = SortByDate;
   m_PVRDefaultSortOrder.sortOrder = SortOrderDescending;
 
+  m_dirCachePersistent = false;
+  m_dirCacheMaxSize = 64; // 64 MiB
+  m_dirCacheProtocols = {{"smb", 0}, {"nfs", 0}, {"dav", 0}, {"davs", 0}};
+
   m_cacheMemSize = 1024 * 1024 * 20; // 20 MiB
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
   m_cacheChunkSize = 128 * 1024; // 128 KiB
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheSparse = false;
+  m_cacheSpillSize = 0;
+  m_cacheLocalReadAhead = 0;
 
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_metricsDumpFile = "special://temp/metrics.json";
+  m_metricsDumpInterval = 0;
+
+  m_traceEnabled = false;
+  m_traceFile = "special://temp/trace.json";
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiSkinCache = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -757,6 +777,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
     XMLUtils::GetBoolean(pElement, "useisodates", m_bMusicLibraryUseISODates);
+    XMLUtils::GetInt(pElement, "tagreaders", m_iMusicLibraryTagReaders, 0, 32);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -782,6 +803,23 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iVideoLibraryRecentlyAddedItems, 1, INT_MAX);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bVideoLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "usefasthash", m_bVideoLibraryUseFastHash);
+    for (const TiXmlElement* pConcurrency = pElement->FirstChildElement("scanconcurrency");
+         pConcurrency; pConcurrency = pConcurrency->NextSiblingElement("scanconcurrency"))
+    {
+      if (!pConcurrency->FirstChild())
+        continue;
+      int concurrency = atoi(pConcurrency->FirstChild()->Value());
+      concurrency = std::max(1, std::min(32, concurrency));
+      const char* protocol = pConcurrency->Attribute("protocol");
+      if (protocol)
+      {
+        std::string name = protocol;
+        StringUtils::ToLower(name);
+        m_videoLibraryScanConcurrencyProtocols[name] = concurrency;
+      }
+      else
+        m_videoLibraryScanConcurrency = concurrency;
+    }
     XMLUtils::GetString(pElement, "itemseparator", m_videoItemSeparator);
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
@@ -821,6 +859,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlconnections", m_curlConnections, 1, 8);
+    XMLUtils::GetInt(pElement, "httpcachesize", m_httpCacheSize, 0, 4096);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
     XMLUtils::GetString(pElement, "catrustfile", m_caTrustFile);
@@ -833,6 +873,32 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "sparse", m_cacheSparse);
+    XMLUtils::GetUInt(pElement, "spillsize", m_cacheSpillSize, 0, 65536);
+    XMLUtils::GetUInt(pElement, "localreadahead", m_cacheLocalReadAhead, 0, 512 * 1024 * 1024);
+  }
+
+  pElement = pRootElement->FirstChildElement("dircache");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "persistent", m_dirCachePersistent);
+    XMLUtils::GetUInt(pElement, "maxsize", m_dirCacheMaxSize, 1, 4096);
+    // <protocol name="smb" trust="0"/>, replacing the defaults
+    const TiXmlElement* pProtocol = pElement->FirstChildElement("protocol");
+    if (pProtocol)
+      m_dirCacheProtocols.clear();
+    for (; pProtocol; pProtocol = pProtocol->NextSiblingElement("protocol"))
+    {
+      const char* name = pProtocol->Attribute("name");
+      int trust = 0;
+      pProtocol->QueryIntAttribute("trust", &trust);
+      if (name && *name)
+      {
+        std::string protocol = name;
+        StringUtils::ToLower(protocol);
+        m_dirCacheProtocols[protocol] = std::max(trust, 0);
+      }
+    }
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -842,6 +908,20 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  pElement = pRootElement->FirstChildElement("metrics");
+  if (pElement)
+  {
+    XMLUtils::GetPath(pElement, "dumpfile", m_metricsDumpFile);
+    XMLUtils::GetUInt(pElement, "dumpinterval", m_metricsDumpInterval, 0, 86400);
+  }
+
+  pElement = pRootElement->FirstChildElement("trace");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_traceEnabled);
+    XMLUtils::GetPath(pElement, "dumpfile", m_traceFile);
+  }
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -1040,6 +1120,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  XMLUtils::GetBoolean(pRootElement, "imagevariants", m_imageVariants);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "uselocalecollation", m_useLocaleCollation);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
@@ -1197,6 +1278,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetBoolean(pElement, "skincache", m_guiSkinCache);
   }
 
   std::string seekSteps;
@@ -13,6 +13,7 @@
 #include "settings/lib/ISettingsHandler.h"
 #include "utils/SortUtils.h"
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -220,6 +221,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    bool m_imageVariants;     ///< \brief whether images in small controls use reduced size variants
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
@@ -240,6 +242,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
     bool m_bMusicLibraryUseISODates;
+    int m_iMusicLibraryTagReaders; //!< threads reading tags during a scan, 1 for the scanner thread only, 0 for one per core
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
@@ -251,6 +254,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iVideoLibraryRecentlyAddedItems;
     bool m_bVideoLibraryCleanOnUpdate;
     bool m_bVideoLibraryUseFastHash;
+    unsigned int m_videoLibraryScanConcurrency; //!< folders prefetched at once per source, 1 scans sequentially
+    std::map<std::string, unsigned int> m_videoLibraryScanConcurrencyProtocols; //!< overrides by protocol
     bool m_bVideoLibraryImportWatchedState;
     bool m_bVideoLibraryImportResumePoint;
     std::vector<std::string> m_videoEpisodeExtraArt;
@@ -285,6 +290,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlConnections;
+    int m_httpCacheSize; // MiB, 0 disables the http cache
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
 
@@ -333,16 +340,30 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiSkinCache; ///< keep skin windows with resolved includes on disk across restarts
     unsigned int m_addonPackageFolderSize;
 
+    bool m_dirCachePersistent; ///< keep listings of network directories on disk across restarts
+    unsigned int m_dirCacheMaxSize; ///< disk space for persisted directory listings in MiB
+    std::map<std::string, unsigned int> m_dirCacheProtocols; ///< protocols to persist, with the seconds a listing is used without revalidation
+
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
+    bool m_cacheSparse; ///< keep every cached range of seekable files instead of a single window
+    unsigned int m_cacheSpillSize; ///< disk space in MiB for ranges that don't fit in memory, 0 to drop them
+    unsigned int m_cacheLocalReadAhead; ///< bytes read ahead of the player from local files that aren't cached, 0 to read them directly
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    std::string m_metricsDumpFile;
+    unsigned int m_metricsDumpInterval; ///< seconds between writes of the metrics to m_metricsDumpFile, 0 to not write them
+
+    bool m_traceEnabled; ///< record a timeline of the main threads from the start, see CTraceProfiler
+    std::string m_traceFile; ///< where the timeline is dumped to unless told otherwise
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
@@ -50,6 +50,7 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+  m_changeCounter++;
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -65,16 +66,19 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+  m_changeCounter++;
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+  m_changeCounter++;
 }
 
 void CSkinSettings::Reset()
 {
   g_SkinInfo->Reset();
+  m_changeCounter++;
 
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
   infoMgr.ResetCache();
@@ -99,6 +103,7 @@ bool CSkinSettings::Load(const TiXmlNode *settings)
   CSingleLock lock(m_critical);
   m_settings.clear();
   m_settings = ADDON::CSkinInfo::ParseSettings(rootElement);
+  m_changeCounter++;
 
   return true;
 }
@@ -117,6 +122,7 @@ void CSkinSettings::Clear()
 {
   CSingleLock lock(m_critical);
   m_settings.clear();
+  m_changeCounter++;
 }
 
 void CSkinSettings::MigrateSettings(const ADDON::SkinPtr& skin)
@@ -155,6 +161,8 @@ void CSkinSettings::MigrateSettings(const ADDON::SkinPtr& skin)
 
   if (settingsMigrated)
   {
+    m_changeCounter++;
+
     // save the skin's settings
     skin->SaveSettings();
 
@@ -12,6 +12,7 @@
 #include "settings/ISubSettings.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 
@@ -39,6 +40,11 @@ public:
   void Reset(const std::string &setting);
   void Reset();
 
+  /*!
+   \brief Get a counter which changes whenever a skin setting changes.
+   */
+  unsigned int GetChangeCounter() const { return m_changeCounter; }
+
 protected:
   CSkinSettings();
   CSkinSettings(const CSkinSettings&) = delete;
@@ -48,4 +54,5 @@ protected:
 private:
   CCriticalSection m_critical;
   std::set<ADDON::CSkinSettingPtr> m_settings;
+  std::atomic<unsigned int> m_changeCounter{0};
 };
@@ -852,6 +852,8 @@ bool CSettingsManager::OnSettingChanging(const std::shared_ptr<const CSetting>&
 
 void CSettingsManager::OnSettingChanged(const std::shared_ptr<const CSetting>& setting)
 {
+  m_changeCounter++;
+
   CSharedLock lock(m_settingsCritical);
   if (!m_loaded || setting == nullptr)
     return;
@@ -1007,6 +1009,8 @@ bool CSettingsManager::OnSettingsLoading()
 
 void CSettingsManager::OnSettingsUnloaded()
 {
+  m_changeCounter++;
+
   CSharedLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsUnloaded();
@@ -1014,6 +1018,8 @@ void CSettingsManager::OnSettingsUnloaded()
 
 void CSettingsManager::OnSettingsLoaded()
 {
+  m_changeCounter++;
+
   CSharedLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsLoaded();
@@ -1040,6 +1046,8 @@ void CSettingsManager::OnSettingsSaved() const
 
 void CSettingsManager::OnSettingsCleared()
 {
+  m_changeCounter++;
+
   CSharedLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsCleared();
@@ -20,6 +20,7 @@
 #include "threads/SharedSection.h"
 #include "utils/StaticLoggerBase.h"
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <unordered_set>
@@ -155,6 +156,11 @@ public:
    \brief Returns whether the settings system has been loaded or not.
   */
   bool IsLoaded() const { return m_loaded; }
+  /*!
+   \brief Returns a counter which changes whenever the value of any setting
+   changes or the setting values are (un)loaded.
+   */
+  unsigned int GetChangeCounter() const { return m_changeCounter; }
 
   /*!
    \brief Adds the given section, its categories, groups and settings.
@@ -515,6 +521,7 @@ private:
 
   bool m_initialized = false;
   bool m_loaded = false;
+  std::atomic<unsigned int> m_changeCounter{0};
 
   SettingMap m_settings;
   using SettingSectionMap = std::map<std::string, std::shared_ptr<CSettingSection>>;
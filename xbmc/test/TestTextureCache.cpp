@@ -0,0 +1,262 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "TextureCacheJob.h"
+#include "TextureDatabase.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SharedSection.h"
+#include "threads/SingleLock.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+CTextureDetails MakeDetails(const std::string& file)
+{
+  CTextureDetails details;
+  details.file = file;
+  details.width = 16;
+  details.height = 16;
+  return details;
+}
+
+// what a caching job would have written for a texture
+std::string CreateCachedFile(const std::string& file)
+{
+  const std::string path = CTextureCache::GetCachedPath(file);
+  CFile cachedFile;
+  if (cachedFile.OpenForWrite(path, true))
+  {
+    cachedFile.Write("texture", 7);
+    cachedFile.Close();
+  }
+  return path;
+}
+
+bool GetStoredTexture(const std::string& url, CTextureDetails& details)
+{
+  CTextureDatabase database;
+  return database.Open() && database.GetCachedTexture(url, details);
+}
+}
+
+class TestTextureCache : public testing::Test
+{
+protected:
+  void SetUp() override { CTextureCache::GetInstance().Initialize(); }
+  void TearDown() override { CTextureCache::GetInstance().Deinitialize(); }
+
+  // writes the queued updates to the database
+  void Flush()
+  {
+    CTextureCache::GetInstance().Deinitialize();
+    CTextureCache::GetInstance().Initialize();
+  }
+
+  void Index(const std::string& url, const CTextureDetails& details)
+  {
+    CTextureCache& cache = CTextureCache::GetInstance();
+    CSingleLock lock(cache.m_databaseSection);
+    cache.IndexTexture(url, details);
+  }
+
+  // looking an image up counts as a use
+  bool IsIndexed(const std::string& url, CTextureDetails& details)
+  {
+    return CTextureCache::GetInstance().GetIndexedTexture(url, details);
+  }
+
+  bool IsIndexed(const std::string& url)
+  {
+    CTextureDetails details;
+    return IsIndexed(url, details);
+  }
+
+  size_t IndexSize()
+  {
+    CTextureCache& cache = CTextureCache::GetInstance();
+    CSharedLock lock(cache.m_indexSection);
+    return cache.m_index.size();
+  }
+};
+
+TEST_F(TestTextureCache, QueuedAdd)
+{
+  CTextureCache& cache = CTextureCache::GetInstance();
+  const std::string url = "/testtexturecache/queued.jpg";
+  ASSERT_TRUE(cache.AddCachedTexture(url, MakeDetails("testtexturecache-queued.jpg")));
+
+  // lookups see a queued add right away, and don't have it checked for updates
+  bool needsRecaching = true;
+  EXPECT_EQ(CTextureCache::GetCachedPath("testtexturecache-queued.jpg"),
+            cache.CheckCachedImage(url, needsRecaching));
+  EXPECT_FALSE(needsRecaching);
+
+  Flush();
+  CTextureDetails details;
+  ASSERT_TRUE(GetStoredTexture(url, details));
+  EXPECT_EQ("testtexturecache-queued.jpg", details.file);
+  EXPECT_TRUE(cache.HasCachedImage(url));
+
+  cache.ClearCachedImage(url);
+  EXPECT_FALSE(cache.HasCachedImage(url));
+}
+
+TEST_F(TestTextureCache, ClearQueuedAndStored)
+{
+  CTextureCache& cache = CTextureCache::GetInstance();
+  const std::string url = "/testtexturecache/recached.jpg";
+  ASSERT_TRUE(cache.AddCachedTexture(url, MakeDetails("testtexturecache-recached.jpg")));
+  Flush();
+
+  // recached in another format, the add is still queued while the old row is in the database
+  ASSERT_TRUE(cache.AddCachedTexture(url, MakeDetails("testtexturecache-recached.png")));
+  const std::string stored = CreateCachedFile("testtexturecache-recached.jpg");
+  const std::string queued = CreateCachedFile("testtexturecache-recached.png");
+  ASSERT_TRUE(CFile::Exists(stored));
+  ASSERT_TRUE(CFile::Exists(queued));
+
+  cache.ClearCachedImage(url);
+  EXPECT_FALSE(CFile::Exists(stored));
+  EXPECT_FALSE(CFile::Exists(queued));
+  EXPECT_FALSE(cache.HasCachedImage(url));
+
+  // the queued add is dropped, not written by the next flush
+  Flush();
+  CTextureDetails details;
+  EXPECT_FALSE(GetStoredTexture(url, details));
+}
+
+TEST_F(TestTextureCache, IndexEviction)
+{
+  const std::string used = "/testtexturecache/used.jpg";
+  Index(used, MakeDetails("testtexturecache-used.jpg"));
+
+  // fill the index with images used once, while one stays in use, until it's full
+  const auto url = [](size_t i) { return "/testtexturecache/" + std::to_string(i) + ".jpg"; };
+  size_t size = IndexSize();
+  size_t count = 0;
+  for (; count < 100000; ++count)
+  {
+    ASSERT_TRUE(IsIndexed(used));
+    Index(url(count), MakeDetails("testtexturecache-" + std::to_string(count) + ".jpg"));
+    if (IndexSize() <= size)
+      break;
+    size = IndexSize();
+  }
+  ASSERT_LT(count, 100000u) << "the index is never full";
+
+  // an eighth is dropped at once, the least recently used images
+  EXPECT_EQ(size - size / 8, IndexSize());
+  EXPECT_FALSE(IsIndexed(url(0)));
+  EXPECT_FALSE(IsIndexed(url(size / 8)));
+  EXPECT_TRUE(IsIndexed(url(size / 8 + 1)));
+  EXPECT_TRUE(IsIndexed(url(count - 1)));
+  EXPECT_TRUE(IsIndexed(url(count)));
+  EXPECT_TRUE(IsIndexed(used));
+
+  // replacing an image in a full index doesn't evict anything
+  const size_t capacity = size;
+  for (size_t i = count + 1; IndexSize() < capacity; ++i)
+    Index(url(i), MakeDetails("testtexturecache-" + std::to_string(i) + ".jpg"));
+  Index(used, MakeDetails("testtexturecache-used.png"));
+  EXPECT_EQ(capacity, IndexSize());
+  CTextureDetails details;
+  ASSERT_TRUE(IsIndexed(used, details));
+  EXPECT_EQ("testtexturecache-used.png", details.file);
+}
+
+class TestImageVariant : public testing::Test
+{
+protected:
+  TestImageVariant()
+    : settings(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()),
+      imageVariants(settings->m_imageVariants),
+      imageRes(settings->m_imageRes)
+  {
+    settings->m_imageVariants = true;
+    settings->m_imageRes = 720;
+  }
+
+  ~TestImageVariant() override
+  {
+    settings->m_imageVariants = imageVariants;
+    settings->m_imageRes = imageRes;
+  }
+
+  std::string Variant(unsigned int size) const
+  {
+    return CTextureUtils::GetWrappedImageURL(image, "",
+                                             "width=" + std::to_string(size) +
+                                                 "&height=" + std::to_string(size));
+  }
+
+  const std::shared_ptr<CAdvancedSettings> settings;
+  const bool imageVariants;
+  const unsigned int imageRes;
+  const std::string image = "/testtexturecache/poster.jpg";
+};
+
+TEST_F(TestImageVariant, Sizes)
+{
+  CTextureCache& cache = CTextureCache::GetInstance();
+
+  // the smallest size that covers the larger side
+  EXPECT_EQ(Variant(256), cache.GetImageVariant(image, 1, 1));
+  EXPECT_EQ(Variant(256), cache.GetImageVariant(image, 256, 100));
+  EXPECT_EQ(Variant(512), cache.GetImageVariant(image, 100, 257));
+  EXPECT_EQ(Variant(512), cache.GetImageVariant(image, 512, 512));
+
+  // too large for any, or no size known
+  EXPECT_EQ(image, cache.GetImageVariant(image, 513, 100));
+  EXPECT_EQ(image, cache.GetImageVariant(image, 0, 100));
+  EXPECT_EQ(image, cache.GetImageVariant(image, 100, 0));
+
+  // a wrapped image without options is the same image
+  const std::string wrapped = CTextureUtils::GetWrappedImageURL(image);
+  EXPECT_EQ(Variant(256), cache.GetImageVariant(wrapped, 200, 200));
+}
+
+TEST_F(TestImageVariant, CachedResolution)
+{
+  CTextureCache& cache = CTextureCache::GetInstance();
+
+  // only sizes smaller than the full cached image
+  settings->m_imageRes = 512;
+  EXPECT_EQ(Variant(256), cache.GetImageVariant(image, 200, 200));
+  EXPECT_EQ(image, cache.GetImageVariant(image, 300, 300));
+
+  settings->m_imageRes = 256;
+  EXPECT_EQ(image, cache.GetImageVariant(image, 200, 200));
+}
+
+TEST_F(TestImageVariant, Unchanged)
+{
+  CTextureCache& cache = CTextureCache::GetInstance();
+
+  // transformed images already have their size
+  const std::string transformed = Variant(512);
+  EXPECT_EQ(transformed, cache.GetImageVariant(transformed, 200, 200));
+  const std::string music = CTextureUtils::GetWrappedImageURL(image, "music");
+  EXPECT_EQ(music, cache.GetImageVariant(music, 200, 200));
+
+  // images that aren't cached
+  EXPECT_EQ("special://skin/media/icon.png",
+            cache.GetImageVariant("special://skin/media/icon.png", 200, 200));
+  EXPECT_EQ("icon.png", cache.GetImageVariant("icon.png", 200, 200));
+  EXPECT_EQ("", cache.GetImageVariant("", 200, 200));
+
+  settings->m_imageVariants = false;
+  EXPECT_EQ(image, cache.GetImageVariant(image, 200, 200));
+}
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "BenchUtils.h"
+#include "utils/CharsetConverter.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_CharsetConverterUtf8ToW(benchmark::State& state)
+{
+  const std::string utf8 = BENCH::MakeString(static_cast<size_t>(state.range(0))) + "\xc3\xa4\xc3\xb6\xc3\xbc";
+  std::wstring wide;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToW(utf8, wide, false);
+    benchmark::DoNotOptimize(wide);
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_CharsetConverterUtf8ToW)->Arg(32)->Arg(1024);
+
+static void BM_CharsetConverterUtf8ToUtf32(benchmark::State& state)
+{
+  const std::string utf8 = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  std::u32string utf32;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToUtf32(utf8, utf32);
+    benchmark::DoNotOptimize(utf32);
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_CharsetConverterUtf8ToUtf32)->Arg(32)->Arg(1024);
+
+static void BM_CharsetConverterWToUtf8(benchmark::State& state)
+{
+  std::wstring wide;
+  CCharsetConverter::utf8ToW(BENCH::MakeString(static_cast<size_t>(state.range(0))), wide, false);
+  std::string utf8;
+  for (auto _ : state)
+  {
+    CCharsetConverter::wToUTF8(wide, utf8);
+    benchmark::DoNotOptimize(utf8);
+  }
+  state.SetBytesProcessed(state.iterations() * utf8.size());
+}
+BENCHMARK(BM_CharsetConverterWToUtf8)->Arg(32)->Arg(1024);
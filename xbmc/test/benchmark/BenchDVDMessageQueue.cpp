@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// build with and without ENABLE_LOCKFREE_MSGQUEUE to compare the two queues
+
+static void BM_DVDMessageQueuePutGet(benchmark::State& state)
+{
+  CDVDMessageQueue queue("bench");
+  queue.Init();
+  CDVDMsg* msg = new CDVDMsg(CDVDMsg::GENERAL_RESYNC);
+  for (auto _ : state)
+  {
+    queue.Put(msg->Acquire());
+    CDVDMsg* out;
+    if (queue.Get(&out, 0) == MSGQ_OK)
+      out->Release();
+  }
+  msg->Release();
+  queue.End();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DVDMessageQueuePutGet);
+
+static void BM_DVDMessageQueueProducers(benchmark::State& state)
+{
+  const int producers = static_cast<int>(state.range(0));
+  const int batch = 2000;
+  CDVDMessageQueue queue("bench");
+  queue.Init();
+  CDVDMsg* msg = new CDVDMsg(CDVDMsg::GENERAL_RESYNC);
+  for (auto _ : state)
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++)
+    {
+      threads.emplace_back([&queue, msg, batch]() {
+        for (int n = 0; n < batch; n++)
+          queue.Put(msg->Acquire());
+      });
+    }
+
+    for (int n = 0; n < producers * batch; n++)
+    {
+      CDVDMsg* out;
+      if (queue.Get(&out, 1000) == MSGQ_OK)
+        out->Release();
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+  }
+  msg->Release();
+  queue.End();
+  state.SetItemsProcessed(state.iterations() * producers * batch);
+}
+BENCHMARK(BM_DVDMessageQueueProducers)->Arg(1)->Arg(2)->UseRealTime();
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "BenchUtils.h"
+#include "utils/Crc32.h"
+#include "utils/Digest.h"
+
+#include <benchmark/benchmark.h>
+
+using KODI::UTILITY::CDigest;
+
+static void BM_DigestMD5(benchmark::State& state)
+{
+  const std::string input = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(CDigest::Calculate(CDigest::Type::MD5, input));
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_DigestMD5)->Arg(64)->Arg(64 * 1024);
+
+static void BM_DigestSHA256(benchmark::State& state)
+{
+  const std::string input = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(CDigest::Calculate(CDigest::Type::SHA256, input));
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_DigestSHA256)->Arg(64)->Arg(64 * 1024);
+
+static void BM_Crc32Compute(benchmark::State& state)
+{
+  const std::string input = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Crc32::Compute(input));
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Crc32Compute)->Arg(64)->Arg(64 * 1024);
+
+static void BM_Crc32ComputeFromLowerCase(benchmark::State& state)
+{
+  const std::string input = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Crc32::ComputeFromLowerCase(input));
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Crc32ComputeFromLowerCase)->Arg(256);
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "BenchUtils.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_JSONVariantWriter(benchmark::State& state)
+{
+  const CVariant list = BENCH::MakeItemList(static_cast<int>(state.range(0)));
+  std::string json;
+  for (auto _ : state)
+  {
+    CJSONVariantWriter::Write(list, json, true);
+    benchmark::DoNotOptimize(json);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JSONVariantWriter)->Arg(10)->Arg(1000);
+
+static void BM_JSONVariantParser(benchmark::State& state)
+{
+  std::string json;
+  CJSONVariantWriter::Write(BENCH::MakeItemList(static_cast<int>(state.range(0))), json, true);
+  for (auto _ : state)
+  {
+    CVariant result;
+    CJSONVariantParser::Parse(json, result);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JSONVariantParser)->Arg(10)->Arg(1000);
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "utils/RingBuffer.h"
+#include "utils/SPSCRingBuffer.h"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+static void BM_RingBufferWriteRead(benchmark::State& state)
+{
+  const unsigned int chunk = static_cast<unsigned int>(state.range(0));
+  CRingBuffer buffer;
+  buffer.Create(chunk * 8);
+  std::vector<char> in(chunk, 'x');
+  std::vector<char> out(chunk);
+  for (auto _ : state)
+  {
+    buffer.WriteData(in.data(), chunk);
+    buffer.ReadData(out.data(), chunk);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * chunk);
+}
+BENCHMARK(BM_RingBufferWriteRead)->Arg(188)->Arg(4096)->Arg(64 * 1024);
+
+static void BM_SPSCRingBufferWriteRead(benchmark::State& state)
+{
+  const unsigned int chunk = static_cast<unsigned int>(state.range(0));
+  CSPSCRingBuffer buffer;
+  buffer.Create(chunk * 8);
+  std::vector<char> in(chunk, 'x');
+  std::vector<char> out(chunk);
+  for (auto _ : state)
+  {
+    buffer.WriteData(in.data(), chunk);
+    buffer.ReadData(out.data(), chunk);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * chunk);
+}
+BENCHMARK(BM_SPSCRingBufferWriteRead)->Arg(188)->Arg(4096)->Arg(64 * 1024);
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "BenchUtils.h"
+#include "utils/StringUtils.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_StringUtilsSplit(benchmark::State& state)
+{
+  std::string input;
+  for (int i = 0; i < state.range(0); ++i)
+    input += BENCH::MakeString(12, i + 1) + " / ";
+  for (auto _ : state)
+  {
+    auto tokens = StringUtils::Split(input, " / ");
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StringUtilsSplit)->Arg(8)->Arg(512);
+
+static void BM_StringUtilsReplace(benchmark::State& state)
+{
+  const std::string input = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+  {
+    std::string str(input);
+    benchmark::DoNotOptimize(StringUtils::Replace(str, "a", "[a]"));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StringUtilsReplace)->Arg(64)->Arg(4096);
+
+static void BM_StringUtilsCompareNoCase(benchmark::State& state)
+{
+  const std::string str1 = BENCH::MakeString(static_cast<size_t>(state.range(0)));
+  std::string str2(str1);
+  StringUtils::ToUpper(str2);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(StringUtils::CompareNoCase(str1, str2));
+  state.SetBytesProcessed(state.iterations() * str1.size());
+}
+BENCHMARK(BM_StringUtilsCompareNoCase)->Arg(16)->Arg(256);
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#pragma once
+
+#include "utils/Variant.h"
+
+#include <string>
+
+namespace BENCH
+{
+
+/*!
+ * \brief Creates a deterministic pseudo random ASCII string of given length.
+ */
+inline std::string MakeString(size_t length, unsigned int seed = 1)
+{
+  static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+  std::string str;
+  str.reserve(length);
+  for (size_t i = 0; i < length; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    str.push_back(chars[(seed >> 16) % (sizeof(chars) - 1)]);
+  }
+  return str;
+}
+
+/*!
+ * \brief Creates a CVariant resembling a JSON-RPC list item reply with \p items entries.
+ */
+inline CVariant MakeItemList(int items)
+{
+  CVariant list(CVariant::VariantTypeArray);
+  for (int i = 0; i < items; ++i)
+  {
+    CVariant item(CVariant::VariantTypeObject);
+    item["id"] = i;
+    item["label"] = MakeString(24, i + 1);
+    item["file"] = "smb://server/share/movies/" + MakeString(16, i + 7) + ".mkv";
+    item["rating"] = 7.5 + (i % 20) / 10.0;
+    item["playcount"] = i % 3;
+    item["watched"] = (i % 2) == 0;
+    CVariant genres(CVariant::VariantTypeArray);
+    genres.push_back("Drama");
+    genres.push_back("Thriller");
+    item["genre"] = genres;
+    list.push_back(item);
+  }
+  return list;
+}
+
+} // namespace BENCH
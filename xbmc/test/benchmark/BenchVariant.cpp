@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include "BenchUtils.h"
+#include "utils/Variant.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_VariantCopy(benchmark::State& state)
+{
+  const CVariant list = BENCH::MakeItemList(static_cast<int>(state.range(0)));
+  for (auto _ : state)
+  {
+    CVariant copy(list);
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VariantCopy)->Arg(10)->Arg(1000);
+
+static void BM_VariantMove(benchmark::State& state)
+{
+  CVariant list = BENCH::MakeItemList(static_cast<int>(state.range(0)));
+  for (auto _ : state)
+  {
+    CVariant moved(std::move(list));
+    list = std::move(moved);
+    benchmark::DoNotOptimize(list);
+  }
+}
+BENCHMARK(BM_VariantMove)->Arg(1000);
+
+static void BM_VariantObjectLookup(benchmark::State& state)
+{
+  const CVariant list = BENCH::MakeItemList(static_cast<int>(state.range(0)));
+  for (auto _ : state)
+  {
+    int64_t sum = 0;
+    for (auto it = list.begin_array(); it != list.end_array(); ++it)
+      sum += (*it)["id"].asInteger() + (*it)["playcount"].asInteger();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VariantObjectLookup)->Arg(1000);
@@ -0,0 +1,29 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+/*
+ * Entry point of the benchmark runner. Benchmarks register themselves via
+ * BENCHMARK() in the Bench*.cpp files of the benchmark directories.
+ *
+ * Use --benchmark_out=<file> --benchmark_out_format=json to export results,
+ * or build the "bench" target which does that for all benchmarks.
+ */
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
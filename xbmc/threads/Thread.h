@@ -43,6 +43,7 @@ public:
 
   bool IsCurrentThread() const;
   bool Join(unsigned int milliseconds);
+  const std::string& GetName() const { return m_ThreadName; }
 
   inline static const std::thread::id GetCurrentThreadId()
   {
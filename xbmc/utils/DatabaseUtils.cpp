@@ -384,6 +384,28 @@ bool DatabaseUtils::GetFieldValue(const dbiplus::field_value &fieldValue, CVaria
   return false;
 }
 
+bool DatabaseUtils::GetFieldValue(const dbiplus::column_value &fieldValue, CVariant &variantValue)
+{
+  if (fieldValue.get_isNull())
+  {
+    variantValue = CVariant::ConstNullVariant;
+    return true;
+  }
+
+  switch (fieldValue.get_fType())
+  {
+  case dbiplus::ft_Int64:
+    variantValue = fieldValue.get_asInt64();
+    return true;
+  case dbiplus::ft_Double:
+    variantValue = fieldValue.get_asDouble();
+    return true;
+  default:
+    variantValue = fieldValue.get_asString();
+    return true;
+  }
+}
+
 bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldList &fields, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results)
 {
   if (dataset->num_rows() == 0)
@@ -395,7 +417,7 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
   if (fields.empty())
   {
     DatabaseResult result;
-    for (unsigned int index = 0; index < resultSet.records.size(); index++)
+    for (unsigned int index = 0; index < resultSet.size(); index++)
     {
       result[FieldRow] = index + offset;
       results.push_back(result);
@@ -412,8 +434,9 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
   for (FieldList::const_iterator it = fields.begin(); it != fields.end(); ++it)
     fieldIndexLookup.push_back(GetFieldIndex(*it, mediaType));
 
-  results.reserve(resultSet.records.size() + offset);
-  for (unsigned int index = 0; index < resultSet.records.size(); index++)
+  const bool columnar = resultSet.records.empty();
+  results.reserve(resultSet.size() + offset);
+  for (unsigned int index = 0; index < resultSet.size(); index++)
   {
     DatabaseResult result;
     result[FieldRow] = index + offset;
@@ -427,7 +450,9 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
 
       std::pair<Field, CVariant> value;
       value.first = *it;
-      if (!GetFieldValue(resultSet.records[index]->at(fieldIndex), value.second))
+      bool valid = columnar ? GetFieldValue(resultSet.columns.row(index).at(fieldIndex), value.second)
+                            : GetFieldValue(resultSet.records[index]->at(fieldIndex), value.second);
+      if (!valid)
         CLog::Log(LOGWARNING, "GetDatabaseResults: unable to retrieve value of field %s", resultSet.record_header[fieldIndex].name.c_str());
 
       if (value.first == FieldYear &&
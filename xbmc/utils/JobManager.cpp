@@ -9,12 +9,14 @@
 #include "JobManager.h"
 
 #include "threads/SingleLock.h"
+#include "utils/TraceProfiler.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <thread>
 
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
@@ -23,9 +25,16 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+namespace
+{
+// slot of the worker running on the current thread, used to keep jobs added
+// from within a job local to that worker
+thread_local int t_workerSlot = -1;
+}
+
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int slot, bool persistent)
+  : CThread("JobWorker"), m_jobManager(manager), m_slot(slot), m_persistent(persistent)
 {
-  m_jobManager = manager;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -42,6 +51,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  t_workerSlot = static_cast<int>(m_slot);
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -52,6 +62,9 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      // job types are static strings, they name the zone
+      const char* type = job->GetType();
+      CTraceZone zone(*type ? type : "Job");
       success = job->DoWork();
     }
     catch (...)
@@ -166,10 +179,21 @@ CJobManager &CJobManager::GetInstance()
 }
 
 CJobManager::CJobManager()
+  : m_jobCounter(0),
+    m_nextSlot(0),
+    m_processingCount(0),
+    m_idleWorkers(0),
+    m_pauseJobs(false),
+    m_running(true)
 {
-  m_jobCounter = 0;
-  m_running = true;
-  m_pauseJobs = false;
+  // one work queue per persistent worker, scaled with the number of cores but
+  // never less than the five workers we always had
+  const unsigned int slots = std::max(5u, std::thread::hardware_concurrency());
+  for (unsigned int i = 0; i < slots; ++i)
+    m_slots.emplace_back(new CWorkSlot);
+  m_ownedSlots.resize(slots, false);
+  for (auto& queued : m_queued)
+    queued = 0;
 }
 
 void CJobManager::Restart()
@@ -186,15 +210,21 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (auto& slot : m_slots)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
-    m_jobQueue[priority].clear();
-  }
+    CSingleLock slotLock(slot->m_section);
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      for_each(slot->m_jobQueue[priority].begin(), slot->m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
+      m_queued[priority] -= slot->m_jobQueue[priority].size();
+      slot->m_jobQueue[priority].clear();
+    }
+
+    // cancel any callbacks on jobs still processing
+    for_each(slot->m_processing.begin(), slot->m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+  }
 
   // tell our workers to finish
   while (m_workers.size())
@@ -208,19 +238,28 @@ void CJobManager::CancelJobs()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
+
+  // jobs added from within a job stay with that worker, others are spread over all slots
+  const unsigned int slot =
+      t_workerSlot >= 0 ? static_cast<unsigned int>(t_workerSlot) : m_nextSlot++ % m_slots.size();
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+  {
+    CSingleLock lock(m_slots[slot]->m_section);
+    // CancelJobs() may have emptied this slot already
+    if (!m_running)
+      return 0;
+    m_slots[slot]->m_jobQueue[priority].push_back(work);
+    ++m_queued[priority];
+  }
 
   StartWorkers(priority);
   return work.m_id;
@@ -228,91 +267,153 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
-
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  // lock all slots, in slot order like PopJob(), so a job moving from a queue to the processing
+  // jobs of another slot can't slip by
+  std::vector<std::unique_ptr<CSingleLock>> locks;
+  locks.reserve(m_slots.size());
+  for (auto& slot : m_slots)
+    locks.emplace_back(new CSingleLock(slot->m_section));
+
+  for (auto& slot : m_slots)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      JobQueue::iterator i = find(slot->m_jobQueue[priority].begin(), slot->m_jobQueue[priority].end(), jobID);
+      if (i != slot->m_jobQueue[priority].end())
+      {
+        delete i->m_job;
+        slot->m_jobQueue[priority].erase(i);
+        --m_queued[priority];
+        return;
+      }
+    }
+    // or if we're processing it
+    Processing::iterator it = find(slot->m_processing.begin(), slot->m_processing.end(), jobID);
+    if (it != slot->m_processing.end())
+    {
+      it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_processingCount >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (m_idleWorkers > 0)
   {
     m_jobEvent.Set();
     return;
   }
 
   // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  CSingleLock lock(m_section);
+  if (!m_running)
+    return;
+  auto freeSlot = std::find(m_ownedSlots.begin(), m_ownedSlots.end(), false);
+  if (freeSlot != m_ownedSlots.end())
+  {
+    *freeSlot = true;
+    m_workers.push_back(
+        new CJobWorker(this, static_cast<unsigned int>(freeSlot - m_ownedSlots.begin()), true));
+  }
+  else if (priority == CJob::PRIORITY_DEDICATED)
+    m_workers.push_back(new CJobWorker(this, m_nextSlot++ % m_slots.size(), false));
 }
 
-CJob *CJobManager::PopJob()
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  const unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int processing = m_processingCount;
+  while (processing < maxWorkers)
+  {
+    if (m_processingCount.compare_exchange_weak(processing, processing + 1))
+      return true;
+  }
+  return false;
+}
+
+bool CJobManager::PopJob(unsigned int from, unsigned int to, CJob::PRIORITY priority, CWorkItem& work)
+{
+  // always locked in slot order, see CancelJob()
+  CSingleLock first(m_slots[std::min(from, to)]->m_section);
+  CSingleLock second(m_slots[std::max(from, to)]->m_section);
+  JobQueue& queue = m_slots[from]->m_jobQueue[priority];
+  if (queue.empty())
+    return false;
+
+  // stolen jobs too are taken from the front, jobs of a priority start in the order they came in
+  work = queue.front();
+  queue.pop_front();
+  --m_queued[priority];
+
+  // add to the processing vector of the worker's slot
+  m_slots[to]->m_processing.push_back(work);
+  work.m_job->m_callback = this;
+  return true;
+}
+
+CJob *CJobManager::PopJob(const CJobWorker *worker)
+{
+  const unsigned int ownSlot = worker->GetSlot();
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (m_queued[priority] == 0 || !ReserveWorker(CJob::PRIORITY(priority)))
+      continue;
+
+    // try our own queue first, steal from the others otherwise
+    CWorkItem work(nullptr, 0, CJob::PRIORITY(priority), nullptr);
+    for (unsigned int i = 0; i < m_slots.size(); ++i)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      const unsigned int slot = (ownSlot + i) % m_slots.size();
+      if (!PopJob(slot, ownSlot, CJob::PRIORITY(priority), work))
+        continue;
+
+      // more work waiting - pass the wakeup on to the next sleeping worker
+      if (m_idleWorkers > 0 && m_queued[priority] > 0)
+        m_jobEvent.Set();
+
+      return work.m_job;
     }
+    --m_processingCount;
   }
   return NULL;
 }
 
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
+  if (m_queued[CJob::PRIORITY_LOW_PAUSABLE] > 0)
+    StartWorkers(CJob::PRIORITY_LOW_PAUSABLE);
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& slot : m_slots)
   {
-    if (priority == it->m_priority)
-      return true;
+    CSingleLock lock(slot->m_section);
+    for(Processing::const_iterator it = slot->m_processing.begin(); it < slot->m_processing.end(); ++it)
+    {
+      if (priority == it->m_priority)
+        return true;
+    }
   }
   return false;
 }
@@ -320,38 +421,50 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& slot : m_slots)
   {
-    if (type == std::string(it->m_job->GetType()))
-      jobsMatched++;
+    CSingleLock lock(slot->m_section);
+    for(Processing::const_iterator it = slot->m_processing.begin(); it < slot->m_processing.end(); ++it)
+    {
+      if (type == std::string(it->m_job->GetType()))
+        jobsMatched++;
+    }
   }
   return jobsMatched;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
       return job;
-    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+
+    if (!worker->IsPersistent())
       break;
+
+    // no jobs are left - announce that we're idle and check once more so that
+    // a job queued in between can't miss us, then wait for new jobs to come in
+    ++m_idleWorkers;
+    job = PopJob(worker);
+    if (job)
+    {
+      --m_idleWorkers;
+      return job;
+    }
+    // persistent workers keep their slot until the manager stops, CancelJobs() wakes them
+    m_jobEvent.Wait();
+    --m_idleWorkers;
   }
   // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
+  // the last look and before we gave up
+  CJob *job = m_running ? PopJob(worker) : NULL;
   if (job)
     return job;
   // have no jobs
@@ -359,12 +472,30 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   return NULL;
 }
 
+CJobManager::CWorkSlot* CJobManager::FindProcessingSlot(const CJob *job) const
+{
+  // the job is usually processed by the calling worker, so look at its slot first
+  const unsigned int first = t_workerSlot >= 0 ? static_cast<unsigned int>(t_workerSlot) : 0;
+  for (unsigned int i = 0; i < m_slots.size(); ++i)
+  {
+    CWorkSlot* slot = m_slots[(first + i) % m_slots.size()].get();
+    CSingleLock lock(slot->m_section);
+    if (find(slot->m_processing.begin(), slot->m_processing.end(), job) != slot->m_processing.end())
+      return slot;
+  }
+  return nullptr;
+}
+
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
+  CWorkSlot* slot = FindProcessingSlot(job);
+  if (!slot)
+    return true; // couldn't find the job
+
+  CSingleLock lock(slot->m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  Processing::const_iterator i = find(slot->m_processing.begin(), slot->m_processing.end(), job);
+  if (i != slot->m_processing.end())
   {
     CWorkItem item(*i);
     lock.Leave(); // leave section prior to call
@@ -379,10 +510,14 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
+  CWorkSlot* slot = FindProcessingSlot(job);
+  if (!slot)
+    return;
+
+  CSingleLock lock(slot->m_section);
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  Processing::iterator i = find(slot->m_processing.begin(), slot->m_processing.end(), job);
+  if (i != slot->m_processing.end())
   {
     // tell any listeners we're done with the job, then delete it
     CWorkItem item(*i);
@@ -397,9 +532,12 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    Processing::iterator j = find(slot->m_processing.begin(), slot->m_processing.end(), job);
+    if (j != slot->m_processing.end())
+    {
+      slot->m_processing.erase(j);
+      --m_processingCount;
+    }
     lock.Leave();
     item.FreeJob();
   }
@@ -407,14 +545,30 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
+  {
+    CSingleLock lock(m_section);
+    // remove our worker
+    Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
+    if (i == m_workers.end())
+      return;
+
+    if (worker->IsPersistent())
+      m_ownedSlots[worker->GetSlot()] = false;
     m_workers.erase(i); // workers auto-delete
+  }
+
+  // a job queued after our last look found no idle worker to wake
+  for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  {
+    if (m_queued[priority] > 0)
+    {
+      StartWorkers(CJob::PRIORITY(priority));
+      break;
+    }
+  }
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
   static const unsigned int max_workers = 5;
   if (priority == CJob::PRIORITY_DEDICATED)
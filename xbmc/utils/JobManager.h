@@ -12,6 +12,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
@@ -21,12 +23,27 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  explicit CJobWorker(CJobManager *manager);
+  /*!
+   \brief Create and start a worker thread
+   \param manager the job manager this worker takes its jobs from.
+   \param slot index of the work queue this worker owns. Jobs added from within this worker are
+   queued there, and it is searched first when looking for the next job.
+   \param persistent whether the worker owns its slot and waits for new jobs while idle. It only
+   exits when the job manager stops. Non persistent workers are only created for
+   PRIORITY_DEDICATED jobs when all slots are owned, and exit as soon as no job is left.
+   */
+  CJobWorker(CJobManager *manager, unsigned int slot, bool persistent);
   ~CJobWorker() override;
 
   void Process() override;
+
+  unsigned int GetSlot() const { return m_slot; }
+  bool IsPersistent() const { return m_persistent; }
+
 private:
   CJobManager  *m_jobManager;
+  unsigned int m_slot;
+  bool m_persistent;
 };
 
 template<typename F>
@@ -187,6 +204,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Internally jobs are kept in a fixed number of work queue slots (one per persistent
+ worker, scaled with the number of CPU cores), each guarded by its own lock. Jobs added
+ from a worker thread go to that worker's slot, other jobs are distributed round robin.
+ An idle worker takes the highest priority job from its own slot first and steals from
+ the other slots otherwise, so bursts of jobs don't serialise on a single lock.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -319,7 +342,7 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
@@ -347,27 +370,66 @@ private:
   CJobManager(const CJobManager&) = delete;
   CJobManager const& operator=(CJobManager const&) = delete;
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*!
+   \brief Work queue owned by a persistent worker, one per slot.
+   Holds the queued jobs per priority and the jobs being processed by workers bound to the slot.
+   */
+  class CWorkSlot
+  {
+  public:
+    JobQueue m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
+    Processing m_processing;
+    mutable CCriticalSection m_section;
+  };
+
+  /*! \brief Pop a job off the job queues and add to the processing queue ready to process
+   Searches the slot of the given worker first and steals from the other slots otherwise.
+   \param worker the worker requesting a job.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(const CJobWorker *worker);
+
+  /*! \brief Move the oldest job of the given priority from the queue of a slot to the processing
+   jobs of another. Both slots are locked for the move, so the job is always found by CancelJob().
+   \param from the slot to take the job from
+   \param to the slot of the worker that processes the job
+   \param priority the priority of the job
+   \param work [out] the work item taken off the queue
+   \return true if a job was available, false otherwise
+   */
+  bool PopJob(unsigned int from, unsigned int to, CJob::PRIORITY priority, CWorkItem& work);
+
+  /*! \brief Reserve a processing slot for a job of the given priority
+   \return true if the number of jobs being processed allows for another job of the given priority
+   */
+  bool ReserveWorker(CJob::PRIORITY priority);
+
+  /*! \brief Find the slot processing the given job. Checks the slot of the calling worker first.
+   \return the slot processing the job, or nullptr if the job isn't being processed
+   */
+  CWorkSlot* FindProcessingSlot(const CJob *job) const;
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
-  unsigned int m_jobCounter;
+  std::atomic<unsigned int> m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  std::vector<std::unique_ptr<CWorkSlot>> m_slots;
+  std::atomic<unsigned int> m_nextSlot;
+  std::atomic<unsigned int> m_queued[CJob::PRIORITY_DEDICATED + 1];
+  std::atomic<unsigned int> m_processingCount;
+  std::atomic<unsigned int> m_idleWorkers;
+  std::atomic<bool> m_pauseJobs;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
-  Processing m_processing;
   Workers    m_workers;
+  std::vector<bool> m_ownedSlots; //!< slots that have a persistent worker
 
-  mutable CCriticalSection m_section;
+  mutable CCriticalSection m_section; //!< guards the worker list and slot owners only
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
 };
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LatencyHistogram.h"
+
+#include "utils/StringUtils.h"
+
+#include <inttypes.h>
+
+void CLatencyHistogram::Add(uint64_t microseconds)
+{
+  int index = 0;
+  while (index < BUCKETS - 1 && microseconds >= GetBucketLimit(index))
+    index++;
+
+  m_buckets[index]++;
+  m_count++;
+  m_total += microseconds;
+
+  uint64_t max = m_max;
+  while (microseconds > max && !m_max.compare_exchange_weak(max, microseconds))
+    ;
+}
+
+void CLatencyHistogram::Reset()
+{
+  for (auto& bucket : m_buckets)
+    bucket = 0;
+  m_count = 0;
+  m_total = 0;
+  m_max = 0;
+}
+
+uint64_t CLatencyHistogram::GetBucketLimit(int index)
+{
+  return static_cast<uint64_t>(1) << index;
+}
+
+uint64_t CLatencyHistogram::GetPercentile(double percentile) const
+{
+  const uint64_t count = m_count;
+  if (count == 0)
+    return 0;
+
+  // the buckets are added to one by one, their sum may be a bit behind the count
+  const double wanted = count * percentile / 100.0;
+  uint64_t sum = 0;
+  for (int index = 0; index < BUCKETS - 1; index++)
+  {
+    sum += m_buckets[index];
+    if (sum >= wanted && sum > 0)
+      return GetBucketLimit(index);
+  }
+  return m_max;
+}
+
+std::string CLatencyHistogram::ToString(const char* what) const
+{
+  const uint64_t count = m_count;
+  return StringUtils::Format("%" PRIu64 " %s, avg %" PRIu64 "us, p50 %" PRIu64 "us, p99 %" PRIu64
+                             "us, max %" PRIu64 "us",
+                             count, what, count ? m_total / count : 0, GetPercentile(50),
+                             GetPercentile(99), static_cast<uint64_t>(m_max));
+}
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief Counts durations in buckets of powers of two microseconds.
+
+ Bucket 0 holds durations below 1 us, bucket i those from 2^(i-1) up to 2^i us, the last
+ bucket everything longer. Adding a duration takes no lock, so the thread doing the timed
+ work can add to the histogram while others read it.
+ */
+class CLatencyHistogram
+{
+public:
+  static const int BUCKETS = 24; ///< the last one starts at about 4 s
+
+  CLatencyHistogram() = default;
+  CLatencyHistogram(const CLatencyHistogram&) = delete;
+  CLatencyHistogram& operator=(const CLatencyHistogram&) = delete;
+
+  void Add(uint64_t microseconds);
+  void Reset();
+
+  uint64_t GetCount() const { return m_count; }
+  uint64_t GetTotal() const { return m_total; }
+  uint64_t GetMax() const { return m_max; }
+  uint64_t GetBucket(int index) const { return m_buckets[index]; }
+
+  /*!
+   \brief Get the upper limit of a bucket.
+   \return duration in microseconds the durations in the bucket are below.
+   */
+  static uint64_t GetBucketLimit(int index);
+
+  /*!
+   \brief Get the duration the given part of all durations are below, rounded up to a bucket limit.
+   \param percentile between 0 and 100.
+   \return duration in microseconds, 0 if nothing was added.
+   */
+  uint64_t GetPercentile(double percentile) const;
+
+  /*!
+   \brief Summary for the log, e.g. "1234 reads, avg 210us, p50 256us, p99 4096us, max 5310us".
+   */
+  std::string ToString(const char* what) const;
+
+private:
+  std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_total{0};
+  std::atomic<uint64_t> m_max{0};
+};
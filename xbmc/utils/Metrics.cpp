@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "Metrics.h"
+
+#include "XBDateTime.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Timer.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+namespace
+{
+bool HasPrefix(const std::string& name, const std::string& prefix)
+{
+  return prefix.empty() || StringUtils::StartsWith(name, prefix);
+}
+
+CVariant SerializeHistogram(const CLatencyHistogram& histogram)
+{
+  CVariant result(CVariant::VariantTypeObject);
+  result["count"] = histogram.GetCount();
+  result["total"] = histogram.GetTotal();
+  result["max"] = histogram.GetMax();
+  result["p50"] = histogram.GetPercentile(50);
+  result["p90"] = histogram.GetPercentile(90);
+  result["p99"] = histogram.GetPercentile(99);
+
+  result["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (int index = 0; index < CLatencyHistogram::BUCKETS; index++)
+  {
+    const uint64_t count = histogram.GetBucket(index);
+    if (count == 0)
+      continue;
+
+    CVariant bucket(CVariant::VariantTypeObject);
+    // the last bucket has no upper limit
+    if (index < CLatencyHistogram::BUCKETS - 1)
+      bucket["below"] = CLatencyHistogram::GetBucketLimit(index);
+    bucket["count"] = count;
+    result["buckets"].push_back(bucket);
+  }
+  return result;
+}
+} // unnamed namespace
+
+CMetrics& CMetrics::GetInstance()
+{
+  static CMetrics metrics;
+  return metrics;
+}
+
+CMetrics::CMetrics() = default;
+
+CMetrics::~CMetrics()
+{
+  StopDump();
+}
+
+std::atomic<uint64_t>& CMetrics::GetCounter(const std::string& name)
+{
+  CSingleLock lock(m_section);
+  std::unique_ptr<std::atomic<uint64_t>>& counter = m_counters[name];
+  if (!counter)
+    counter.reset(new std::atomic<uint64_t>(0));
+  return *counter;
+}
+
+CLatencyHistogram& CMetrics::GetHistogram(const std::string& name)
+{
+  CSingleLock lock(m_section);
+  std::unique_ptr<CLatencyHistogram>& histogram = m_histograms[name];
+  if (!histogram)
+    histogram.reset(new CLatencyHistogram());
+  return *histogram;
+}
+
+int CMetrics::RegisterGauge(const std::string& name, const std::function<int64_t()>& reader)
+{
+  CSingleLock lock(m_gaugeSection);
+  const int id = m_nextGaugeId++;
+  m_gauges[id] = {name, reader};
+  return id;
+}
+
+void CMetrics::UnregisterGauge(int id)
+{
+  CSingleLock lock(m_gaugeSection);
+  m_gauges.erase(id);
+}
+
+void CMetrics::Serialize(CVariant& result, const std::string& prefix) const
+{
+  result = CVariant(CVariant::VariantTypeObject);
+  result["counters"] = CVariant(CVariant::VariantTypeObject);
+  result["gauges"] = CVariant(CVariant::VariantTypeObject);
+  result["histograms"] = CVariant(CVariant::VariantTypeObject);
+
+  {
+    CSingleLock lock(m_section);
+    for (const auto& counter : m_counters)
+    {
+      if (HasPrefix(counter.first, prefix))
+        result["counters"][counter.first] = static_cast<uint64_t>(*counter.second);
+    }
+    for (const auto& histogram : m_histograms)
+    {
+      if (HasPrefix(histogram.first, prefix))
+        result["histograms"][histogram.first] = SerializeHistogram(*histogram.second);
+    }
+  }
+
+  CSingleLock lock(m_gaugeSection);
+  for (const auto& gauge : m_gauges)
+  {
+    if (HasPrefix(gauge.second.name, prefix))
+      result["gauges"][gauge.second.name] = gauge.second.reader();
+  }
+}
+
+void CMetrics::Reset()
+{
+  CSingleLock lock(m_section);
+  for (auto& counter : m_counters)
+    *counter.second = 0;
+  for (auto& histogram : m_histograms)
+    histogram.second->Reset();
+}
+
+bool CMetrics::Dump(const std::string& file) const
+{
+  CVariant metrics;
+  Serialize(metrics);
+  metrics["time"] = CDateTime::GetUTCDateTime().GetAsW3CDateTime(true);
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(metrics, json, false))
+    return false;
+
+  XFILE::CFile output;
+  if (!output.OpenForWrite(file, true) ||
+      output.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CMetrics::Dump - unable to write %s", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+void CMetrics::StartDump(const std::string& file, unsigned int interval)
+{
+  StopDump();
+  if (file.empty() || interval == 0)
+    return;
+
+  CSingleLock lock(m_dumpSection);
+  m_dumpFile = file;
+  m_dumpTimer.reset(new CTimer([this]() { Dump(m_dumpFile); }));
+  m_dumpTimer->Start(interval * 1000, true);
+  CLog::Log(LOGINFO, "CMetrics::StartDump - writing metrics to %s every %u seconds",
+            file.c_str(), interval);
+}
+
+void CMetrics::StopDump()
+{
+  std::unique_ptr<CTimer> timer;
+  {
+    CSingleLock lock(m_dumpSection);
+    timer = std::move(m_dumpTimer);
+  }
+  if (timer)
+    timer->Stop(true);
+}
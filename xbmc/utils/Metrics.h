@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/LatencyHistogram.h"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+class CTimer;
+class CVariant;
+
+/*!
+ \brief Registry of named counters, gauges and latency histograms.
+
+ Counters and histograms are created on first use and live as long as the registry, so
+ callers look them up once and keep the reference; updating them takes no lock. Gauges
+ are read by a function of their owner whenever the metrics are queried, the owner has
+ to unregister them before it goes away.
+
+ Names are dot separated and start with the component, e.g. "filecache.underruns".
+ */
+class CMetrics
+{
+public:
+  static CMetrics& GetInstance();
+
+  std::atomic<uint64_t>& GetCounter(const std::string& name);
+  CLatencyHistogram& GetHistogram(const std::string& name);
+
+  /*!
+   \brief Register a gauge, a gauge of the same name registered before is hidden until
+   this one is unregistered.
+   \return id to unregister the gauge with.
+   */
+  int RegisterGauge(const std::string& name, const std::function<int64_t()>& reader);
+  void UnregisterGauge(int id);
+
+  /*!
+   \brief Get the metrics whose name starts with prefix.
+   \param result object with "counters", "gauges" and "histograms", each an object keyed
+   by name. A histogram holds its count, total, max, p50, p90, p99 (all durations in
+   microseconds) and its buckets that aren't empty.
+   */
+  void Serialize(CVariant& result, const std::string& prefix = "") const;
+
+  /*!
+   \brief Set all counters and histograms back to zero.
+   */
+  void Reset();
+
+  /*!
+   \brief Write all metrics as JSON to file.
+   */
+  bool Dump(const std::string& file) const;
+
+  /*!
+   \brief Write all metrics to file every interval seconds, until StopDump() is called.
+   */
+  void StartDump(const std::string& file, unsigned int interval);
+  void StopDump();
+
+private:
+  CMetrics();
+  ~CMetrics();
+  CMetrics(const CMetrics&) = delete;
+  CMetrics& operator=(const CMetrics&) = delete;
+
+  struct SGauge
+  {
+    std::string name;
+    std::function<int64_t()> reader;
+  };
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, std::unique_ptr<std::atomic<uint64_t>>> m_counters;
+  std::map<std::string, std::unique_ptr<CLatencyHistogram>> m_histograms;
+
+  // gauges call into their owners, keep them apart from the lookups on hot paths
+  mutable CCriticalSection m_gaugeSection;
+  std::map<int, SGauge> m_gauges;
+  int m_nextGaugeId = 0;
+
+  CCriticalSection m_dumpSection;
+  std::string m_dumpFile;
+  std::unique_ptr<CTimer> m_dumpTimer;
+};
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SPSCRingBuffer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+CSPSCRingBuffer::~CSPSCRingBuffer()
+{
+  Destroy();
+}
+
+bool CSPSCRingBuffer::Create(unsigned int size)
+{
+  Destroy();
+  if (size == 0 || size > UINT_MAX / 2)
+    return false;
+
+  m_buffer = static_cast<char*>(malloc(size));
+  if (m_buffer != nullptr)
+  {
+    m_size = size;
+    return true;
+  }
+  return false;
+}
+
+void CSPSCRingBuffer::Destroy()
+{
+  free(m_buffer);
+  m_buffer = nullptr;
+  m_size = 0;
+  Clear();
+}
+
+void CSPSCRingBuffer::Clear()
+{
+  m_readIndex = 0;
+  m_writeIndex = 0;
+}
+
+unsigned int CSPSCRingBuffer::Distance(unsigned int from, unsigned int to) const
+{
+  return to >= from ? to - from : to + 2 * m_size - from;
+}
+
+unsigned int CSPSCRingBuffer::Advance(unsigned int index, unsigned int size) const
+{
+  index += size;
+  return index >= 2 * m_size ? index - 2 * m_size : index;
+}
+
+const char* CSPSCRingBuffer::PeekRead(unsigned int& size) const
+{
+  const unsigned int read = m_readIndex.load(std::memory_order_relaxed);
+  const unsigned int fill = Distance(read, m_writeIndex.load(std::memory_order_acquire));
+  if (fill == 0)
+  {
+    size = 0;
+    return nullptr;
+  }
+
+  const unsigned int pos = read < m_size ? read : read - m_size;
+  size = std::min(fill, m_size - pos);
+  return m_buffer + pos;
+}
+
+void CSPSCRingBuffer::CommitRead(unsigned int size)
+{
+  const unsigned int read = m_readIndex.load(std::memory_order_relaxed);
+  m_readIndex.store(Advance(read, size), std::memory_order_release);
+}
+
+char* CSPSCRingBuffer::PeekWrite(unsigned int& size)
+{
+  const unsigned int write = m_writeIndex.load(std::memory_order_relaxed);
+  const unsigned int space = m_size - Distance(m_readIndex.load(std::memory_order_acquire), write);
+  if (space == 0)
+  {
+    size = 0;
+    return nullptr;
+  }
+
+  const unsigned int pos = write < m_size ? write : write - m_size;
+  size = std::min(space, m_size - pos);
+  return m_buffer + pos;
+}
+
+void CSPSCRingBuffer::CommitWrite(unsigned int size)
+{
+  const unsigned int write = m_writeIndex.load(std::memory_order_relaxed);
+  m_writeIndex.store(Advance(write, size), std::memory_order_release);
+}
+
+bool CSPSCRingBuffer::ReadData(char *buf, unsigned int size)
+{
+  if (size > getMaxReadSize())
+    return false;
+
+  unsigned int done = 0;
+  while (done < size)
+  {
+    unsigned int chunk;
+    const char* data = PeekRead(chunk);
+    chunk = std::min(chunk, size - done);
+    memcpy(buf + done, data, chunk);
+    CommitRead(chunk);
+    done += chunk;
+  }
+  return true;
+}
+
+bool CSPSCRingBuffer::WriteData(const char *buf, unsigned int size)
+{
+  if (size > getMaxWriteSize())
+    return false;
+
+  unsigned int done = 0;
+  while (done < size)
+  {
+    unsigned int chunk;
+    char* space = PeekWrite(chunk);
+    chunk = std::min(chunk, size - done);
+    memcpy(space, buf + done, chunk);
+    CommitWrite(chunk);
+    done += chunk;
+  }
+  return true;
+}
+
+bool CSPSCRingBuffer::SkipBytes(int skipSize)
+{
+  if (skipSize < 0)
+    return false; // skipping backwards is not supported
+
+  if (static_cast<unsigned int>(skipSize) > getMaxReadSize())
+    return false;
+
+  CommitRead(skipSize);
+  return true;
+}
+
+unsigned int CSPSCRingBuffer::getMaxReadSize() const
+{
+  return Distance(m_readIndex.load(std::memory_order_acquire),
+                  m_writeIndex.load(std::memory_order_acquire));
+}
+
+unsigned int CSPSCRingBuffer::getMaxWriteSize() const
+{
+  return m_size - getMaxReadSize();
+}
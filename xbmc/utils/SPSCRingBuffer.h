@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+
+/*!
+ \brief Ring buffer for exactly one writing and one reading thread.
+
+ Unlike CRingBuffer, reading and writing take no lock: each side only moves its own
+ position and reads the position of the other side. Besides copying data in and out,
+ the contiguous part of the data to read, or of the free space to write to, can be
+ accessed in place and committed afterwards.
+
+ Create(), Destroy() and Clear() must not run concurrently with reading or writing.
+ */
+class CSPSCRingBuffer
+{
+public:
+  CSPSCRingBuffer() = default;
+  ~CSPSCRingBuffer();
+  CSPSCRingBuffer(const CSPSCRingBuffer&) = delete;
+  CSPSCRingBuffer& operator=(const CSPSCRingBuffer&) = delete;
+
+  bool Create(unsigned int size);
+  void Destroy();
+  void Clear();
+
+  bool ReadData(char *buf, unsigned int size);
+  bool WriteData(const char *buf, unsigned int size);
+  bool SkipBytes(int skipSize);
+
+  /*!
+   \brief Get the contiguous part of the data to read.
+   \param size [out] number of bytes at the returned position, 0 if empty.
+   \return the data, valid until it's committed.
+   */
+  const char* PeekRead(unsigned int& size) const;
+  void CommitRead(unsigned int size);
+
+  /*!
+   \brief Get the contiguous part of the free space.
+   \param size [out] number of bytes that can be written at the returned position.
+   \return the space to write to, the data is handed to the reader by CommitWrite().
+   */
+  char* PeekWrite(unsigned int& size);
+  void CommitWrite(unsigned int size);
+
+  unsigned int getSize() const { return m_size; }
+  unsigned int getMaxReadSize() const;
+  unsigned int getMaxWriteSize() const;
+
+private:
+  unsigned int Distance(unsigned int from, unsigned int to) const;
+  unsigned int Advance(unsigned int index, unsigned int size) const;
+
+  char *m_buffer = nullptr;
+  unsigned int m_size = 0;
+
+  // positions of reading and writing, they run up to twice the size so that a full
+  // buffer can be told from an empty one
+  alignas(64) std::atomic<unsigned int> m_readIndex{0};
+  alignas(64) std::atomic<unsigned int> m_writeIndex{0};
+};
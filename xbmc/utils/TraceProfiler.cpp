@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TraceProfiler.h"
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+
+// zones kept per thread, about 24 bytes each
+#define TRACE_EVENTS 8192
+// threads that ended are dropped to make room for new ones beyond this
+#define TRACE_MAX_THREADS 128
+
+namespace
+{
+std::string EscapeJSON(const std::string& value)
+{
+  std::string result;
+  result.reserve(value.size());
+  for (char c : value)
+  {
+    if (c == '"' || c == '\\')
+    {
+      result += '\\';
+      result += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+      result += StringUtils::Format("\\u%04x", c);
+    else
+      result += c;
+  }
+  return result;
+}
+} // unnamed namespace
+
+std::atomic<bool> CTraceProfiler::m_enabled{false};
+
+CTraceProfiler& CTraceProfiler::GetInstance()
+{
+  static CTraceProfiler profiler;
+  return profiler;
+}
+
+CTraceProfiler::CTraceProfiler() : m_base(CurrentHostCounter())
+{
+}
+
+CTraceProfiler::~CTraceProfiler()
+{
+  m_enabled = false;
+}
+
+void CTraceProfiler::SetEnabled(bool enabled)
+{
+  if (m_enabled == enabled)
+    return;
+
+  m_enabled = enabled;
+  CLog::Log(LOGINFO, "CTraceProfiler - tracing %s", enabled ? "enabled" : "disabled");
+}
+
+CTraceProfiler::CThreadBuffer* CTraceProfiler::GetThreadBuffer()
+{
+  static thread_local std::shared_ptr<CThreadBuffer> buffer;
+  if (buffer)
+    return buffer.get();
+
+  buffer = std::make_shared<CThreadBuffer>(TRACE_EVENTS);
+  buffer->threadId = CThread::GetCurrentThreadNativeId();
+  const CThread* thread = CThread::GetCurrentThread();
+  buffer->threadName = thread ? thread->GetName() : "";
+  if (buffer->threadName.empty())
+    buffer->threadName = StringUtils::Format("Thread %" PRIu64, buffer->threadId);
+
+  CSingleLock lock(m_section);
+  if (m_buffers.size() >= TRACE_MAX_THREADS)
+  {
+    // a buffer only held here belongs to a thread that ended
+    const auto ended = std::find_if(
+        m_buffers.begin(), m_buffers.end(),
+        [](const std::shared_ptr<CThreadBuffer>& entry) { return entry.use_count() == 1; });
+    if (ended != m_buffers.end())
+      m_buffers.erase(ended);
+  }
+  m_buffers.push_back(buffer);
+  return buffer.get();
+}
+
+void CTraceProfiler::AddZone(const char* name, int64_t start, int64_t end)
+{
+  CThreadBuffer* buffer = GetThreadBuffer();
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  SEvent& event = buffer->events[head % buffer->size];
+  event.name.store(name, std::memory_order_relaxed);
+  event.start.store(start, std::memory_order_relaxed);
+  event.end.store(end, std::memory_order_relaxed);
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool CTraceProfiler::Dump(const std::string& file, size_t& events) const
+{
+  std::vector<std::shared_ptr<CThreadBuffer>> buffers;
+  {
+    CSingleLock lock(m_section);
+    buffers = m_buffers;
+  }
+
+  const double scale = 1000000.0 / CurrentHostFrequency();
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  events = 0;
+
+  std::vector<std::pair<const char*, std::pair<int64_t, int64_t>>> zones;
+  for (const auto& buffer : buffers)
+  {
+    json += StringUtils::Format(
+        "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu64
+        ",\"args\":{\"name\":\"%s\"}}",
+        first ? "" : ",", buffer->threadId, EscapeJSON(buffer->threadName).c_str());
+    first = false;
+
+    // the thread goes on recording, zones it overwrote while they were copied are left out
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t begin =
+        std::max<uint64_t>(head > buffer->size ? head - buffer->size : 0, buffer->cleared);
+    zones.clear();
+    for (uint64_t index = begin; index < head; index++)
+    {
+      const SEvent& event = buffer->events[index % buffer->size];
+      zones.emplace_back(event.name.load(std::memory_order_relaxed),
+                         std::make_pair(event.start.load(std::memory_order_relaxed),
+                                        event.end.load(std::memory_order_relaxed)));
+    }
+    const uint64_t current = buffer->head.load(std::memory_order_acquire);
+    const uint64_t valid = current >= buffer->size ? current - buffer->size + 1 : 0;
+
+    for (uint64_t index = std::max(begin, valid); index < head; index++)
+    {
+      const auto& zone = zones[index - begin];
+      const int64_t start = zone.second.first;
+      const int64_t end = zone.second.second;
+      if (!zone.first || start < m_base || end < start)
+        continue;
+
+      json += StringUtils::Format(
+          ",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu64 ",\"ts\":%.3f,\"dur\":%.3f}",
+          EscapeJSON(zone.first).c_str(), buffer->threadId, (start - m_base) * scale,
+          (end - start) * scale);
+      events++;
+    }
+  }
+  json += "]}";
+
+  XFILE::CFile output;
+  if (!output.OpenForWrite(file, true) ||
+      output.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CTraceProfiler::Dump - unable to write %s", file.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CTraceProfiler::Dump - %zu zones of %zu threads written to %s", events,
+            buffers.size(), file.c_str());
+  return true;
+}
+
+void CTraceProfiler::Clear()
+{
+  CSingleLock lock(m_section);
+  m_buffers.erase(
+      std::remove_if(
+          m_buffers.begin(), m_buffers.end(),
+          [](const std::shared_ptr<CThreadBuffer>& buffer) { return buffer.use_count() == 1; }),
+      m_buffers.end());
+
+  // the threads that go on keep writing, skip what they recorded so far
+  for (const auto& buffer : m_buffers)
+    buffer->cleared = buffer->head.load(std::memory_order_acquire);
+}
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Timeline of zones, the scopes of code marked with CTraceZone, on all threads.
+
+ Every thread that enters a zone while tracing is enabled gets a ring buffer of its own and
+ keeps its last TRACE_EVENTS zones there, so tracing can stay on and the recent past be
+ dumped when something stalls. Recording a zone takes no lock. When tracing is disabled a
+ zone only checks a flag.
+
+ The dump is in the Chrome trace event format, it can be loaded into chrome://tracing or
+ Perfetto to see how the threads line up. Tracing is enabled with <trace><enabled> in
+ advancedsettings.xml, the ToggleTrace builtin or XBMC.SetTracing; it is dumped with the
+ DumpTrace builtin or XBMC.DumpTrace.
+ */
+class CTraceProfiler
+{
+public:
+  static CTraceProfiler& GetInstance();
+  static bool IsEnabled() { return m_enabled; }
+
+  void SetEnabled(bool enabled);
+
+  /*!
+   \brief Record a zone of the calling thread.
+   \param name name of the zone, has to stay valid for as long as the profiler (a literal).
+   \param start, end host counter at the start and end of the zone.
+   */
+  void AddZone(const char* name, int64_t start, int64_t end);
+
+  /*!
+   \brief Write the recorded zones of all threads as Chrome trace JSON.
+   \param events [out] number of zones written.
+   */
+  bool Dump(const std::string& file, size_t& events) const;
+
+  /*!
+   \brief Drop the recorded zones and the buffers of threads that ended.
+   */
+  void Clear();
+
+private:
+  CTraceProfiler();
+  ~CTraceProfiler();
+  CTraceProfiler(const CTraceProfiler&) = delete;
+  CTraceProfiler& operator=(const CTraceProfiler&) = delete;
+
+  struct SEvent
+  {
+    std::atomic<const char*> name;
+    std::atomic<int64_t> start;
+    std::atomic<int64_t> end;
+  };
+
+  /*!
+   \brief Written by its thread only, read by the dump while the thread goes on.
+   */
+  struct CThreadBuffer
+  {
+    explicit CThreadBuffer(size_t size) : events(new SEvent[size]), size(size) {}
+
+    std::unique_ptr<SEvent[]> events;
+    size_t size;
+    std::atomic<uint64_t> head{0}; ///< number of zones recorded
+    std::atomic<uint64_t> cleared{0}; ///< zones recorded before the last Clear()
+    uint64_t threadId = 0;
+    std::string threadName;
+  };
+
+  CThreadBuffer* GetThreadBuffer();
+
+  static std::atomic<bool> m_enabled;
+
+  mutable CCriticalSection m_section;
+  std::vector<std::shared_ptr<CThreadBuffer>> m_buffers; ///< in the order the threads came
+  int64_t m_base; ///< host counter the times of the dump are relative to
+};
+
+/*!
+ \brief Records the scope it lives in as a zone of the trace, while tracing is enabled.
+
+ \code
+ bool CActiveAE::RunStages()
+ {
+   CTraceZone zone("ActiveAE::RunStages");
+   ...
+ \endcode
+ */
+class CTraceZone
+{
+public:
+  explicit CTraceZone(const char* name) : m_name(name)
+  {
+    if (CTraceProfiler::IsEnabled())
+      m_start = CurrentHostCounter();
+  }
+
+  ~CTraceZone()
+  {
+    if (m_start)
+      CTraceProfiler::GetInstance().AddZone(m_name, m_start, CurrentHostCounter());
+  }
+
+private:
+  CTraceZone(const CTraceZone&) = delete;
+  CTraceZone& operator=(const CTraceZone&) = delete;
+
+  const char* m_name;
+  int64_t m_start = 0;
+};
@@ -213,3 +213,43 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class CountingCallback : public IJobCallback
+{
+public:
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override { ++completed; }
+
+  std::atomic<unsigned int> completed{0};
+};
+}
+
+TEST_F(TestJobManager, ManyJobs)
+{
+  static const unsigned int jobs = 2000;
+  CountingCallback callback;
+  std::atomic<unsigned int> done{0};
+  for (unsigned int i = 0; i < jobs; ++i)
+    CJobManager::GetInstance().Submit([&done]() { ++done; }, &callback,
+                                      i % 2 ? CJob::PRIORITY_LOW : CJob::PRIORITY_NORMAL);
+
+  ASSERT_TRUE(poll([&callback]() -> bool { return callback.completed == jobs; }));
+  EXPECT_EQ(jobs, done);
+}
+
+TEST_F(TestJobManager, NestedJobs)
+{
+  static const unsigned int jobs = 100;
+  std::atomic<unsigned int> done{0};
+  for (unsigned int i = 0; i < jobs; ++i)
+  {
+    // jobs added from within a job are queued on the worker's own slot
+    CJobManager::GetInstance().Submit([&done]() {
+      CJobManager::GetInstance().Submit([&done]() { ++done; });
+      ++done;
+    });
+  }
+
+  ASSERT_TRUE(poll([&done]() -> bool { return done == 2 * jobs; }));
+}
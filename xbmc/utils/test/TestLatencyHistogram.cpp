@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/LatencyHistogram.h"
+
+#include <gtest/gtest.h>
+
+TEST(TestLatencyHistogram, Buckets)
+{
+  CLatencyHistogram histogram;
+  EXPECT_EQ(0u, histogram.GetPercentile(50));
+
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(4);
+  histogram.Add(1000);
+  histogram.Add(UINT64_MAX / 2);
+
+  EXPECT_EQ(1u, histogram.GetBucket(0));
+  EXPECT_EQ(1u, histogram.GetBucket(1));
+  EXPECT_EQ(1u, histogram.GetBucket(2));
+  EXPECT_EQ(1u, histogram.GetBucket(3));
+  EXPECT_EQ(1u, histogram.GetBucket(10));
+  EXPECT_EQ(1u, histogram.GetBucket(CLatencyHistogram::BUCKETS - 1));
+  EXPECT_EQ(6u, histogram.GetCount());
+  EXPECT_EQ(UINT64_MAX / 2, histogram.GetMax());
+
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.GetCount());
+  EXPECT_EQ(0u, histogram.GetMax());
+  EXPECT_EQ(0u, histogram.GetBucket(0));
+}
+
+TEST(TestLatencyHistogram, Percentiles)
+{
+  CLatencyHistogram histogram;
+  for (int i = 0; i < 98; i++)
+    histogram.Add(100);
+  histogram.Add(5000);
+  histogram.Add(20000);
+
+  EXPECT_EQ(128u, histogram.GetPercentile(50));
+  EXPECT_EQ(128u, histogram.GetPercentile(98));
+  EXPECT_EQ(8192u, histogram.GetPercentile(99));
+  EXPECT_EQ(32768u, histogram.GetPercentile(100));
+  EXPECT_EQ(34800u, histogram.GetTotal());
+  EXPECT_EQ("100 reads, avg 348us, p50 128us, p99 8192us, max 20000us", histogram.ToString("reads"));
+}
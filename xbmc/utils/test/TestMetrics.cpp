@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/Metrics.h"
+#include "utils/Variant.h"
+
+#include <gtest/gtest.h>
+
+TEST(TestMetrics, Counters)
+{
+  CMetrics& metrics = CMetrics::GetInstance();
+  std::atomic<uint64_t>& counter = metrics.GetCounter("testmetrics.counter");
+  counter += 3;
+  EXPECT_EQ(&counter, &metrics.GetCounter("testmetrics.counter"));
+
+  metrics.GetHistogram("testmetrics.latency").Add(100);
+  metrics.GetHistogram("testmetrics.latency").Add(3000);
+  metrics.GetCounter("other.counter")++;
+
+  CVariant result;
+  metrics.Serialize(result, "testmetrics.");
+  EXPECT_EQ(3u, result["counters"]["testmetrics.counter"].asUnsignedInteger());
+  EXPECT_FALSE(result["counters"].isMember("other.counter"));
+
+  const CVariant& histogram = result["histograms"]["testmetrics.latency"];
+  EXPECT_EQ(2u, histogram["count"].asUnsignedInteger());
+  EXPECT_EQ(3000u, histogram["max"].asUnsignedInteger());
+  EXPECT_EQ(128u, histogram["p50"].asUnsignedInteger());
+  ASSERT_EQ(2u, histogram["buckets"].size());
+  EXPECT_EQ(4096u, histogram["buckets"][1]["below"].asUnsignedInteger());
+  EXPECT_EQ(1u, histogram["buckets"][1]["count"].asUnsignedInteger());
+
+  metrics.Reset();
+  EXPECT_EQ(0u, counter);
+  EXPECT_EQ(0u, metrics.GetHistogram("testmetrics.latency").GetCount());
+}
+
+TEST(TestMetrics, Gauges)
+{
+  CMetrics& metrics = CMetrics::GetInstance();
+  int64_t level = 42;
+  const int first = metrics.RegisterGauge("testmetrics.level", [&level]() { return level; });
+  const int second = metrics.RegisterGauge("testmetrics.level", []() { return int64_t(7); });
+
+  CVariant result;
+  metrics.Serialize(result, "testmetrics.");
+  EXPECT_EQ(7, result["gauges"]["testmetrics.level"].asInteger());
+
+  metrics.UnregisterGauge(second);
+  level = 50;
+  metrics.Serialize(result, "testmetrics.");
+  EXPECT_EQ(50, result["gauges"]["testmetrics.level"].asInteger());
+
+  metrics.UnregisterGauge(first);
+  metrics.Serialize(result, "testmetrics.");
+  EXPECT_FALSE(result["gauges"].isMember("testmetrics.level"));
+}
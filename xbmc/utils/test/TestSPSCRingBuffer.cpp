@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/SPSCRingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(TestSPSCRingBuffer, General)
+{
+  CSPSCRingBuffer a;
+  char data[20];
+
+  EXPECT_TRUE(a.Create(20));
+  EXPECT_EQ(20u, a.getSize());
+  memset(data, 0, sizeof(data));
+  EXPECT_TRUE(a.WriteData(data, 20));
+  EXPECT_FALSE(a.WriteData(data, 1));
+  EXPECT_EQ(20u, a.getMaxReadSize());
+  a.Clear();
+  EXPECT_EQ(0u, a.getMaxReadSize());
+
+  // wrap around the end of the buffer
+  EXPECT_TRUE(a.WriteData("0123456789abcdef", 16));
+  EXPECT_TRUE(a.SkipBytes(10));
+  EXPECT_TRUE(a.WriteData("ghijklmn", 8));
+  EXPECT_EQ(14u, a.getMaxReadSize());
+  EXPECT_EQ(6u, a.getMaxWriteSize());
+  memset(data, 0, sizeof(data));
+  EXPECT_TRUE(a.ReadData(data, 14));
+  EXPECT_STREQ("abcdefghijklmn", data);
+  EXPECT_FALSE(a.ReadData(data, 1));
+  EXPECT_FALSE(a.SkipBytes(-1));
+}
+
+TEST(TestSPSCRingBuffer, PeekAndCommit)
+{
+  CSPSCRingBuffer a;
+  EXPECT_TRUE(a.Create(8));
+
+  unsigned int size;
+  EXPECT_EQ(nullptr, a.PeekRead(size));
+  EXPECT_EQ(0u, size);
+
+  char* space = a.PeekWrite(size);
+  ASSERT_NE(nullptr, space);
+  EXPECT_EQ(8u, size);
+  memcpy(space, "abcdef", 6);
+  a.CommitWrite(6);
+
+  const char* data = a.PeekRead(size);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(6u, size);
+  EXPECT_EQ(0, memcmp(data, "abcd", 4));
+  a.CommitRead(4);
+
+  // the free space is split by the end of the buffer
+  space = a.PeekWrite(size);
+  EXPECT_EQ(2u, size);
+  memcpy(space, "gh", 2);
+  a.CommitWrite(2);
+  space = a.PeekWrite(size);
+  EXPECT_EQ(4u, size);
+  memcpy(space, "ij", 2);
+  a.CommitWrite(2);
+
+  char out[7] = {};
+  EXPECT_TRUE(a.ReadData(out, 6));
+  EXPECT_STREQ("efghij", out);
+}
+
+TEST(TestSPSCRingBuffer, ProducerConsumer)
+{
+  CSPSCRingBuffer a;
+  EXPECT_TRUE(a.Create(1000));
+
+  const unsigned int total = 4 * 1024 * 1024;
+  std::thread producer([&a, total]() {
+    unsigned int written = 0;
+    char chunk[97];
+    while (written < total)
+    {
+      const unsigned int size = std::min<unsigned int>(sizeof(chunk), total - written);
+      for (unsigned int i = 0; i < size; i++)
+        chunk[i] = static_cast<char>((written + i) % 251);
+      while (!a.WriteData(chunk, size))
+        std::this_thread::yield();
+      written += size;
+    }
+  });
+
+  unsigned int read = 0;
+  bool ok = true;
+  while (read < total)
+  {
+    unsigned int size;
+    const char* data = a.PeekRead(size);
+    if (!data)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    for (unsigned int i = 0; i < size; i++)
+      ok &= data[i] == static_cast<char>((read + i) % 251);
+    a.CommitRead(size);
+    read += size;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(total, read);
+  EXPECT_EQ(0u, a.getMaxReadSize());
+}
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/TraceProfiler.h"
+#include "utils/Variant.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+size_t CountZones(const CVariant& trace, const std::string& name)
+{
+  size_t count = 0;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == "X" && (*it)["name"].asString() == name)
+      count++;
+  }
+  return count;
+}
+
+bool ReadTrace(const std::string& file, CVariant& trace)
+{
+  XFILE::CFile input;
+  XUTILS::auto_buffer buffer;
+  if (input.LoadFile(file, buffer) <= 0)
+    return false;
+  return CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()), trace);
+}
+} // unnamed namespace
+
+TEST(TestTraceProfiler, Zones)
+{
+  CTraceProfiler& profiler = CTraceProfiler::GetInstance();
+  profiler.Clear();
+
+  {
+    CTraceZone zone("TestTraceProfiler::Disabled");
+  }
+
+  profiler.SetEnabled(true);
+  {
+    CTraceZone outer("TestTraceProfiler::Outer");
+    CTraceZone inner("TestTraceProfiler::Inner");
+  }
+  std::thread worker([]() {
+    for (int i = 0; i < 3; i++)
+      CTraceZone zone("TestTraceProfiler::Worker");
+  });
+  worker.join();
+  profiler.SetEnabled(false);
+
+  XFILE::CFile* file = XBMC_CREATETEMPFILE("trace.json");
+  const std::string path = XBMC_TEMPFILEPATH(file);
+  size_t events = 0;
+  ASSERT_TRUE(profiler.Dump(path, events));
+
+  CVariant trace;
+  ASSERT_TRUE(ReadTrace(path, trace));
+  XBMC_DELETETEMPFILE(file);
+
+  EXPECT_LE(5u, events);
+  EXPECT_EQ(0u, CountZones(trace, "TestTraceProfiler::Disabled"));
+  EXPECT_EQ(1u, CountZones(trace, "TestTraceProfiler::Outer"));
+  EXPECT_EQ(1u, CountZones(trace, "TestTraceProfiler::Inner"));
+  EXPECT_EQ(3u, CountZones(trace, "TestTraceProfiler::Worker"));
+
+  // the zones after a clear only
+  profiler.Clear();
+  profiler.SetEnabled(true);
+  {
+    CTraceZone zone("TestTraceProfiler::Outer");
+  }
+  profiler.SetEnabled(false);
+
+  file = XBMC_CREATETEMPFILE("trace.json");
+  const std::string cleared = XBMC_TEMPFILEPATH(file);
+  ASSERT_TRUE(profiler.Dump(cleared, events));
+  ASSERT_TRUE(ReadTrace(cleared, trace));
+  XBMC_DELETETEMPFILE(file);
+
+  EXPECT_LE(1u, events);
+  EXPECT_EQ(1u, CountZones(trace, "TestTraceProfiler::Outer"));
+  EXPECT_EQ(0u, CountZones(trace, "TestTraceProfiler::Worker"));
+}
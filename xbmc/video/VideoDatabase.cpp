@@ -705,11 +705,11 @@ bool CVideoDatabase::GetPathsForTvShow(int idShow, std::set<int>& paths)
   return false;
 }
 
-int CVideoDatabase::RunQuery(const std::string &sql)
+int CVideoDatabase::RunQuery(const std::string &sql, bool columnar /* = false */)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
   int rows = -1;
-  if (m_pDS->query(sql))
+  if (m_pDS->query_bound(sql, columnar ? rsColumns : rsRows))
   {
     rows = m_pDS->num_rows();
     if (rows == 0)
@@ -3787,7 +3787,8 @@ void CVideoDatabase::GetDetailsFromDB(std::unique_ptr<Dataset> &pDS, int min, in
   GetDetailsFromDB(pDS->get_sql_record(), min, max, offsets, details, idxOffset);
 }
 
-void CVideoDatabase::GetDetailsFromDB(const dbiplus::sql_record* const record, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset)
+template<typename Record>
+void CVideoDatabase::GetDetailsFromDB(const Record* const record, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset)
 {
   for (int i = min + 1; i < max; i++)
   {
@@ -4001,7 +4002,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(std::unique_ptr<Dataset> &pDS,
   return GetDetailsForMovie(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
+template<typename Record>
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const Record* const record, int getDetails /* = VideoDbDetailsNone */)
 {
   CVideoInfoTag details;
 
@@ -4060,11 +4062,10 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
       // create tvshowlink string
       std::vector<int> links;
       GetLinksToTvShow(idMovie, links);
+      const std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=?", VIDEODB_ID_TV_TITLE);
       for (unsigned int i = 0; i < links.size(); ++i)
       {
-        std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
-          VIDEODB_ID_TV_TITLE, links[i]);
-        m_pDS2->query(strSQL);
+        m_pDS2->query(strSQL, {field_value(links[i])});
         if (!m_pDS2->eof())
           details.m_showLink.emplace_back(m_pDS2->fv(0).get_asString());
       }
@@ -4084,7 +4085,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(std::unique_ptr<Dataset> &pDS,
   return GetDetailsForTvShow(pDS->get_sql_record(), getDetails, item);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */, CFileItem* item /* = NULL */)
+template<typename Record>
+CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(const Record* const record, int getDetails /* = VideoDbDetailsNone */, CFileItem* item /* = NULL */)
 {
   CVideoInfoTag details;
 
@@ -4155,7 +4157,8 @@ CVideoInfoTag CVideoDatabase::GetBasicDetailsForEpisode(std::unique_ptr<Dataset>
   return GetBasicDetailsForEpisode(pDS->get_sql_record());
 }
 
-CVideoInfoTag CVideoDatabase::GetBasicDetailsForEpisode(const dbiplus::sql_record* const record)
+template<typename Record>
+CVideoInfoTag CVideoDatabase::GetBasicDetailsForEpisode(const Record* const record)
 {
   CVideoInfoTag details;
 
@@ -4182,7 +4185,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(std::unique_ptr<Dataset> &pDS
   return GetDetailsForEpisode(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
+template<typename Record>
+CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(const Record* const record, int getDetails /* = VideoDbDetailsNone */)
 {
   CVideoInfoTag details;
 
@@ -4246,7 +4250,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(std::unique_ptr<Dataset> &
   return GetDetailsForMusicVideo(pDS->get_sql_record(), getDetails);
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(const dbiplus::sql_record* const record, int getDetails /* = VideoDbDetailsNone */)
+template<typename Record>
+CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(const Record* const record, int getDetails /* = VideoDbDetailsNone */)
 {
   CVideoInfoTag details;
   CArtist artist;
@@ -4308,19 +4313,19 @@ void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::v
     if (!m_pDS2)
       return;
 
-    std::string sql = PrepareSQL("SELECT actor.name,"
-                                 "  actor_link.role,"
-                                 "  actor_link.cast_order,"
-                                 "  actor.art_urls,"
-                                 "  art.url "
-                                 "FROM actor_link"
-                                 "  JOIN actor ON"
-                                 "    actor_link.actor_id=actor.actor_id"
-                                 "  LEFT JOIN art ON"
-                                 "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
-                                 "WHERE actor_link.media_id=%i AND actor_link.media_type='%s'"
-                                 "ORDER BY actor_link.cast_order", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query("SELECT actor.name,"
+                  "  actor_link.role,"
+                  "  actor_link.cast_order,"
+                  "  actor.art_urls,"
+                  "  art.url "
+                  "FROM actor_link"
+                  "  JOIN actor ON"
+                  "    actor_link.actor_id=actor.actor_id"
+                  "  LEFT JOIN art ON"
+                  "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                  "WHERE actor_link.media_id=? AND actor_link.media_type=? "
+                  "ORDER BY actor_link.cast_order",
+                  {field_value(media_id), field_value(media_type)});
     while (!m_pDS2->eof())
     {
       SActorInfo info;
@@ -4357,8 +4362,8 @@ void CVideoDatabase::GetTags(int media_id, const std::string &media_type, std::v
     if (!m_pDS2)
       return;
 
-    std::string sql = PrepareSQL("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = %i AND tag_link.media_type = '%s' ORDER BY tag.tag_id", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = ? AND tag_link.media_type = ? ORDER BY tag.tag_id",
+                  {field_value(media_id), field_value(media_type)});
     while (!m_pDS2->eof())
     {
       tags.emplace_back(m_pDS2->fv(0).get_asString());
@@ -4381,8 +4386,8 @@ void CVideoDatabase::GetRatings(int media_id, const std::string &media_type, Rat
     if (!m_pDS2)
       return;
 
-    std::string sql = PrepareSQL("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = %i AND rating.media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = ? AND rating.media_type = ?",
+                  {field_value(media_id), field_value(media_type)});
     while (!m_pDS2->eof())
     {
       ratings[m_pDS2->fv(0).get_asString()] = CRating(m_pDS2->fv(1).get_asFloat(), m_pDS2->fv(2).get_asInt());
@@ -4405,8 +4410,8 @@ void CVideoDatabase::GetUniqueIDs(int media_id, const std::string &media_type, C
     if (!m_pDS2)
       return;
 
-    std::string sql = PrepareSQL("SELECT type, value FROM uniqueid WHERE media_id = %i AND media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query("SELECT type, value FROM uniqueid WHERE media_id = ? AND media_type = ?",
+                  {field_value(media_id), field_value(media_type)});
     while (!m_pDS2->eof())
     {
       details.SetUniqueID(m_pDS2->fv(1).get_asString(), m_pDS2->fv(0).get_asString());
@@ -7480,7 +7485,7 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, true);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
@@ -7497,11 +7502,12 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     // get data from returned rows
     items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
+    const column_data &data = m_pDS->get_result_set().columns;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const column_record row = data.row(targetRow);
+      const column_record* const record = &row;
 
       CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -7591,7 +7597,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, true);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
@@ -7607,11 +7613,12 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     // get data from returned rows
     items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
+    const column_data &data = m_pDS->get_result_set().columns;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const column_record row = data.row(targetRow);
+      const column_record* const record = &row;
 
       CFileItemPtr pItem(new CFileItem());
       CVideoInfoTag movie = GetDetailsForTvShow(record, getDetails, pItem.get());
@@ -7719,7 +7726,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, true);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
@@ -7737,11 +7744,12 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
 
-    const query_data &data = m_pDS->get_result_set().records;
+    const column_data &data = m_pDS->get_result_set().columns;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const column_record row = data.row(targetRow);
+      const column_record* const record = &row;
 
       CVideoInfoTag episode = GetDetailsForEpisode(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -8630,7 +8638,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, true);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
 
@@ -8647,11 +8655,12 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     // get data from returned rows
     items.Reserve(results.size());
     // get songs from returned subtable
-    const query_data &data = m_pDS->get_result_set().records;
+    const column_data &data = m_pDS->get_result_set().columns;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const column_record row = data.row(targetRow);
+      const column_record* const record = &row;
 
       CVideoInfoTag musicvideo = GetDetailsForMusicVideo(record, getDetails);
       if (!checkLocks || m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE || g_passwordManager.bMasterUser ||
@@ -10568,6 +10577,10 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 
 bool CVideoDatabase::CommitTransaction()
 {
+  // the counts are refreshed once the batch is committed
+  if (InBatch())
+    return CDatabase::CommitTransaction();
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
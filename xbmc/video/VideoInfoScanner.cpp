@@ -36,9 +36,11 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -48,6 +50,7 @@
 #include "video/VideoThumbLoader.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 using namespace XFILE;
@@ -59,6 +62,8 @@ using KODI::UTILITY::CDigest;
 
 namespace VIDEO
 {
+  // folders that may be prefetched ahead of the scan
+  #define MAX_PREFETCHED_DIRS 64
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
@@ -67,11 +72,14 @@ namespace VIDEO
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
-  = default;
+  {
+    CancelPrefetch();
+  }
 
   void CVideoInfoScanner::Process()
   {
     m_bStop = false;
+    m_stopEvent.Reset();
 
     try
     {
@@ -136,10 +144,26 @@ namespace VIDEO
            */
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
+          EvictPrefetched(directory);
+        }
+        else
+        {
+          // keep the workers busy with the folders to come while this one is scanned
+          auto path = m_pathsToScan.begin();
+          for (int i = 0; i < MAX_PREFETCHED_DIRS && path != m_pathsToScan.end(); ++i, ++path)
+          {
+            if (m_prefetched.size() >= MAX_PREFETCHED_DIRS)
+              break;
+            if (*path != directory)
+              PrefetchDirectory(*path);
+          }
+
+          if (!DoScan(directory))
+            bCancelled = true;
+          EvictPrefetched(directory);
         }
-        else if (!DoScan(directory))
-          bCancelled = true;
       }
+      CancelPrefetch();
 
       if (!bCancelled)
       {
@@ -163,6 +187,7 @@ namespace VIDEO
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      CancelPrefetch();
     }
 
     m_bRunning = false;
@@ -217,6 +242,7 @@ namespace VIDEO
       m_database.Interrupt();
 
     m_bStop = true;
+    m_stopEvent.Set();
   }
 
   static void OnDirectoryScanned(const std::string& strDirectory)
@@ -242,6 +268,8 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    std::shared_ptr<SPrefetchedDirectory> prefetched = TakePrefetchedDirectory(strDirectory);
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
@@ -250,6 +278,8 @@ namespace VIDEO
     SScanSettings settings;
     ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
     CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+    if (prefetched && prefetched->content != content)
+      prefetched.reset();
 
     // exclude folders that match our exclude regexps
     const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_tvshowExcludeFromScanRegExps
@@ -258,7 +288,7 @@ namespace VIDEO
     if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
       return true;
 
-    if (HasNoMedia(strDirectory))
+    if (prefetched ? prefetched->noMedia : HasNoMedia(strDirectory))
       return true;
 
     bool ignoreFolder = !m_scanAll && settings.noupdate;
@@ -284,13 +314,20 @@ namespace VIDEO
       }
 
       std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
+      if (prefetched)
+        fastHash = prefetched->fastHash;
+      else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
         fastHash = GetFastHash(strDirectory, regexps);
 
       if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
+      else if (prefetched && prefetched->listed)
+      { // the folder was fetched ahead of time
+        items.Assign(prefetched->items);
+        hash = prefetched->hash;
+      }
       else
       { // need to fetch the folder
         CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
@@ -379,6 +416,18 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // subfolders are scanned in order, but their I/O can already start
+    if (settings.recurse > 0 && content != CONTENT_TVSHOWS)
+    {
+      for (const auto& pItem : items)
+      {
+        if (m_prefetched.size() >= MAX_PREFETCHED_DIRS)
+          break;
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+          PrefetchDirectory(pItem->GetPath());
+      }
+    }
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -396,9 +445,161 @@ namespace VIDEO
         }
       }
     }
+    EvictPrefetched(strDirectory);
     return !m_bStop;
   }
 
+  void CVideoInfoScanner::PrefetchDirectory(const std::string& strDirectory)
+  {
+    // each folder is only considered once per scan
+    if (!m_prefetchChecked.insert(strDirectory).second)
+      return;
+
+    CJobQueue* queue = GetPrefetchQueue(strDirectory);
+    if (!queue)
+      return;
+
+    // only movie and music video folders are listed up front, tvshows are enumerated recursively
+    SScanSettings settings;
+    bool foundDirectly = false;
+    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
+    CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+    if (content != CONTENT_MOVIES && content != CONTENT_MUSICVIDEOS)
+      return;
+    if ((!m_scanAll && settings.noupdate) || URIUtils::IsPlugin(strDirectory))
+      return;
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    if (CUtil::ExcludeFileOrFolder(strDirectory, advancedSettings->m_moviesExcludeFromScanRegExps))
+      return;
+
+    std::shared_ptr<SPrefetchedDirectory> directory = std::make_shared<SPrefetchedDirectory>(strDirectory);
+    directory->content = content;
+    directory->excludes = advancedSettings->m_moviesExcludeFromScanRegExps;
+    m_database.GetPathHash(strDirectory, directory->dbHash);
+    m_prefetched.insert(std::make_pair(strDirectory, directory));
+
+    queue->Submit([directory]()
+    {
+      int expected = SPrefetchedDirectory::QUEUED;
+      if (!directory->state.compare_exchange_strong(expected, SPrefetchedDirectory::RUNNING))
+        return; // the scanner got there first
+
+      FetchDirectory(*directory);
+      directory->done.Set();
+    });
+  }
+
+  std::shared_ptr<CVideoInfoScanner::SPrefetchedDirectory> CVideoInfoScanner::TakePrefetchedDirectory(const std::string& strDirectory)
+  {
+    auto it = m_prefetched.find(strDirectory);
+    if (it == m_prefetched.end())
+      return nullptr;
+
+    std::shared_ptr<SPrefetchedDirectory> directory = it->second;
+    m_prefetched.erase(it);
+
+    // rather than waiting behind other queued folders, fetch it ourselves
+    int expected = SPrefetchedDirectory::QUEUED;
+    if (directory->state.compare_exchange_strong(expected, SPrefetchedDirectory::TAKEN))
+      return nullptr;
+
+    XbmcThreads::CEventGroup events{&directory->done, &m_stopEvent};
+    if (events.wait() != &directory->done)
+      return nullptr;
+    return directory;
+  }
+
+  void CVideoInfoScanner::EvictPrefetched(const std::string& strDirectory)
+  {
+    auto evict = [this](std::map<std::string, std::shared_ptr<SPrefetchedDirectory>>::iterator it)
+    {
+      // a worker that didn't start yet skips it
+      int expected = SPrefetchedDirectory::QUEUED;
+      it->second->state.compare_exchange_strong(expected, SPrefetchedDirectory::TAKEN);
+      m_prefetchChecked.erase(it->first);
+      return m_prefetched.erase(it);
+    };
+
+    auto it = m_prefetched.find(strDirectory);
+    if (it != m_prefetched.end())
+      evict(it);
+
+    // the folders below it follow it in the map
+    std::string prefix = strDirectory;
+    URIUtils::AddSlashAtEnd(prefix);
+    it = m_prefetched.lower_bound(prefix);
+    while (it != m_prefetched.end() && StringUtils::StartsWith(it->first, prefix))
+      it = evict(it);
+  }
+
+  void CVideoInfoScanner::FetchDirectory(SPrefetchedDirectory& directory)
+  {
+    // mirrors the movie and music video part of DoScan(), minus the database
+    directory.noMedia = HasNoMedia(directory.path);
+    if (directory.noMedia)
+      return;
+
+    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash)
+      directory.fastHash = GetFastHash(directory.path, directory.excludes);
+
+    if (!directory.fastHash.empty() && StringUtils::EqualsNoCase(directory.fastHash, directory.dbHash))
+      return;
+
+    CDirectory::GetDirectory(directory.path, directory.items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                             DIR_FLAG_DEFAULTS);
+    directory.items.Stack();
+
+    if (!CanFastHash(directory.items, directory.excludes) || directory.fastHash.empty())
+      GetPathHash(directory.items, directory.hash);
+    else
+      directory.hash = directory.fastHash;
+    directory.listed = true;
+  }
+
+  CJobQueue* CVideoInfoScanner::GetPrefetchQueue(const std::string& strDirectory)
+  {
+    // bound the concurrent requests per server rather than per scan
+    const CURL url(strDirectory);
+    const std::string source = url.GetProtocol() + "://" + url.GetHostName();
+
+    auto it = m_prefetchQueues.find(source);
+    if (it != m_prefetchQueues.end())
+      return it->second.get();
+
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    unsigned int concurrency = advancedSettings->m_videoLibraryScanConcurrency;
+    const auto& protocols = advancedSettings->m_videoLibraryScanConcurrencyProtocols;
+    auto protocol = protocols.find(url.GetTranslatedProtocol());
+    if (protocol != protocols.end())
+      concurrency = protocol->second;
+
+    std::unique_ptr<CJobQueue> queue;
+    if (concurrency <= 1)
+    {
+      m_prefetchQueues.insert(std::make_pair(source, std::move(queue)));
+      return nullptr;
+    }
+
+    // the workers mostly wait on the network, so don't tie up the shared job workers
+    CLog::Log(LOGDEBUG, "VideoInfoScanner: Prefetching up to %u folders at once from %s", concurrency, CURL::GetRedacted(source).c_str());
+    queue.reset(new CJobQueue(false, concurrency, CJob::PRIORITY_DEDICATED));
+    return m_prefetchQueues.insert(std::make_pair(source, std::move(queue))).first->second.get();
+  }
+
+  void CVideoInfoScanner::CancelPrefetch()
+  {
+    // workers only share their folder with the scanner, those that already started finish on
+    // their own instead of holding up a stopped scan
+    for (auto& prefetched : m_prefetched)
+    {
+      int expected = SPrefetchedDirectory::QUEUED;
+      prefetched.second->state.compare_exchange_strong(expected, SPrefetchedDirectory::TAKEN);
+    }
+    m_prefetched.clear();
+    m_prefetchChecked.clear();
+    m_prefetchQueues.clear();
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -1934,7 +2135,7 @@ namespace VIDEO
     return count;
   }
 
-  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const
+  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes)
   {
     if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash || items.IsPlugin())
       return false;
@@ -1948,7 +2149,7 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
@@ -8,17 +8,21 @@
 
 #pragma once
 
+#include "FileItem.h"
 #include "InfoScanner.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
+#include "threads/Event.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+class CJobQueue;
 class CRegExp;
-class CFileItem;
-class CFileItemList;
 
 namespace VIDEO
 {
@@ -188,7 +192,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -210,7 +214,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return true if this directory listing can be fast hashed, false otherwise
      */
-    bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
+    static bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes);
 
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
@@ -228,12 +232,69 @@ namespace VIDEO
     bool EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
 
+    struct SPrefetchedDirectory
+    {
+      enum State
+      {
+        QUEUED,
+        RUNNING,
+        TAKEN
+      };
+
+      explicit SPrefetchedDirectory(const std::string& strPath) : path(strPath) {}
+
+      std::string path;
+      CONTENT_TYPE content = CONTENT_NONE;
+      std::vector<std::string> excludes;
+      std::string dbHash;
+
+      std::atomic<int> state{QUEUED};
+      CEvent done{true};
+
+      // results, valid once done is set
+      bool noMedia = false;
+      bool listed = false;
+      std::string fastHash;
+      std::string hash;
+      CFileItemList items;
+    };
+
+    /*! \brief Queue the I/O needed to scan a movie or music video folder.
+     The folder is checked for .nomedia, hashed and, if its hash changed, listed by a pool of
+     workers bounded per source, while the scanner keeps processing earlier folders. Database
+     access stays on the scanner thread.
+     \param strDirectory folder that will be passed to DoScan() later on.
+     */
+    void PrefetchDirectory(const std::string& strDirectory);
+
+    /*! \brief Get the result of PrefetchDirectory() for a folder.
+     Waits for a worker that is busy with the folder, unless the scan is stopped. Folders no
+     worker started on yet are left to the caller.
+     \return the prefetched folder, or nullptr if the caller has to do the work itself.
+     */
+    std::shared_ptr<SPrefetchedDirectory> TakePrefetchedDirectory(const std::string& strDirectory);
+
+    /*! \brief Drop the prefetched folders at or below a folder the scan is done with.
+     Folders the scan passed without taking them would otherwise hold their slot until the scan
+     ends. They may be prefetched again should the scan come back to them.
+     \param strDirectory folder DoScan() is done with.
+     */
+    void EvictPrefetched(const std::string& strDirectory);
+
+    static void FetchDirectory(SPrefetchedDirectory& directory);
+    CJobQueue* GetPrefetchQueue(const std::string& strDirectory);
+    void CancelPrefetch();
+
     bool m_bStop;
+    CEvent m_stopEvent{true}; //!< set along with m_bStop by Stop()
     bool m_scanAll;
     std::string m_strStartDir;
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::map<std::string, std::shared_ptr<SPrefetchedDirectory>> m_prefetched;
+    std::set<std::string> m_prefetchChecked;
+    std::map<std::string, std::unique_ptr<CJobQueue>> m_prefetchQueues; //!< per source (protocol and host), null if sequential
 
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
@@ -9,7 +9,7 @@
 #include "VideoLibraryRefreshingJob.h"
 
 #include "ServiceBroker.h"
-#include "TextureDatabase.h"
+#include "TextureCache.h"
 #include "addons/Scraper.h"
 #include "dialogs/GUIDialogSelect.h"
 #include "dialogs/GUIDialogYesNo.h"
@@ -250,14 +250,10 @@ bool CVideoLibraryRefreshingJob::Work(CVideoDatabase &db)
     }
 
     // before we start downloading all the necessary information cleanup any existing artwork and hashes
-    CTextureDatabase textureDb;
-    if (textureDb.Open())
-    {
-      for (const auto& artwork : m_item->GetArt())
-        textureDb.InvalidateCachedTexture(artwork.second);
-
-      textureDb.Close();
-    }
+    std::vector<std::string> artwork;
+    for (const auto& art : m_item->GetArt())
+      artwork.push_back(art.second);
+    CTextureCache::GetInstance().InvalidateCachedImages(artwork);
     m_item->ClearArt();
 
     // put together the list of items to refresh
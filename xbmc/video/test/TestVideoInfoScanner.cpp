@@ -9,6 +9,10 @@
 #include "FileItem.h"
 #include "video/VideoInfoScanner.h"
 
+#include <chrono>
+#include <memory>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 using namespace VIDEO;
@@ -62,3 +66,103 @@ TEST_P(TestVideoInfoScanner, EnumerateEpisodeItem)
 }
 
 INSTANTIATE_TEST_SUITE_P(VideoInfoScanner, TestVideoInfoScanner, ValuesIn(TestData));
+
+namespace
+{
+class CPrefetchingScanner : public CVideoInfoScanner
+{
+public:
+  using CVideoInfoScanner::SPrefetchedDirectory;
+  using CVideoInfoScanner::EvictPrefetched;
+  using CVideoInfoScanner::TakePrefetchedDirectory;
+  using CVideoInfoScanner::CancelPrefetch;
+
+  std::shared_ptr<SPrefetchedDirectory> Add(const std::string& path, int state)
+  {
+    auto directory = std::make_shared<SPrefetchedDirectory>(path);
+    directory->state = state;
+    m_prefetched.insert(std::make_pair(path, directory));
+    m_prefetchChecked.insert(path);
+    return directory;
+  }
+
+  bool IsPrefetched(const std::string& path) const { return m_prefetched.find(path) != m_prefetched.end(); }
+  bool IsChecked(const std::string& path) const { return m_prefetchChecked.find(path) != m_prefetchChecked.end(); }
+};
+
+typedef CPrefetchingScanner::SPrefetchedDirectory SPrefetched;
+}
+
+TEST(TestVideoInfoScannerPrefetch, TakeQueued)
+{
+  CPrefetchingScanner scanner;
+  auto directory = scanner.Add("/movies/a/", SPrefetched::QUEUED);
+
+  // nobody started on it, the scanner does the work itself
+  EXPECT_EQ(nullptr, scanner.TakePrefetchedDirectory("/movies/a/"));
+  EXPECT_EQ(SPrefetched::TAKEN, directory->state);
+  EXPECT_FALSE(scanner.IsPrefetched("/movies/a/"));
+  EXPECT_EQ(nullptr, scanner.TakePrefetchedDirectory("/movies/b/"));
+}
+
+TEST(TestVideoInfoScannerPrefetch, TakeWaitsForWorker)
+{
+  CPrefetchingScanner scanner;
+  auto directory = scanner.Add("/movies/a/", SPrefetched::RUNNING);
+
+  std::thread worker([directory]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    directory->listed = true;
+    directory->done.Set();
+  });
+  auto taken = scanner.TakePrefetchedDirectory("/movies/a/");
+  worker.join();
+  ASSERT_EQ(directory, taken);
+  EXPECT_TRUE(taken->listed);
+}
+
+TEST(TestVideoInfoScannerPrefetch, TakeStops)
+{
+  CPrefetchingScanner scanner;
+  auto directory = scanner.Add("/movies/a/", SPrefetched::RUNNING);
+
+  // a worker stuck on the network doesn't hold up a stopped scan
+  std::thread stop([&scanner]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scanner.Stop();
+  });
+  EXPECT_EQ(nullptr, scanner.TakePrefetchedDirectory("/movies/a/"));
+  stop.join();
+
+  scanner.Add("/movies/b/", SPrefetched::RUNNING);
+  scanner.CancelPrefetch();
+  EXPECT_FALSE(scanner.IsPrefetched("/movies/b/"));
+}
+
+TEST(TestVideoInfoScannerPrefetch, Evict)
+{
+  CPrefetchingScanner scanner;
+  auto a = scanner.Add("/movies/a/", SPrefetched::QUEUED);
+  auto b = scanner.Add("/movies/a/b/", SPrefetched::QUEUED);
+  auto c = scanner.Add("/movies/a/b/c/", SPrefetched::RUNNING);
+  scanner.Add("/movies/a-b/", SPrefetched::QUEUED);
+  scanner.Add("/movies/ab/", SPrefetched::QUEUED);
+  scanner.Add("/movies/", SPrefetched::QUEUED);
+
+  scanner.EvictPrefetched("/movies/a/");
+  EXPECT_FALSE(scanner.IsPrefetched("/movies/a/"));
+  EXPECT_FALSE(scanner.IsPrefetched("/movies/a/b/"));
+  EXPECT_FALSE(scanner.IsPrefetched("/movies/a/b/c/"));
+  EXPECT_TRUE(scanner.IsPrefetched("/movies/a-b/"));
+  EXPECT_TRUE(scanner.IsPrefetched("/movies/ab/"));
+  EXPECT_TRUE(scanner.IsPrefetched("/movies/"));
+
+  // queued workers skip the evicted folders, which may be prefetched again
+  EXPECT_EQ(SPrefetched::TAKEN, a->state);
+  EXPECT_EQ(SPrefetched::TAKEN, b->state);
+  EXPECT_EQ(SPrefetched::RUNNING, c->state);
+  EXPECT_FALSE(scanner.IsChecked("/movies/a/b/"));
+  EXPECT_TRUE(scanner.IsChecked("/movies/ab/"));
+}
@@ -23,6 +23,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
+#include "utils/TraceProfiler.h"
 #include "utils/log.h"
 
 #include <cassert>
@@ -983,6 +984,8 @@ const std::string& CGraphicContext::GetMediaDir() const
 
 void CGraphicContext::Flip(bool rendered, bool videoLayer)
 {
+  CTraceZone zone("GraphicContext::Flip");
+
   CServiceBroker::GetRenderSystem()->PresentRender(rendered, videoLayer);
 
   if(m_stereoMode != m_nextStereoMode)